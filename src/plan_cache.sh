@@ -0,0 +1,117 @@
+# Cache of preprocessed tasks, shared by the plan drivers (source this file).
+#
+# Entries are keyed on a SHA-256 hash of the domain and task files, the
+# translator options ($TRANSLATE_OPTIONS), the preprocessor arguments and
+# the translator and preprocessor themselves, so changing any of them
+# leads to a new entry. The cache lives in
+# $DOWNWARD_CACHE_DIR (default: ${XDG_CACHE_HOME:-$HOME/.cache}/downward);
+# setting DOWNWARD_CACHE_DIR to the empty string disables it.
+#
+# Entries are created in a temporary directory inside the cache and
+# renamed into place, so readers never see a partial file. Jobs that miss
+# on the same key wait for each other with flock (if available) instead
+# of grounding the same task twice.
+
+PLAN_CACHE_DIR="${DOWNWARD_CACHE_DIR-${XDG_CACHE_HOME:-$HOME/.cache}/downward}"
+
+function absolute_path {
+    echo "$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+}
+
+# Mirrors the automatic naming rules of translate/pddl/pddl_file.py.
+function find_domain_file {
+    local dir="$(dirname "$1")"
+    local base="$(basename "$1")"
+    local candidates=("$dir/domain.pddl")
+    if [[ "$base" =~ ^p[0-9][0-9]($|[^A-Za-z0-9_]) ]]; then
+        candidates+=("$dir/${base:0:4}domain.pddl"
+                     "$dir/${base:0:3}-domain.pddl"
+                     "$dir/domain_$base")
+    fi
+    if [[ "$base" == *-problem.pddl ]]; then
+        candidates+=("$dir/${base%-problem.pddl}-domain.pddl")
+    fi
+    local candidate
+    for candidate in "${candidates[@]}"; do
+        if [[ -e "$candidate" ]]; then
+            echo "$candidate"
+            return 0
+        fi
+    done
+    return 1
+}
+
+function plan_cache_key {
+    local domain="$1" task="$2"
+    shift 2
+    {
+        echo "domain"; sha256sum < "$domain"
+        echo "task"; sha256sum < "$task"
+        echo "translator options"; echo "$TRANSLATE_OPTIONS"
+        echo "preprocess arguments"; printf '%s\n' "$@"
+        echo "translator"
+        find "$(dirname "$TRANSLATE")" -name '*.py' | LC_ALL=C sort |
+            xargs cat | sha256sum
+        echo "preprocessor"; sha256sum < "$PREPROCESS"
+    } | sha256sum | cut -d ' ' -f 1
+}
+
+# Usage: cached_preprocess DOMAIN TASK [PREPROCESS_ARGUMENTS...]
+# Runs $TRANSLATE $TRANSLATE_OPTIONS and $PREPROCESS (prefixed with
+# $PLAN_TIME if set) on a cache miss and sets CACHED_OUTPUT to the cached
+# preprocessor output. With --binary, the binary task file is cached as
+# well, as $CACHED_OUTPUT.bin.
+function cached_preprocess {
+    local domain="$(absolute_path "$1")" task="$(absolute_path "$2")"
+    shift 2
+    local translate="$(absolute_path "$TRANSLATE")"
+    local preprocess="$(absolute_path "$PREPROCESS")"
+
+    mkdir -p "$PLAN_CACHE_DIR" || return 1
+    local key="$(plan_cache_key "$domain" "$task" "$@")"
+    CACHED_OUTPUT="$PLAN_CACHE_DIR/$key.output"
+    if [[ -f "$CACHED_OUTPUT" ]]; then
+        echo "Using cached preprocessor output $CACHED_OUTPUT"
+        return 0
+    fi
+
+    local lock_fd
+    if command -v flock > /dev/null; then
+        exec {lock_fd}> "$PLAN_CACHE_DIR/$key.lock"
+        flock "$lock_fd"
+        if [[ -f "$CACHED_OUTPUT" ]]; then
+            exec {lock_fd}>&-
+            echo "Using cached preprocessor output $CACHED_OUTPUT"
+            return 0
+        fi
+    fi
+
+    local time_append=""
+    if [[ -n "$PLAN_TIME" ]]; then
+        time_append="$PLAN_TIME --append"
+    fi
+    local tmp="$(mktemp -d "$PLAN_CACHE_DIR/tmp.XXXXXX")"
+    local status=0
+    # set -e does not apply in a subshell whose status is tested.
+    (
+        cd "$tmp" &&
+        $PLAN_TIME "$translate" $TRANSLATE_OPTIONS "$domain" "$task" &&
+        echo &&
+        $time_append "$preprocess" "$@" < output.sas
+    ) || status=$?
+    if [[ $status -eq 0 ]]; then
+        # rename is atomic within the cache directory. The text output
+        # comes last because its presence marks a complete entry.
+        if [[ -f "$tmp/output.bin" ]]; then
+            mv -f "$tmp/output.bin" "$CACHED_OUTPUT.bin" || status=$?
+        fi
+        if [[ $status -eq 0 ]]; then
+            mv -f "$tmp/output" "$CACHED_OUTPUT" || status=$?
+        fi
+    fi
+    rm -rf "$tmp"
+    if [[ -n "$lock_fd" ]]; then
+        exec {lock_fd}>&-
+    fi
+    return $status
+}
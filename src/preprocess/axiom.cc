@@ -1,3 +1,4 @@
+#include "binary_output.h"
 #include "helper_functions.h"
 #include "axiom.h"
 #include "variable.h"
@@ -55,12 +56,25 @@ int Axiom::get_encoding_size() const {
 
 void Axiom::generate_cpp_input(ofstream &outfile) const {
     assert(effect_var->get_level() != -1);
-    outfile << "begin_rule" << endl;
-    outfile << conditions.size() << endl;
+    outfile << "begin_rule" << '\n';
+    outfile << conditions.size() << '\n';
     for (int i = 0; i < conditions.size(); i++) {
         assert(conditions[i].var->get_level() != -1);
-        outfile << conditions[i].var->get_level() << " " << conditions[i].cond << endl;
+        outfile << conditions[i].var->get_level() << " " << conditions[i].cond << '\n';
     }
-    outfile << effect_var->get_level() << " " << old_val << " " << effect_val << endl;
-    outfile << "end_rule" << endl;
+    outfile << effect_var->get_level() << " " << old_val << " " << effect_val << '\n';
+    outfile << "end_rule" << '\n';
+}
+
+void Axiom::generate_binary_input(BinaryOutput &out) const {
+    assert(effect_var->get_level() != -1);
+    out.write_int(conditions.size());
+    for (int i = 0; i < conditions.size(); i++) {
+        assert(conditions[i].var->get_level() != -1);
+        out.write_int(conditions[i].var->get_level());
+        out.write_int(conditions[i].cond);
+    }
+    out.write_int(effect_var->get_level());
+    out.write_int(old_val);
+    out.write_int(effect_val);
 }
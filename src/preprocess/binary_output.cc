@@ -0,0 +1,47 @@
+#include "binary_output.h"
+
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+static const char MAGIC[] = "FDBTASK\n";
+static const int BINARY_FILE_VERSION = 1;
+static const int BYTE_ORDER_MARK = 0x01020304;
+
+BinaryOutput::BinaryOutput(const string &filename)
+    : outfile(filename.c_str(), ios::out | ios::binary) {
+    outfile.write(MAGIC, sizeof(MAGIC) - 1);
+    write_int(BINARY_FILE_VERSION);
+    write_int(BYTE_ORDER_MARK);
+}
+
+void BinaryOutput::write_int(int value) {
+    outfile.write(reinterpret_cast<const char *>(&value), sizeof(int));
+}
+
+void BinaryOutput::write_ints(const vector<int> &values) {
+    if (!values.empty())
+        outfile.write(reinterpret_cast<const char *>(&values[0]),
+                      values.size() * sizeof(int));
+}
+
+void BinaryOutput::write_string(const string &value) {
+    write_int(value.size());
+    outfile.write(value.data(), value.size());
+    // Pad to keep the following integers aligned.
+    static const char padding[sizeof(int)] = {0};
+    outfile.write(padding, (sizeof(int) - value.size() % sizeof(int)) %
+                  sizeof(int));
+}
+
+void BinaryOutput::write_section(Section section) {
+    write_int(section);
+}
+
+void BinaryOutput::close() {
+    outfile.close();
+    if (!outfile) {
+        cerr << "Error writing binary output file." << endl;
+        exit(1);
+    }
+}
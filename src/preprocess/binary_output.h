@@ -0,0 +1,40 @@
+#ifndef BINARY_OUTPUT_H
+#define BINARY_OUTPUT_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+/*
+  Writer for the binary task file that the search component maps into
+  memory instead of parsing the text output file. The format is
+  documented with the reader, BinaryTaskFile in search/binary_task_file.h.
+  The section numbers below must match the ones used there.
+*/
+class BinaryOutput {
+    ofstream outfile;
+public:
+    enum Section {
+        METRIC = 1,
+        VARIABLES,
+        MUTEXES,
+        INITIAL_STATE,
+        GOAL,
+        OPERATORS,
+        AXIOMS,
+        SUCCESSOR_GENERATOR,
+        TRANSITION_GRAPHS,
+        CAUSAL_GRAPH,
+        END
+    };
+
+    explicit BinaryOutput(const string &filename);
+    void write_int(int value);
+    void write_ints(const vector<int> &values);
+    void write_string(const string &value);
+    void write_section(Section section);
+    void close();
+};
+
+#endif
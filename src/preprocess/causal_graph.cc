@@ -22,6 +22,7 @@
  * suppressed in the input for the search programm.
  */
 
+#include "binary_output.h"
 #include "causal_graph.h"
 #include "max_dag.h"
 #include "operator.h"
@@ -284,8 +285,8 @@ void CausalGraph::dump() const {
             cout << "  [" << it->first->get_name() << ", " << it->second << "]" << endl;
     }
 }
-void CausalGraph::generate_cpp_input(ofstream &outfile,
-                                     const vector<Variable *> &ordered_vars)
+void CausalGraph::get_output_arcs(const vector<Variable *> &ordered_vars,
+                                  vector<vector<pair<int, int> > > &arcs)
 const {
     //TODO: use const iterator!
     vector<WeightedSuccessors *> succs; // will be ordered like ordered_vars
@@ -310,18 +311,45 @@ const {
             number_of_succ[source_var->get_level()] = num;
         }
     }
+    arcs.resize(ordered_vars.size());
     for (int i = 0; i < ordered_vars.size(); i++) {
         WeightedSuccessors *curr = succs[i];
-        // print number of variables influenced by variable i
-        outfile << number_of_succ[i] << endl;
+        arcs[i].reserve(number_of_succ[i]);
         for (WeightedSuccessors::const_iterator it = curr->begin();
              it != curr->end(); ++it) {
             if (it->first->get_level() != -1
                 // && it->first->get_level() > ordered_vars[i]->get_level()
                 )
                 // the variable it->first is important and influenced by variable i
-                // print level and weight of influence
-                outfile << it->first->get_level() << " " << it->second << endl;
+                // store level and weight of influence
+                arcs[i].push_back(make_pair(it->first->get_level(), it->second));
+        }
+    }
+}
+
+void CausalGraph::generate_cpp_input(ofstream &outfile,
+                                     const vector<Variable *> &ordered_vars)
+const {
+    vector<vector<pair<int, int> > > arcs;
+    get_output_arcs(ordered_vars, arcs);
+    for (int i = 0; i < arcs.size(); i++) {
+        // print number of variables influenced by variable i
+        outfile << arcs[i].size() << '\n';
+        for (int j = 0; j < arcs[i].size(); j++)
+            outfile << arcs[i][j].first << " " << arcs[i][j].second << '\n';
+    }
+}
+
+void CausalGraph::generate_binary_input(BinaryOutput &out,
+                                        const vector<Variable *> &ordered_vars)
+const {
+    vector<vector<pair<int, int> > > arcs;
+    get_output_arcs(ordered_vars, arcs);
+    for (int i = 0; i < arcs.size(); i++) {
+        out.write_int(arcs[i].size());
+        for (int j = 0; j < arcs[i].size(); j++) {
+            out.write_int(arcs[i][j].first);
+            out.write_int(arcs[i][j].second);
         }
     }
 }
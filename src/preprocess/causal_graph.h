@@ -6,6 +6,7 @@
 #include <map>
 using namespace std;
 
+class BinaryOutput;
 class Operator;
 class Axiom;
 class Variable;
@@ -38,6 +39,9 @@ class CausalGraph {
     void get_strongly_connected_components(Partition &sccs);
     void calculate_topological_pseudo_sort(const Partition &sccs);
     void calculate_important_vars();
+    // Successors (level, weight) of every variable in the output.
+    void get_output_arcs(const vector<Variable *> &ordered_vars,
+                         vector<vector<pair<int, int> > > &arcs) const;
     void dfs(Variable *from);
 public:
     CausalGraph(const vector<Variable *> &variables,
@@ -50,6 +54,8 @@ public:
     void dump() const;
     void generate_cpp_input(ofstream &outfile,
                             const vector<Variable *> &ordered_vars) const;
+    void generate_binary_input(BinaryOutput &out,
+                               const vector<Variable *> &ordered_vars) const;
 };
 
 extern bool g_do_not_prune_variables;
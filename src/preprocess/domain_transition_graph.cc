@@ -8,6 +8,7 @@
  * effect conditions of that postcondition.
  */
 
+#include "binary_output.h"
 #include "domain_transition_graph.h"
 #include "operator.h"
 #include "axiom.h"
@@ -155,47 +156,66 @@ void DomainTransitionGraph::finalize() {
     }
 }
 
+/*
+  The transitions of a variable only depend on the operators and axioms
+  affecting it, so the graphs are built in parallel (with OpenMP). To
+  keep the output identical to a sequential run, every graph receives
+  its transitions in operator order followed by axiom order, as before:
+  a sequential pass collects the effects per variable, and each graph
+  is then filled and finalized by a single thread.
+*/
 void build_DTGs(const vector<Variable *> &var_order,
                 const vector<Operator> &operators,
                 const vector<Axiom> &axioms,
                 vector<DomainTransitionGraph> &transition_graphs) {
-    for (int i = 0; i < var_order.size(); i++) {
+    int num_vars = var_order.size();
+    for (int i = 0; i < num_vars; i++) {
         transition_graphs.push_back(DomainTransitionGraph(*var_order[i]));
     }
 
+    // (operator index, effect index) pairs per variable
+    vector<vector<pair<int, int> > > effects_by_var(num_vars);
     for (int i = 0; i < operators.size(); i++) {
-        const Operator &op = operators[i];
-        const vector<Operator::PrePost> &pre_post = op.get_pre_post();
+        const vector<Operator::PrePost> &pre_post = operators[i].get_pre_post();
         for (int j = 0; j < pre_post.size(); j++) {
-            const Variable *var = pre_post[j].var;
-            int var_level = var->get_level();
-            if (var_level != -1) {
-                int pre = pre_post[j].pre;
-                int post = pre_post[j].post;
-                if (pre != -1) {
-                    transition_graphs[var_level].addTransition(pre, post, op, i, pre_post[j]);
-                } else {
-                    for (int pre = 0; pre < var->get_range(); pre++)
-                        if (pre != post)
-                            transition_graphs[var_level].addTransition(pre, post, op, i, pre_post[j]);
-                }
-            }
-            //else
-            //cout <<"leave out var "<< var->get_name()<<" (unimportant) " << endl;
+            int var_level = pre_post[j].var->get_level();
+            if (var_level != -1)
+                effects_by_var[var_level].push_back(make_pair(i, j));
         }
     }
+    vector<vector<int> > axioms_by_var(num_vars);
     for (int i = 0; i < axioms.size(); i++) {
-        const Axiom &ax = axioms[i];
-        Variable *var = ax.get_effect_var();
-        int var_level = var->get_level();
+        int var_level = axioms[i].get_effect_var()->get_level();
         assert(var_level != -1);
-        int old_val = ax.get_old_val();
-        int new_val = ax.get_effect_val();
-        transition_graphs[var_level].addAxTransition(old_val, new_val, ax, i);
+        axioms_by_var[var_level].push_back(i);
     }
 
-    for (int i = 0; i < transition_graphs.size(); i++)
-        transition_graphs[i].finalize();
+#pragma omp parallel for schedule(dynamic)
+    for (int var_level = 0; var_level < num_vars; var_level++) {
+        DomainTransitionGraph &dtg = transition_graphs[var_level];
+        const vector<pair<int, int> > &effects = effects_by_var[var_level];
+        for (int i = 0; i < effects.size(); i++) {
+            int op_index = effects[i].first;
+            const Operator &op = operators[op_index];
+            const Operator::PrePost &pre_post = op.get_pre_post()[effects[i].second];
+            int pre = pre_post.pre;
+            int post = pre_post.post;
+            if (pre != -1) {
+                dtg.addTransition(pre, post, op, op_index, pre_post);
+            } else {
+                for (int pre = 0; pre < pre_post.var->get_range(); pre++)
+                    if (pre != post)
+                        dtg.addTransition(pre, post, op, op_index, pre_post);
+            }
+        }
+        const vector<int> &var_axioms = axioms_by_var[var_level];
+        for (int i = 0; i < var_axioms.size(); i++) {
+            const Axiom &ax = axioms[var_axioms[i]];
+            dtg.addAxTransition(ax.get_old_val(), ax.get_effect_val(), ax,
+                                var_axioms[i]);
+        }
+        dtg.finalize();
+    }
 }
 bool are_DTGs_strongly_connected(const vector<DomainTransitionGraph> &transition_graphs) {
     bool connected = true;
@@ -247,21 +267,43 @@ void DomainTransitionGraph::dump() const {
 void DomainTransitionGraph::generate_cpp_input(ofstream &outfile) const {
     //outfile << vertices.size() << endl; // the variable's range
     for (int i = 0; i < vertices.size(); i++) {
-        outfile << vertices[i].size() << endl; // number of transitions from this value
+        outfile << vertices[i].size() << '\n'; // number of transitions from this value
         for (int j = 0; j < vertices[i].size(); j++) {
             const Transition &trans = vertices[i][j];
-            outfile << trans.target << endl; // target of transition
-            outfile << trans.op << endl; // operator doing the transition
+            outfile << trans.target << '\n'; // target of transition
+            outfile << trans.op << '\n'; // operator doing the transition
             // calculate number of important prevail conditions
             int number = 0;
             for (int k = 0; k < trans.condition.size(); k++)
                 if (trans.condition[k].first->get_level() != -1)
                     number++;
-            outfile << number << endl;
+            outfile << number << '\n';
             for (int k = 0; k < trans.condition.size(); k++)
                 if (trans.condition[k].first->get_level() != -1)
                     outfile << trans.condition[k].first->get_level() <<
-                    " " << trans.condition[k].second << endl;  // condition: var, val
+                    " " << trans.condition[k].second << '\n';  // condition: var, val
+        }
+    }
+}
+
+void DomainTransitionGraph::generate_binary_input(BinaryOutput &out) const {
+    for (int i = 0; i < vertices.size(); i++) {
+        out.write_int(vertices[i].size());
+        for (int j = 0; j < vertices[i].size(); j++) {
+            const Transition &trans = vertices[i][j];
+            out.write_int(trans.target);
+            out.write_int(trans.op);
+            int number = 0;
+            for (int k = 0; k < trans.condition.size(); k++)
+                if (trans.condition[k].first->get_level() != -1)
+                    number++;
+            out.write_int(number);
+            for (int k = 0; k < trans.condition.size(); k++) {
+                if (trans.condition[k].first->get_level() != -1) {
+                    out.write_int(trans.condition[k].first->get_level());
+                    out.write_int(trans.condition[k].second);
+                }
+            }
         }
     }
 }
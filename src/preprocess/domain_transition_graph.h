@@ -7,6 +7,7 @@ using namespace std;
 
 #include "operator.h"
 
+class BinaryOutput;
 class Axiom;
 class Variable;
 
@@ -15,7 +16,10 @@ public:
     typedef vector<pair<const Variable *, int> > Condition;
 private:
     struct Transition {
-        Transition(int theTarget, int theOp) : target(theTarget), op(theOp) {}
+        // Axiom transitions keep cost 0. It takes part in sorting, so it
+        // must not be left uninitialized.
+        Transition(int theTarget, int theOp)
+            : target(theTarget), op(theOp), cost(0) {}
         bool operator==(const Transition &other) const {
             return target == other.target &&
                    op == other.op &&
@@ -38,6 +42,7 @@ public:
     void finalize();
     void dump() const;
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryOutput &out) const;
     bool is_strongly_connected() const;
 };
 
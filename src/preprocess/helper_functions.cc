@@ -6,6 +6,7 @@
 #include <vector>
 using namespace std;
 
+#include "binary_output.h"
 #include "helper_functions.h"
 #include "state.h"
 #include "mutex_group.h"
@@ -18,6 +19,7 @@ using namespace std;
 
 static const int SAS_FILE_VERSION = 3;
 static const int PRE_FILE_VERSION = SAS_FILE_VERSION;
+static const int OUTPUT_BUFFER_SIZE = 1 << 20;
 
 
 void check_magic(istream &in, string magic) {
@@ -165,35 +167,39 @@ void generate_cpp_input(bool /*solvable_in_poly_time*/,
                         const vector<Operator> &operators,
                         const vector<Axiom> &axioms,
                         const SuccessorGenerator &sg,
-                        const vector<DomainTransitionGraph> transition_graphs,
+                        const vector<DomainTransitionGraph> &transition_graphs,
                         const CausalGraph &cg) {
     /* NOTE: solvable_in_poly_time flag is no longer included in output,
        since the planner doesn't handle it specially any more anyway. */
 
+    // Lines end in '\n' rather than endl, which would flush the stream
+    // after every line, and the file is written in large blocks.
+    vector<char> buffer(OUTPUT_BUFFER_SIZE);
     ofstream outfile;
+    outfile.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
     outfile.open("output", ios::out);
 
-    outfile << "begin_version" << endl;
-    outfile << PRE_FILE_VERSION << endl;
-    outfile << "end_version" << endl;
+    outfile << "begin_version" << '\n';
+    outfile << PRE_FILE_VERSION << '\n';
+    outfile << "end_version" << '\n';
 
-    outfile << "begin_metric" << endl;
-    outfile << metric << endl;
-    outfile << "end_metric" << endl;
+    outfile << "begin_metric" << '\n';
+    outfile << metric << '\n';
+    outfile << "end_metric" << '\n';
 
-    outfile << ordered_vars.size() << endl;
+    outfile << ordered_vars.size() << '\n';
     for (int i = 0; i < ordered_vars.size(); i++)
         ordered_vars[i]->generate_cpp_input(outfile);
 
-    outfile << mutexes.size() << endl;
+    outfile << mutexes.size() << '\n';
     for (int i = 0; i < mutexes.size(); i++)
         mutexes[i].generate_cpp_input(outfile);
 
     int var_count = ordered_vars.size();
-    outfile << "begin_state" << endl;
+    outfile << "begin_state" << '\n';
     for (int i = 0; i < var_count; i++)
-        outfile << initial_state[ordered_vars[i]] << endl;  // for axioms default value
-    outfile << "end_state" << endl;
+        outfile << initial_state[ordered_vars[i]] << '\n';  // for axioms default value
+    outfile << "end_state" << '\n';
 
     vector<int> ordered_goal_values;
     ordered_goal_values.resize(var_count, -1);
@@ -201,34 +207,107 @@ void generate_cpp_input(bool /*solvable_in_poly_time*/,
         int var_index = goals[i].first->get_level();
         ordered_goal_values[var_index] = goals[i].second;
     }
-    outfile << "begin_goal" << endl;
-    outfile << goals.size() << endl;
+    outfile << "begin_goal" << '\n';
+    outfile << goals.size() << '\n';
     for (int i = 0; i < var_count; i++)
         if (ordered_goal_values[i] != -1)
-            outfile << i << " " << ordered_goal_values[i] << endl;
-    outfile << "end_goal" << endl;
+            outfile << i << " " << ordered_goal_values[i] << '\n';
+    outfile << "end_goal" << '\n';
 
-    outfile << operators.size() << endl;
+    outfile << operators.size() << '\n';
     for (int i = 0; i < operators.size(); i++)
         operators[i].generate_cpp_input(outfile);
 
-    outfile << axioms.size() << endl;
+    outfile << axioms.size() << '\n';
     for (int i = 0; i < axioms.size(); i++)
         axioms[i].generate_cpp_input(outfile);
 
-    outfile << "begin_SG" << endl;
+    outfile << "begin_SG" << '\n';
     sg.generate_cpp_input(outfile);
-    outfile << "end_SG" << endl;
+    outfile << "end_SG" << '\n';
 
     for (int i = 0; i < var_count; i++) {
-        outfile << "begin_DTG" << endl;
+        outfile << "begin_DTG" << '\n';
         transition_graphs[i].generate_cpp_input(outfile);
-        outfile << "end_DTG" << endl;
+        outfile << "end_DTG" << '\n';
     }
 
-    outfile << "begin_CG" << endl;
+    outfile << "begin_CG" << '\n';
     cg.generate_cpp_input(outfile, ordered_vars);
-    outfile << "end_CG" << endl;
+    outfile << "end_CG" << '\n';
 
     outfile.close();
+    if (!outfile) {
+        cerr << "Error writing output file." << endl;
+        exit(1);
+    }
+}
+
+void generate_binary_input(const vector<Variable *> &ordered_vars,
+                           const bool &metric,
+                           const vector<MutexGroup> &mutexes,
+                           const State &initial_state,
+                           const vector<pair<Variable *, int> > &goals,
+                           const vector<Operator> &operators,
+                           const vector<Axiom> &axioms,
+                           const SuccessorGenerator &sg,
+                           const vector<DomainTransitionGraph> &transition_graphs,
+                           const CausalGraph &cg) {
+    BinaryOutput out("output.bin");
+
+    out.write_section(BinaryOutput::METRIC);
+    out.write_int(metric);
+
+    out.write_section(BinaryOutput::VARIABLES);
+    out.write_int(ordered_vars.size());
+    for (int i = 0; i < ordered_vars.size(); i++)
+        ordered_vars[i]->generate_binary_input(out);
+
+    out.write_section(BinaryOutput::MUTEXES);
+    out.write_int(mutexes.size());
+    for (int i = 0; i < mutexes.size(); i++)
+        mutexes[i].generate_binary_input(out);
+
+    int var_count = ordered_vars.size();
+    out.write_section(BinaryOutput::INITIAL_STATE);
+    for (int i = 0; i < var_count; i++)
+        out.write_int(initial_state[ordered_vars[i]]);
+
+    vector<int> ordered_goal_values;
+    ordered_goal_values.resize(var_count, -1);
+    for (int i = 0; i < goals.size(); i++) {
+        int var_index = goals[i].first->get_level();
+        ordered_goal_values[var_index] = goals[i].second;
+    }
+    out.write_section(BinaryOutput::GOAL);
+    out.write_int(goals.size());
+    for (int i = 0; i < var_count; i++) {
+        if (ordered_goal_values[i] != -1) {
+            out.write_int(i);
+            out.write_int(ordered_goal_values[i]);
+        }
+    }
+
+    out.write_section(BinaryOutput::OPERATORS);
+    out.write_int(operators.size());
+    for (int i = 0; i < operators.size(); i++)
+        operators[i].generate_binary_input(out);
+
+    out.write_section(BinaryOutput::AXIOMS);
+    out.write_int(axioms.size());
+    for (int i = 0; i < axioms.size(); i++)
+        axioms[i].generate_binary_input(out);
+
+    out.write_section(BinaryOutput::SUCCESSOR_GENERATOR);
+    sg.generate_binary_input(out);
+
+    out.write_section(BinaryOutput::TRANSITION_GRAPHS);
+    for (int i = 0; i < var_count; i++)
+        transition_graphs[i].generate_binary_input(out);
+
+    out.write_section(BinaryOutput::CAUSAL_GRAPH);
+    cg.generate_binary_input(out, ordered_vars);
+
+    out.write_section(BinaryOutput::END);
+    out.close();
 }
@@ -47,8 +47,20 @@ void generate_cpp_input(bool causal_graph_acyclic,
                         const vector<Operator> &operators,
                         const vector<Axiom> &axioms,
                         const SuccessorGenerator &sg,
-                        const vector<DomainTransitionGraph> transition_graphs,
+                        const vector<DomainTransitionGraph> &transition_graphs,
                         const CausalGraph &cg);
+// Writes the same data as generate_cpp_input to the binary file
+// output.bin (see binary_output.h).
+void generate_binary_input(const vector<Variable *> &ordered_vars,
+                           const bool &metric,
+                           const vector<MutexGroup> &mutexes,
+                           const State &initial_state,
+                           const vector<pair<Variable *, int> > &goals,
+                           const vector<Operator> &operators,
+                           const vector<Axiom> &axioms,
+                           const SuccessorGenerator &sg,
+                           const vector<DomainTransitionGraph> &transition_graphs,
+                           const CausalGraph &cg);
 void check_magic(istream &in, string magic);
 
 #endif
@@ -1,5 +1,6 @@
 #include "mutex_group.h"
 
+#include "binary_output.h"
 #include "helper_functions.h"
 #include "variable.h"
 
@@ -30,13 +31,21 @@ void MutexGroup::dump() const {
 }
 
 void MutexGroup::generate_cpp_input(ofstream &outfile) const {
-    outfile << "begin_mutex_group" << endl
-            << facts.size() << endl;
+    outfile << "begin_mutex_group" << '\n'
+            << facts.size() << '\n';
     for (size_t i = 0; i < facts.size(); ++i) {
         outfile << facts[i].first->get_level()
-                << " " << facts[i].second << endl;
+                << " " << facts[i].second << '\n';
+    }
+    outfile << "end_mutex_group" << '\n';
+}
+
+void MutexGroup::generate_binary_input(BinaryOutput &out) const {
+    out.write_int(facts.size());
+    for (size_t i = 0; i < facts.size(); ++i) {
+        out.write_int(facts[i].first->get_level());
+        out.write_int(facts[i].second);
     }
-    outfile << "end_mutex_group" << endl;
 }
 
 void MutexGroup::strip_unimportant_facts() {
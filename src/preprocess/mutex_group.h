@@ -5,6 +5,7 @@
 #include <vector>
 using namespace std;
 
+class BinaryOutput;
 class Variable;
 
 class MutexGroup {
@@ -17,6 +18,7 @@ public:
 
     int get_encoding_size() const;
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryOutput &out) const;
     void dump() const;
 };
 
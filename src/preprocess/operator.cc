@@ -1,3 +1,4 @@
+#include "binary_output.h"
 #include "helper_functions.h"
 #include "operator.h"
 #include "variable.h"
@@ -98,17 +99,17 @@ void strip_operators(vector<Operator> &operators) {
 
 void Operator::generate_cpp_input(ofstream &outfile) const {
     //TODO: beim Einlesen in search feststellen, ob leerer Operator
-    outfile << "begin_operator" << endl;
-    outfile << name << endl;
+    outfile << "begin_operator" << '\n';
+    outfile << name << '\n';
 
-    outfile << prevail.size() << endl;
+    outfile << prevail.size() << '\n';
     for (int i = 0; i < prevail.size(); i++) {
         assert(prevail[i].var->get_level() != -1);
         if (prevail[i].var->get_level() != -1)
-            outfile << prevail[i].var->get_level() << " " << prevail[i].prev << endl;
+            outfile << prevail[i].var->get_level() << " " << prevail[i].prev << '\n';
     }
 
-    outfile << pre_post.size() << endl;
+    outfile << pre_post.size() << '\n';
     for (int i = 0; i < pre_post.size(); i++) {
         assert(pre_post[i].var->get_level() != -1);
         outfile << pre_post[i].effect_conds.size();
@@ -117,8 +118,33 @@ void Operator::generate_cpp_input(ofstream &outfile) const {
                     << " " << pre_post[i].effect_conds[j].cond;
         outfile << " " << pre_post[i].var->get_level()
                 << " " << pre_post[i].pre
-                << " " << pre_post[i].post << endl;
+                << " " << pre_post[i].post << '\n';
     }
-    outfile << cost << endl;
-    outfile << "end_operator" << endl;
+    outfile << cost << '\n';
+    outfile << "end_operator" << '\n';
+}
+
+void Operator::generate_binary_input(BinaryOutput &out) const {
+    out.write_string(name);
+    out.write_int(prevail.size());
+    for (int i = 0; i < prevail.size(); i++) {
+        assert(prevail[i].var->get_level() != -1);
+        out.write_int(prevail[i].var->get_level());
+        out.write_int(prevail[i].prev);
+    }
+
+    out.write_int(pre_post.size());
+    for (int i = 0; i < pre_post.size(); i++) {
+        assert(pre_post[i].var->get_level() != -1);
+        const vector<EffCond> &effect_conds = pre_post[i].effect_conds;
+        out.write_int(effect_conds.size());
+        for (int j = 0; j < effect_conds.size(); j++) {
+            out.write_int(effect_conds[j].var->get_level());
+            out.write_int(effect_conds[j].cond);
+        }
+        out.write_int(pre_post[i].var->get_level());
+        out.write_int(pre_post[i].pre);
+        out.write_int(pre_post[i].post);
+    }
+    out.write_int(cost);
 }
@@ -15,10 +15,11 @@
 #include "operator.h"
 #include "axiom.h"
 #include "variable.h"
+#include <cstring>
 #include <iostream>
 using namespace std;
 
-int main(int argc, const char **) {
+int main(int argc, const char **argv) {
     bool metric;
     vector<Variable *> variables;
     vector<Variable> internal_variables;
@@ -29,9 +30,17 @@ int main(int argc, const char **) {
     vector<Axiom> axioms;
     vector<DomainTransitionGraph> transition_graphs;
 
-    if (argc != 1) {
-        cout << "*** do not perform relevance analysis ***" << endl;
-        g_do_not_prune_variables = true;
+    // --binary additionally writes the task to output.bin, which the
+    // search component loads much faster than the text file. Any other
+    // argument disables the relevance analysis.
+    bool binary_output = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--binary") == 0) {
+            binary_output = true;
+        } else if (!g_do_not_prune_variables) {
+            cout << "*** do not perform relevance analysis ***" << endl;
+            g_do_not_prune_variables = true;
+        }
     }
 
     read_preprocessed_problem_description
@@ -103,5 +112,12 @@ int main(int argc, const char **) {
                        mutexes, initial_state, goals,
                        operators, axioms, successor_generator,
                        transition_graphs, causal_graph);
+    if (binary_output) {
+        cout << "Writing binary output..." << endl;
+        generate_binary_input(ordering, metric,
+                              mutexes, initial_state, goals,
+                              operators, axioms, successor_generator,
+                              transition_graphs, causal_graph);
+    }
     cout << "done" << endl << endl;
 }
@@ -1,3 +1,4 @@
+#include "binary_output.h"
 #include "operator.h"
 #include "successor_generator.h"
 #include "variable.h"
@@ -26,11 +27,41 @@ using namespace std;
 
 */
 
+// Subtrees with fewer operators are not worth a task of their own.
+static const int MIN_OPERATORS_FOR_TASK = 256;
+
+/*
+  Flat form of the successor generator as used by the search component
+  (see search/successor_generator.h). Every node has five entries in
+  nodes: the variable (-1 for leaves), the range of its operators in
+  op_indices, the index of its first value child in children and its
+  default child. Subtrees without operators are omitted and referred to
+  as -1. The search component builds the same arrays when it reads the
+  text format, so nodes are added in the same order here.
+*/
+struct FlatGenerator {
+    vector<int> nodes;
+    vector<int> children;
+    vector<int> op_indices;
+
+    int add_node(int var, int ops_begin, int ops_end, int children_begin,
+                 int default_child) {
+        nodes.push_back(var);
+        nodes.push_back(ops_begin);
+        nodes.push_back(ops_end);
+        nodes.push_back(children_begin);
+        nodes.push_back(default_child);
+        return nodes.size() / 5 - 1;
+    }
+};
+
 class GeneratorBase {
 public:
     virtual ~GeneratorBase() {}
     virtual void dump(string indent) const = 0;
     virtual void generate_cpp_input(ofstream &outfile) const = 0;
+    // Adds the subtree to flat and returns its root, or -1 if it is empty.
+    virtual int flatten(FlatGenerator &flat) const = 0;
 };
 
 class GeneratorSwitch : public GeneratorBase {
@@ -46,6 +77,7 @@ public:
                     GeneratorBase *default_gen);
     virtual void dump(string indent) const;
     virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual int flatten(FlatGenerator &flat) const;
 };
 
 class GeneratorLeaf : public GeneratorBase {
@@ -54,12 +86,14 @@ public:
     GeneratorLeaf(list<int> &operators);
     virtual void dump(string indent) const;
     virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual int flatten(FlatGenerator &flat) const;
 };
 
 class GeneratorEmpty : public GeneratorBase {
 public:
     virtual void dump(string indent) const;
     virtual void generate_cpp_input(ofstream &outfile) const;
+    virtual int flatten(FlatGenerator &flat) const;
 };
 
 GeneratorSwitch::GeneratorSwitch(Variable *switch_variable,
@@ -95,11 +129,11 @@ void GeneratorSwitch::dump(string indent) const {
 void GeneratorSwitch::generate_cpp_input(ofstream &outfile) const {
     int level = switch_var->get_level();
     assert(level != -1);
-    outfile << "switch " << level << endl;
-    outfile << "check " << immediate_ops_indices.size() << endl;
+    outfile << "switch " << level << '\n';
+    outfile << "check " << immediate_ops_indices.size() << '\n';
     for (list<int>::const_iterator op_iter = immediate_ops_indices.begin();
          op_iter != immediate_ops_indices.end(); ++op_iter)
-        outfile << *op_iter << endl;
+        outfile << *op_iter << '\n';
     for (int i = 0; i < switch_var->get_range(); i++) {
         //cout << "case "<<switch_var->get_name()<<" (Level " <<switch_var->get_level() <<
         //  ") has value " << i << ":" << endl;
@@ -109,6 +143,34 @@ void GeneratorSwitch::generate_cpp_input(ofstream &outfile) const {
     default_generator->generate_cpp_input(outfile);
 }
 
+int GeneratorSwitch::flatten(FlatGenerator &flat) const {
+    int ops_begin = flat.op_indices.size();
+    flat.op_indices.insert(flat.op_indices.end(),
+                           immediate_ops_indices.begin(),
+                           immediate_ops_indices.end());
+    int ops_end = flat.op_indices.size();
+    // The subtrees add their own children, so ours are added afterwards
+    // to keep them contiguous.
+    vector<int> value_children;
+    bool has_children = false;
+    for (int i = 0; i < switch_var->get_range(); i++) {
+        value_children.push_back(generator_for_value[i]->flatten(flat));
+        if (value_children.back() != -1)
+            has_children = true;
+    }
+    int default_child = default_generator->flatten(flat);
+    if (!has_children && default_child == -1) {
+        if (ops_begin == ops_end)
+            return -1;
+        return flat.add_node(-1, ops_begin, ops_end, -1, -1);
+    }
+    int children_begin = flat.children.size();
+    flat.children.insert(flat.children.end(), value_children.begin(),
+                         value_children.end());
+    return flat.add_node(switch_var->get_level(), ops_begin, ops_end,
+                         children_begin, default_child);
+}
+
 GeneratorLeaf::GeneratorLeaf(list<int> &ops) {
     applicable_ops_indices.swap(ops);
 }
@@ -119,11 +181,21 @@ void GeneratorLeaf::dump(string indent) const {
         cout << indent << *op_iter << endl;
 }
 
+int GeneratorLeaf::flatten(FlatGenerator &flat) const {
+    if (applicable_ops_indices.empty())
+        return -1;
+    int ops_begin = flat.op_indices.size();
+    flat.op_indices.insert(flat.op_indices.end(),
+                           applicable_ops_indices.begin(),
+                           applicable_ops_indices.end());
+    return flat.add_node(-1, ops_begin, flat.op_indices.size(), -1, -1);
+}
+
 void GeneratorLeaf::generate_cpp_input(ofstream &outfile) const {
-    outfile << "check " << applicable_ops_indices.size() << endl;
+    outfile << "check " << applicable_ops_indices.size() << '\n';
     for (list<int>::const_iterator op_iter = applicable_ops_indices.begin();
          op_iter != applicable_ops_indices.end(); ++op_iter)
-        outfile << *op_iter << endl;
+        outfile << *op_iter << '\n';
 }
 
 void GeneratorEmpty::dump(string indent) const {
@@ -131,7 +203,11 @@ void GeneratorEmpty::dump(string indent) const {
 }
 
 void GeneratorEmpty::generate_cpp_input(ofstream &outfile) const {
-    outfile << "check 0" << endl;
+    outfile << "check 0" << '\n';
+}
+
+int GeneratorEmpty::flatten(FlatGenerator &) const {
+    return -1;
 }
 
 SuccessorGenerator::SuccessorGenerator(const vector<Variable *> &variables,
@@ -160,6 +236,10 @@ SuccessorGenerator::SuccessorGenerator(const vector<Variable *> &variables,
     varOrder = variables;
     sort(varOrder.begin(), varOrder.end());
 
+    // The subtrees are constructed by OpenMP tasks. The tree does not
+    // depend on which thread builds which part.
+#pragma omp parallel
+#pragma omp single
     root = construct_recursive(0, all_operator_indices);
 }
 
@@ -177,6 +257,7 @@ GeneratorBase *SuccessorGenerator::construct_recursive(int switch_var_no,
         int number_of_children = switch_var->get_range();
 
         vector<list<int> > ops_for_val_indices(number_of_children);
+        vector<int> num_ops_for_val(number_of_children, 0);
         list<int> default_ops_indices;
         list<int> applicable_ops_indices;
 
@@ -204,6 +285,7 @@ GeneratorBase *SuccessorGenerator::construct_recursive(int switch_var_no,
                         ++cond_iter;
                     }
                     ops_for_val_indices[val].push_back(op_index);
+                    ++num_ops_for_val[val];
                 } else {
                     default_ops_indices.push_back(op_index);
                 }
@@ -213,13 +295,22 @@ GeneratorBase *SuccessorGenerator::construct_recursive(int switch_var_no,
         if (all_ops_are_immediate) {
             return new GeneratorLeaf(applicable_ops_indices);
         } else if (var_is_interesting) {
-            vector<GeneratorBase *> gen_for_val;
+            // The subtrees have disjoint operator sets, so large ones are
+            // built by other threads.
+            vector<GeneratorBase *> gen_for_val(number_of_children);
             for (int j = 0; j < number_of_children; j++) {
-                gen_for_val.push_back(construct_recursive(switch_var_no + 1,
-                                                          ops_for_val_indices[j]));
+                if (num_ops_for_val[j] >= MIN_OPERATORS_FOR_TASK) {
+#pragma omp task shared(gen_for_val, ops_for_val_indices)
+                    gen_for_val[j] = construct_recursive(switch_var_no + 1,
+                                                         ops_for_val_indices[j]);
+                } else {
+                    gen_for_val[j] = construct_recursive(switch_var_no + 1,
+                                                         ops_for_val_indices[j]);
+                }
             }
             GeneratorBase *default_sg = construct_recursive(switch_var_no + 1,
                                                             default_ops_indices);
+#pragma omp taskwait
             return new GeneratorSwitch(switch_var, applicable_ops_indices, gen_for_val, default_sg);
         } else {
             // this switch var can be left out because no operator depends on it
@@ -244,3 +335,15 @@ void SuccessorGenerator::dump() const {
 void SuccessorGenerator::generate_cpp_input(ofstream &outfile) const {
     root->generate_cpp_input(outfile);
 }
+
+void SuccessorGenerator::generate_binary_input(BinaryOutput &out) const {
+    FlatGenerator flat;
+    int flat_root = root->flatten(flat);
+    out.write_int(flat.nodes.size() / 5);
+    out.write_ints(flat.nodes);
+    out.write_int(flat.children.size());
+    out.write_ints(flat.children);
+    out.write_int(flat.op_indices.size());
+    out.write_ints(flat.op_indices);
+    out.write_int(flat_root);
+}
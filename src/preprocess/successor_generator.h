@@ -7,6 +7,7 @@
 #include <map>
 using namespace std;
 
+class BinaryOutput;
 class GeneratorBase;
 class Operator;
 class Variable;
@@ -31,6 +32,7 @@ public:
     ~SuccessorGenerator();
     void dump() const;
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryOutput &out) const;
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "variable.h"
 
+#include "binary_output.h"
 #include "helper_functions.h"
 
 #include <cassert>
@@ -55,11 +56,19 @@ void Variable::dump() const {
 }
 
 void Variable::generate_cpp_input(ofstream &outfile) const {
-    outfile << "begin_variable" << endl
-            << name << endl
-            << layer << endl
-            << values.size() << endl;
+    outfile << "begin_variable" << '\n'
+            << name << '\n'
+            << layer << '\n'
+            << values.size() << '\n';
     for (size_t i = 0; i < values.size(); ++i)
-        outfile << values[i] << endl;
-    outfile << "end_variable" << endl;
+        outfile << values[i] << '\n';
+    outfile << "end_variable" << '\n';
+}
+
+void Variable::generate_binary_input(BinaryOutput &out) const {
+    out.write_string(name);
+    out.write_int(layer);
+    out.write_int(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        out.write_string(values[i]);
 }
@@ -5,6 +5,8 @@
 #include <vector>
 using namespace std;
 
+class BinaryOutput;
+
 class Variable {
     vector<string> values;
     string name;
@@ -22,6 +24,7 @@ public:
     int get_layer() const {return layer; }
     bool is_derived() const {return layer != -1; }
     void generate_cpp_input(ofstream &outfile) const;
+    void generate_binary_input(BinaryOutput &out) const;
     void dump() const;
     string get_fact_name(int value) const {return values[value]; }
 };
@@ -43,69 +43,70 @@ void AdditiveHeuristic::initialize() {
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-            prop.marked = false;
-        }
+    for (int prop_id = 0; prop_id < propositions.size(); prop_id++) {
+        Proposition &prop = propositions[prop_id];
+        prop.cost = -1;
+        prop.marked = false;
     }
 
-    // Deal with operators and axioms without preconditions.
     for (int i = 0; i < unary_operators.size(); i++) {
         UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
+        op.unsatisfied_preconditions = op.num_preconditions;
         op.cost = op.base_cost; // will be increased by precondition costs
+    }
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, &op);
+    // Deal with operators and axioms without preconditions.
+    for (int i = 0; i < unary_operators_without_preconditions.size(); i++) {
+        int op_id = unary_operators_without_preconditions[i];
+        const UnaryOperator &op = unary_operators[op_id];
+        enqueue_if_necessary(op.effect, op.base_cost, op_id);
     }
 }
 
 void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
-    for (int var = 0; var < propositions.size(); var++) {
-        Proposition *init_prop = &propositions[var][state[var]];
-        enqueue_if_necessary(init_prop, 0, 0);
-    }
+    for (int var = 0; var < proposition_offsets.size(); var++)
+        enqueue_if_necessary(get_prop_id(var, state[var]), 0, -1);
 }
 
 void AdditiveHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        const Proposition &prop = propositions[top_pair.second];
+        int prop_cost = prop.cost;
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (prop.is_goal && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            increase_cost(unary_op->cost, prop_cost);
-            unary_op->unsatisfied_preconditions--;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, unary_op);
+        const int *triggered_operators = get_precondition_of(prop);
+        for (int i = 0; i < prop.num_precondition_of; i++) {
+            int op_id = triggered_operators[i];
+            UnaryOperator &unary_op = unary_operators[op_id];
+            increase_cost(unary_op.cost, prop_cost);
+            unary_op.unsatisfied_preconditions--;
+            assert(unary_op.unsatisfied_preconditions >= 0);
+            if (unary_op.unsatisfied_preconditions == 0)
+                enqueue_if_necessary(unary_op.effect, unary_op.cost, op_id);
         }
     }
 }
 
 void AdditiveHeuristic::mark_preferred_operators(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (int i = 0; i < unary_op->precondition.size(); i++)
-                mark_preferred_operators(state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
-            if (unary_op->cost == unary_op->base_cost && operator_no != -1) {
+    const State &state, int goal) {
+    Proposition &goal_prop = propositions[goal];
+    if (!goal_prop.marked) { // Only consider each subgoal once.
+        goal_prop.marked = true;
+        if (goal_prop.reached_by != -1) {
+            // We have not yet chained back to a start node.
+            const UnaryOperator &unary_op = unary_operators[goal_prop.reached_by];
+            const int *precondition = get_preconditions(unary_op);
+            for (int i = 0; i < unary_op.num_preconditions; i++)
+                mark_preferred_operators(state, precondition[i]);
+            int operator_no = unary_op.operator_no;
+            if (unary_op.cost == unary_op.base_cost && operator_no != -1) {
                 // Necessary condition for this being a preferred
                 // operator, which we use as a quick test before the
                 // more expensive applicability test.
@@ -126,7 +127,7 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
 
     int total_cost = 0;
     for (int i = 0; i < goal_propositions.size(); i++) {
-        int prop_cost = goal_propositions[i]->cost;
+        int prop_cost = propositions[goal_propositions[i]].cost;
         if (prop_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, prop_cost);
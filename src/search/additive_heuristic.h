@@ -16,22 +16,23 @@ class AdditiveHeuristic : public RelaxationHeuristic {
     // Why not use MAX_INT in C++? 
     static const int MAX_COST_VALUE = 100000000;
 
-    AdaptiveQueue<Proposition *> queue;
+    AdaptiveQueue<int> queue; // proposition ids
     bool did_write_overflow_warning;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
-    void mark_preferred_operators(const State &state, Proposition *goal);
+    void mark_preferred_operators(const State &state, int goal);
 
-    void enqueue_if_necessary(Proposition *prop, int cost, UnaryOperator *op) {
+    void enqueue_if_necessary(int prop_id, int cost, int op_id) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op;
-            queue.push(cost, prop);
+        Proposition &prop = propositions[prop_id];
+        if (prop.cost == -1 || prop.cost > cost) {
+            prop.cost = cost;
+            prop.reached_by = op_id;
+            queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop.cost != -1 && prop.cost <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
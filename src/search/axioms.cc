@@ -3,11 +3,16 @@
 #include "operator.h"
 #include "state.h"
 
-#include <deque>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
 AxiomEvaluator::AxiomEvaluator() {
+    has_axioms = false;
+    for (int i = 0; i < g_axiom_layers.size(); i++)
+        if (g_axiom_layers[i] != -1)
+            has_axioms = true;
+
     // Initialize literals
     for (int i = 0; i < g_variable_domain.size(); i++)
         axiom_literals.push_back(vector<AxiomLiteral>(g_variable_domain[i]));
@@ -23,13 +28,21 @@ AxiomEvaluator::AxiomEvaluator() {
     }
 
     // Cross-reference rules and literals
+    dependent_vars.resize(g_variable_domain.size());
+    rules_by_effect_var.resize(g_variable_domain.size());
     for (int i = 0; i < g_axioms.size(); i++) {
         const vector<Prevail> &conditions = g_axioms[i].get_pre_post()[0].cond;
+        int eff_var = rules[i].effect_var;
         for (int j = 0; j < conditions.size(); j++) {
             const Prevail &cond = conditions[j];
             axiom_literals[cond.var][cond.prev].condition_of.push_back(&rules[i]);
+            vector<int> &dependents = dependent_vars[cond.var];
+            if (find(dependents.begin(), dependents.end(), eff_var) == dependents.end())
+                dependents.push_back(eff_var);
         }
+        rules_by_effect_var[eff_var].push_back(i);
     }
+    is_affected.resize(g_variable_domain.size(), false);
 
     // Initialize negation-by-failure information
     int last_layer = -1;
@@ -51,7 +64,11 @@ AxiomEvaluator::AxiomEvaluator() {
 void AxiomEvaluator::evaluate(state_var_t *state_buffer) {
     // TODO rethink the way this is called: see issue 348.
     // cout << "Evaluating axioms..." << endl;
-    deque<AxiomLiteral *> queue;
+    if (!has_axioms)
+        return;
+    // The queue is a FIFO: literals are consumed from queue_head on.
+    queue.clear();
+    size_t queue_head = 0;
     for (int i = 0; i < g_axiom_layers.size(); i++) {
         if (g_axiom_layers[i] != -1) {
             state_buffer[i] = g_default_axiom_values[i];
@@ -89,9 +106,8 @@ void AxiomEvaluator::evaluate(state_var_t *state_buffer) {
 
     for (int layer_no = 0; layer_no < nbf_info_by_layer.size(); layer_no++) {
         // Apply Horn rules.
-        while (!queue.empty()) {
-            AxiomLiteral *curr_literal = queue.front();
-            queue.pop_front();
+        while (queue_head != queue.size()) {
+            AxiomLiteral *curr_literal = queue[queue_head++];
             for (int i = 0; i < curr_literal->condition_of.size(); i++) {
                 AxiomRule *rule = curr_literal->condition_of[i];
                 if (--(rule->unsatisfied_conditions) == 0) {
@@ -115,3 +131,99 @@ void AxiomEvaluator::evaluate(state_var_t *state_buffer) {
         }
     }
 }
+
+void AxiomEvaluator::evaluate(state_var_t *state_buffer,
+                              const int *changed_vars, int num_changed) {
+    if (!has_axioms)
+        return;
+
+    // Collect the derived variables that depend on the changed variables.
+    // Every rule with an affected variable in its condition sets an
+    // affected variable, so the values of all other derived variables
+    // are those of the predecessor.
+    affected_vars.clear();
+    for (int i = 0; i < num_changed; i++)
+        mark_dependents_affected(changed_vars[i]);
+    if (affected_vars.empty())
+        return;
+    int num_affected_rules = 0;
+    for (size_t i = 0; i < affected_vars.size(); i++) {
+        mark_dependents_affected(affected_vars[i]);
+        num_affected_rules += rules_by_effect_var[affected_vars[i]].size();
+    }
+
+    // Restricting the fixpoint to the affected rules does not pay off if
+    // they are most of the rules.
+    if (2 * num_affected_rules > rules.size()) {
+        for (size_t i = 0; i < affected_vars.size(); i++)
+            is_affected[affected_vars[i]] = false;
+        evaluate(state_buffer);
+        return;
+    }
+
+    queue.clear();
+    size_t queue_head = 0;
+    for (size_t i = 0; i < affected_vars.size(); i++) {
+        int var_no = affected_vars[i];
+        state_buffer[var_no] = g_default_axiom_values[var_no];
+    }
+    for (size_t i = 0; i < affected_vars.size(); i++) {
+        const vector<int> &rule_ids = rules_by_effect_var[affected_vars[i]];
+        for (int j = 0; j < rule_ids.size(); j++) {
+            AxiomRule &rule = rules[rule_ids[j]];
+            rule.unsatisfied_conditions = rule.condition_count;
+            if (rule.condition_count == 0 &&
+                state_buffer[rule.effect_var] != rule.effect_val) {
+                state_buffer[rule.effect_var] = rule.effect_val;
+                queue.push_back(rule.effect_literal);
+            }
+        }
+    }
+
+    // The values of the unaffected variables are final, so their literals
+    // can be processed right away. Only those occurring in the condition
+    // of a rule that sets an affected variable are needed.
+    for (int var_no = 0; var_no < dependent_vars.size(); var_no++) {
+        if (is_affected[var_no])
+            continue;
+        const vector<int> &dependents = dependent_vars[var_no];
+        for (int j = 0; j < dependents.size(); j++) {
+            if (is_affected[dependents[j]]) {
+                queue.push_back(&axiom_literals[var_no][state_buffer[var_no]]);
+                break;
+            }
+        }
+    }
+
+    for (int layer_no = 0; layer_no < nbf_info_by_layer.size(); layer_no++) {
+        // Apply Horn rules that set affected variables.
+        while (queue_head != queue.size()) {
+            AxiomLiteral *curr_literal = queue[queue_head++];
+            for (int i = 0; i < curr_literal->condition_of.size(); i++) {
+                AxiomRule *rule = curr_literal->condition_of[i];
+                if (!is_affected[rule->effect_var])
+                    continue;
+                if (--(rule->unsatisfied_conditions) == 0) {
+                    int var_no = rule->effect_var;
+                    int val = rule->effect_val;
+                    if (state_buffer[var_no] != val) {
+                        state_buffer[var_no] = val;
+                        queue.push_back(rule->effect_literal);
+                    }
+                }
+            }
+        }
+
+        // Apply negation by failure rules to the affected variables.
+        const vector<NegationByFailureInfo> &nbf_info = nbf_info_by_layer[layer_no];
+        for (int i = 0; i < nbf_info.size(); i++) {
+            int var_no = nbf_info[i].var_no;
+            if (is_affected[var_no] &&
+                state_buffer[var_no] == g_default_axiom_values[var_no])
+                queue.push_back(nbf_info[i].literal);
+        }
+    }
+
+    for (size_t i = 0; i < affected_vars.size(); i++)
+        is_affected[affected_vars[i]] = false;
+}
@@ -31,9 +31,45 @@ class AxiomEvaluator {
     std::vector<std::vector<AxiomLiteral> > axiom_literals;
     std::vector<AxiomRule> rules;
     std::vector<std::vector<NegationByFailureInfo> > nbf_info_by_layer;
+
+    // False if the task has no derived variables, so there is nothing to do.
+    bool has_axioms;
+    // For each variable, the derived variables set by rules that have it
+    // in their condition.
+    std::vector<std::vector<int> > dependent_vars;
+    // For each derived variable, the rules that set it.
+    std::vector<std::vector<int> > rules_by_effect_var;
+    // Queue of literals to process, reused by all calls of evaluate.
+    std::vector<AxiomLiteral *> queue;
+    // Scratch space of the incremental evaluate: the derived variables
+    // whose values may differ from those of the predecessor.
+    std::vector<bool> is_affected;
+    std::vector<int> affected_vars;
+
+    void mark_dependents_affected(int var_no) {
+        const std::vector<int> &dependents = dependent_vars[var_no];
+        for (int i = 0; i < dependents.size(); i++) {
+            if (!is_affected[dependents[i]]) {
+                is_affected[dependents[i]] = true;
+                affected_vars.push_back(dependents[i]);
+            }
+        }
+    }
 public:
     AxiomEvaluator();
+    // Computes the values of all derived variables of state_buffer.
     void evaluate(state_var_t *state_buffer);
+    /*
+      Same as evaluate for a successor whose predecessor has been evaluated
+      and which differs from it only in the given variables. Only the
+      derived variables that (transitively) depend on these variables are
+      recomputed: they are reset to their default values and the layered
+      fixpoint is run over the rules setting them, seeded with the values
+      of the other variables. If these rules are most of the rules, this
+      is the full evaluation.
+    */
+    void evaluate(state_var_t *state_buffer, const int *changed_vars,
+                  int num_changed);
 };
 
 #endif
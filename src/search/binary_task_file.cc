@@ -0,0 +1,117 @@
+#include "binary_task_file.h"
+
+#include "utilities.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+static const char MAGIC[] = "FDBTASK\n";
+static const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+static const int BINARY_FILE_VERSION = 1;
+static const int BYTE_ORDER_MARK = 0x01020304;
+
+BinaryTaskFile::BinaryTaskFile(const string &filename_)
+    : filename(filename_), data(0), size(0), pos(0), is_mapped(false) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        fail("could not open file");
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        close(fd);
+        fail("could not determine file size");
+    }
+    size = info.st_size;
+    if (size > 0) {
+        void *mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            fail("could not map file into memory");
+        }
+        data = static_cast<const char *>(mapping);
+        is_mapped = true;
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+    // The mapping stays valid after the file is closed.
+    close(fd);
+    read_header();
+}
+
+BinaryTaskFile::BinaryTaskFile(const string &filename_, const char *data_,
+                               size_t size_)
+    : filename(filename_), data(data_), size(size_), pos(0),
+      is_mapped(false) {
+    read_header();
+}
+
+void BinaryTaskFile::read_header() {
+    if (!is_binary_task_file(data, size))
+        fail("not a binary task file");
+    pos = MAGIC_SIZE;
+    int version = read_int();
+    if (read_int() != BYTE_ORDER_MARK)
+        fail("file was written on a machine with a different byte order");
+    if (version != BINARY_FILE_VERSION) {
+        cerr << "Expected binary task file version " << BINARY_FILE_VERSION
+             << ", got " << version << "." << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+}
+
+BinaryTaskFile::~BinaryTaskFile() {
+    if (is_mapped)
+        munmap(const_cast<char *>(data), size);
+}
+
+bool BinaryTaskFile::is_binary_task_file(const string &filename) {
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    char start[MAGIC_SIZE];
+    return file.read(start, MAGIC_SIZE) &&
+           memcmp(start, MAGIC, MAGIC_SIZE) == 0;
+}
+
+bool BinaryTaskFile::is_binary_task_file(const char *data, size_t size) {
+    return size >= MAGIC_SIZE && memcmp(data, MAGIC, MAGIC_SIZE) == 0;
+}
+
+void BinaryTaskFile::fail(const string &message) const {
+    cerr << "error reading " << filename << ": " << message << endl;
+    exit_with(EXIT_INPUT_ERROR);
+}
+
+int BinaryTaskFile::read_int() {
+    return *read_ints(1);
+}
+
+const int *BinaryTaskFile::read_ints(size_t count) {
+    if (count > (size - pos) / sizeof(int))
+        fail("unexpected end of file");
+    const int *result = reinterpret_cast<const int *>(data + pos);
+    pos += count * sizeof(int);
+    return result;
+}
+
+string BinaryTaskFile::read_string() {
+    int length = read_int();
+    if (length < 0 || size_t(length) > size - pos)
+        fail("unexpected end of file");
+    string result(data + pos, length);
+    // Strings are padded so that the following integers stay aligned.
+    size_t padded = (length + sizeof(int) - 1) / sizeof(int) * sizeof(int);
+    read_ints(padded / sizeof(int));
+    return result;
+}
+
+void BinaryTaskFile::check_section(Section section) {
+    int found = read_int();
+    if (found != section) {
+        cerr << "Expected section " << section << " in binary task file, "
+             << "got " << found << "." << endl;
+        fail("corrupt file");
+    }
+}
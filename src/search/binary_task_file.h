@@ -0,0 +1,92 @@
+#ifndef BINARY_TASK_FILE_H
+#define BINARY_TASK_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/*
+  BinaryTaskFile reads the binary task file that the preprocessor writes
+  with --binary. The file is mapped into memory, so loading it needs no
+  tokenizing and takes time proportional to the size of the task data,
+  not to the number of tokens. It can also read a copy of the file that
+  is already in memory, e.g. one received from another MPI process.
+
+  The file starts with the magic bytes "FDBTASK\n", the format version
+  and the integer 0x01020304, which detects files written on a machine
+  with a different byte order. The rest of the file consists of native
+  32-bit integers and strings (a length followed by the characters,
+  padded to a multiple of four bytes). It holds the same data as the
+  text output file, in the same order, with every part preceded by its
+  section number:
+    METRIC: use_metric
+    VARIABLES: count, then name, axiom layer, range and one string per
+      value for every variable
+    MUTEXES: count, then the number of facts and (var, value) pairs for
+      every group
+    INITIAL_STATE: one value per variable
+    GOAL: count, then (var, value) pairs
+    OPERATORS: count, then for every operator its name, the number of
+      prevail conditions, (var, value) pairs, the number of effects,
+      (condition count, (var, value) pairs, var, pre, post) for every
+      effect, and the cost
+    AXIOMS: count, then (condition count, (var, value) pairs, var, pre,
+      post) for every axiom
+    SUCCESSOR_GENERATOR: the flat successor generator (see
+      SuccessorGenerator): number of nodes, (var, ops_begin, ops_end,
+      children_begin, default_child) for every node, number of children,
+      children, number of operator indices, operator indices, root
+    TRANSITION_GRAPHS: for every variable and every value the number of
+      transitions and (target, operator, condition count, (var, value)
+      pairs) for every transition
+    CAUSAL_GRAPH: for every variable the number of successors and
+      (successor, weight) pairs
+    END
+  The preprocessor writes this format in binary_output.cc, which has to
+  be kept in sync with this reader.
+*/
+class BinaryTaskFile {
+    std::string filename;
+    const char *data;
+    size_t size;
+    size_t pos;
+    bool is_mapped;
+
+    void fail(const std::string &message) const __attribute__((noreturn));
+    void read_header();
+public:
+    enum Section {
+        METRIC = 1,
+        VARIABLES,
+        MUTEXES,
+        INITIAL_STATE,
+        GOAL,
+        OPERATORS,
+        AXIOMS,
+        SUCCESSOR_GENERATOR,
+        TRANSITION_GRAPHS,
+        CAUSAL_GRAPH,
+        END
+    };
+
+    explicit BinaryTaskFile(const std::string &filename);
+    // Reads the file contents in data, which must outlive this object.
+    BinaryTaskFile(const std::string &filename, const char *data,
+                   size_t size);
+    ~BinaryTaskFile();
+
+    // Tests whether the file starts like a binary task file.
+    static bool is_binary_task_file(const std::string &filename);
+    static bool is_binary_task_file(const char *data, size_t size);
+
+    int read_int();
+    BinaryTaskFile &operator>>(int &value) {
+        value = read_int();
+        return *this;
+    }
+    // Returns a pointer to count integers inside the mapped file.
+    const int *read_ints(size_t count);
+    std::string read_string();
+    void check_section(Section section);
+};
+
+#endif
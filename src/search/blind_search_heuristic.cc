@@ -6,6 +6,7 @@
 #include "plugin.h"
 #include "state.h"
 
+#include <algorithm>
 #include <limits>
 #include <utility>
 using namespace std;
@@ -32,6 +33,17 @@ int BlindSearchHeuristic::compute_heuristic(const State &state) {
         return min_operator_cost;
 }
 
+void BlindSearchHeuristic::compute_heuristic_batch(const State *states, int n,
+                                                   int *out) {
+    fill(out, out + n, 0);
+    for (int i = 0; i < g_goal.size(); i++) {
+        int var = g_goal[i].first, value = g_goal[i].second;
+        for (int j = 0; j < n; j++)
+            if (states[j][var] != value)
+                out[j] = min_operator_cost;
+    }
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Blind heuristic",
                              "Returns cost of cheapest action for "
@@ -8,6 +8,8 @@ class BlindSearchHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual void compute_heuristic_batch(const State *states, int n,
+                                         int *out);
 public:
     BlindSearchHeuristic(const Options &options);
     ~BlindSearchHeuristic();
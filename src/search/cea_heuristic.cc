@@ -7,6 +7,7 @@
 #include "plugin.h"
 #include "state.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -80,7 +81,7 @@ struct LocalProblemNode {
     // Dynamic attributes (modified during heuristic computation).
     int cost;
     bool expanded;
-    vector<short> context;
+    short *context; // points into LocalProblem::contexts
 
     LocalTransition *reached_by;
     /* Before a node is expanded, reached_by is the "current best"
@@ -93,11 +94,11 @@ struct LocalProblemNode {
 
     vector<LocalTransition *> waiting_list;
 
-    LocalProblemNode(LocalProblem *owner_, int context_size)
+    LocalProblemNode(LocalProblem *owner_, short *context_)
         : owner(owner_),
           cost(-1),
           expanded(false),
-          context(context_size, -1),
+          context(context_),
           reached_by(0) {
     }
 
@@ -109,6 +110,8 @@ struct LocalProblem {
     int base_priority;
     vector<LocalProblemNode> nodes;
     vector<int> *context_variables;
+    // The contexts of all nodes, one after the other.
+    vector<short> contexts;
 public:
     LocalProblem()
         : base_priority(-1) {
@@ -118,7 +121,7 @@ public:
     }
 };
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
+inline LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
     int var_no, int value) {
     LocalProblem * &table_entry = local_problem_index[var_no][value];
     if (!table_entry) {
@@ -138,9 +141,12 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
 
     int num_parents = problem->context_variables->size();
     size_t num_values = g_variable_domain[var_no];
+    problem->contexts.resize(num_values * num_parents, -1);
     problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+    for (size_t value = 0; value < num_values; ++value) {
+        short *context = problem->contexts.data() + value * num_parents;
+        problem->nodes.push_back(LocalProblemNode(problem, context));
+    }
 
     // Compile the DTG arcs into LocalTransition objects.
     for (size_t value = 0; value < num_values; ++value) {
@@ -168,8 +174,11 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
     for (size_t i = 0; i < g_goal.size(); ++i)
         problem->context_variables->push_back(g_goal[i].first);
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, g_goal.size()));
+    problem->contexts.resize(2 * g_goal.size(), -1);
+    for (size_t value = 0; value < 2; ++value) {
+        short *context = problem->contexts.data() + value * g_goal.size();
+        problem->nodes.push_back(LocalProblemNode(problem, context));
+    }
 
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < g_goal.size(); ++goal_no) {
@@ -249,8 +258,10 @@ void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
     LocalTransition *reached_by = node->reached_by;
     if (reached_by) {
         LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
+        short *context = node->context;
+        copy(parent->context,
+             parent->context + node->owner->context_variables->size(),
+             context);
         const vector<LocalAssignment> &precond = reached_by->label->precond;
         for (size_t i = 0; i < precond.size(); ++i)
             context[precond[i].local_var] = precond[i].value;
@@ -296,7 +307,7 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
         curr_precond = precond.begin(),
         last_precond = precond.end();
 
-    short *context = &trans->source->context.front();
+    short *context = trans->source->context;
     int *parent_vars = &*trans->source->owner->context_variables->begin();
 
     for (; curr_precond != last_precond; ++curr_precond) {
@@ -0,0 +1,77 @@
+#include "checkpoint.h"
+
+#include "utilities.h"
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+using namespace std;
+
+CheckpointFile::CheckpointFile(const string &filename_, Mode mode_)
+    : filename(filename_),
+      temporary_filename(filename_ + ".tmp"),
+      mode(mode_),
+      buffer(BUFFER_SIZE) {
+    if (mode == WRITE)
+        file = fopen(temporary_filename.c_str(), "wb");
+    else
+        file = fopen(filename.c_str(), "rb");
+    if (!file) {
+        cerr << "error: could not open "
+             << (mode == WRITE ? temporary_filename : filename) << endl;
+        exit_with(mode == WRITE ? EXIT_CRITICAL_ERROR : EXIT_INPUT_ERROR);
+    }
+    setvbuf(file, &buffer[0], _IOFBF, buffer.size());
+}
+
+CheckpointFile::~CheckpointFile() {
+    if (file) {
+        fclose(file);
+        if (mode == WRITE)
+            remove(temporary_filename.c_str());
+    }
+}
+
+void CheckpointFile::fail() const {
+    if (mode == WRITE) {
+        cerr << "error: could not write " << temporary_filename << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    } else {
+        cerr << "error: " << filename << " is truncated or corrupt" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+}
+
+void CheckpointFile::write_bytes(const void *data, size_t size) {
+    assert(mode == WRITE);
+    if (size && fwrite(data, 1, size, file) != size)
+        fail();
+}
+
+void CheckpointFile::read_bytes(void *data, size_t size) {
+    assert(mode == READ);
+    if (size && fread(data, 1, size, file) != size)
+        fail();
+}
+
+void CheckpointFile::close() {
+    if (mode == WRITE) {
+        if (fflush(file) != 0 || fsync(fileno(file)) != 0 ||
+            fclose(file) != 0) {
+            file = 0;
+            fail();
+        }
+        file = 0;
+        if (rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+            cerr << "error: could not rename " << temporary_filename
+                 << " to " << filename << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    } else {
+        if (fgetc(file) != EOF)
+            fail();
+        fclose(file);
+        file = 0;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+  CheckpointFile is a binary file holding a checkpoint of a search.
+
+  All data goes through one large stdio buffer, so writing or reading a
+  checkpoint results in few large sequential system calls, independent
+  of the number of states. A file that is written is created under a
+  temporary name and only replaces the given file when close() is
+  called, so an interrupted checkpoint never destroys the previous one.
+  Errors terminate the planner.
+*/
+class CheckpointFile {
+public:
+    enum Mode {
+        READ,
+        WRITE
+    };
+private:
+    static const size_t BUFFER_SIZE = 1 << 22;
+
+    std::string filename;
+    std::string temporary_filename;
+    Mode mode;
+    FILE *file;
+    std::vector<char> buffer;
+
+    void fail() const;
+public:
+    CheckpointFile(const std::string &filename, Mode mode);
+    ~CheckpointFile();
+
+    void write_bytes(const void *data, size_t size);
+    void read_bytes(void *data, size_t size);
+
+    template<class T>
+    void write(const T &value) {
+        write_bytes(&value, sizeof(T));
+    }
+
+    template<class T>
+    void read(T &value) {
+        read_bytes(&value, sizeof(T));
+    }
+
+    // Checks that the whole file has been read or completes the file.
+    void close();
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "compiled_operators.h"
+
+#include "globals.h"
+#include "operator.h"
+
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+CompiledOperators::CompiledOperators(const vector<Operator> &operators) {
+    vector<int> effects_on_var(g_variable_domain.size(), 0);
+    for (size_t op_no = 0; op_no < operators.size(); ++op_no) {
+        const vector<PrePost> &pre_post = operators[op_no].get_pre_post();
+        for (size_t i = 0; i < pre_post.size(); ++i)
+            ++effects_on_var[pre_post[i].var];
+
+        unconditional_begin.push_back(unconditional_var.size());
+        conditional_begin.push_back(conditional_var.size());
+        for (size_t i = 0; i < pre_post.size(); ++i) {
+            const PrePost &effect = pre_post[i];
+            if (effect.cond.empty() && effects_on_var[effect.var] == 1) {
+                unconditional_var.push_back(effect.var);
+                unconditional_value.push_back(effect.post);
+            } else {
+                condition_begin.push_back(condition_var.size());
+                conditional_var.push_back(effect.var);
+                conditional_value.push_back(effect.post);
+                for (size_t j = 0; j < effect.cond.size(); ++j) {
+                    condition_var.push_back(effect.cond[j].var);
+                    condition_value.push_back(effect.cond[j].prev);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < pre_post.size(); ++i)
+            effects_on_var[pre_post[i].var] = 0;
+    }
+    unconditional_begin.push_back(unconditional_var.size());
+    conditional_begin.push_back(conditional_var.size());
+    condition_begin.push_back(condition_var.size());
+}
+
+int CompiledOperators::apply(int op_no, const state_var_t *parent,
+                             state_var_t *child, int *changed_vars) const {
+    assert(op_no >= 0 && op_no + 1 < unconditional_begin.size());
+    int num_changed = 0;
+    int end = unconditional_begin[op_no + 1];
+    for (int i = unconditional_begin[op_no]; i < end; ++i) {
+        int var = unconditional_var[i];
+        state_var_t value = unconditional_value[i];
+        if (parent[var] != value) {
+            child[var] = value;
+            changed_vars[num_changed++] = var;
+        }
+    }
+
+    end = conditional_begin[op_no + 1];
+    for (int i = conditional_begin[op_no]; i < end; ++i) {
+        bool fires = true;
+        int cond_end = condition_begin[i + 1];
+        for (int j = condition_begin[i]; j < cond_end; ++j) {
+            if (parent[condition_var[j]] != condition_value[j]) {
+                fires = false;
+                break;
+            }
+        }
+        if (!fires)
+            continue;
+        int var = conditional_var[i];
+        state_var_t value = conditional_value[i];
+        if (child[var] == value)
+            continue;
+        // A variable that differs from parent has already been stored.
+        // One that has been changed back may have been stored as well.
+        if (child[var] == parent[var] &&
+            find(changed_vars, changed_vars + num_changed, var) ==
+            changed_vars + num_changed)
+            changed_vars[num_changed++] = var;
+        child[var] = value;
+    }
+    return num_changed;
+}
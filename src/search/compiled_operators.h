@@ -0,0 +1,49 @@
+#ifndef COMPILED_OPERATORS_H
+#define COMPILED_OPERATORS_H
+
+#include "state_var_t.h"
+
+#include <vector>
+
+class Operator;
+
+/*
+  Flat form of the effects of all operators in g_operators, built once
+  after the task has been read. The effects are kept in structure-of-arrays
+  form. Each operator has two contiguous ranges:
+    unconditional effects: (var, value) pairs that always fire, and
+    conditional effects: (var, value) pairs with a range of (var, value)
+      conditions.
+  An effect is only unconditional if no other effect of the operator
+  affects the same variable. All other effects keep their order among
+  the conditional effects, because the last effect that fires on a
+  variable determines its value.
+*/
+class CompiledOperators {
+    std::vector<int> unconditional_begin;
+    std::vector<int> unconditional_var;
+    std::vector<state_var_t> unconditional_value;
+
+    std::vector<int> conditional_begin;
+    std::vector<int> conditional_var;
+    std::vector<state_var_t> conditional_value;
+    std::vector<int> condition_begin;
+    std::vector<int> condition_var;
+    std::vector<state_var_t> condition_value;
+public:
+    explicit CompiledOperators(const std::vector<Operator> &operators);
+
+    /*
+      Applies the effects of the operator with the given index in
+      g_operators. child must hold a copy of parent on entry and holds the
+      successor afterwards. Conditions are evaluated in parent. Stores the
+      changed variables in changed_vars, which needs room for one entry
+      per variable, and returns their number. Every variable is stored at
+      most once. A variable with several firing effects can be stored even
+      though its value ends up unchanged.
+    */
+    int apply(int op_no, const state_var_t *parent, state_var_t *child,
+              int *changed_vars) const;
+};
+
+#endif
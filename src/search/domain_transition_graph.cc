@@ -5,6 +5,7 @@
 using namespace std;
 using namespace __gnu_cxx;
 
+#include "binary_task_file.h"
 #include "domain_transition_graph.h"
 #include "globals.h"
 #include "operator.h"
@@ -13,21 +14,38 @@ void DomainTransitionGraph::read_all(istream &in) {
     int var_count = g_variable_domain.size();
 
     // First step: Allocate graphs and nodes.
+    allocate_all();
+
+    // Second step: Read transitions from file.
+    for (int var = 0; var < var_count; var++)
+        g_transition_graphs[var]->read_data(in);
+
+    // Third step: Simplify transitions.
+    simplify_all();
+}
+
+void DomainTransitionGraph::read_all(BinaryTaskFile &in) {
+    allocate_all();
+    for (int var = 0; var < g_transition_graphs.size(); var++)
+        g_transition_graphs[var]->read_transitions(in);
+    simplify_all();
+}
+
+void DomainTransitionGraph::allocate_all() {
+    int var_count = g_variable_domain.size();
     g_transition_graphs.reserve(var_count);
     for (int var = 0; var < var_count; var++) {
         int range = g_variable_domain[var];
         DomainTransitionGraph *dtg = new DomainTransitionGraph(var, range);
         g_transition_graphs.push_back(dtg);
     }
+}
 
-    // Second step: Read transitions from file.
-    for (int var = 0; var < var_count; var++)
-        g_transition_graphs[var]->read_data(in);
-
-    // Third step: Simplify transitions.
+void DomainTransitionGraph::simplify_all() {
     // Don't do this for ADL domains, because the algorithm is exponential
     // in the number of conditions of a transition, which is a constant for STRIPS
     // domains, but not for ADL domains.
+    int var_count = g_transition_graphs.size();
 
     cout << "Simplifying transitions..." << flush;
     for (int var = 0; var < var_count; var++) {
@@ -50,7 +68,12 @@ DomainTransitionGraph::DomainTransitionGraph(int var_index, int node_count) {
 
 void DomainTransitionGraph::read_data(istream &in) {
     check_magic(in, "begin_DTG");
+    read_transitions(in);
+    check_magic(in, "end_DTG");
+}
 
+template<class Input>
+void DomainTransitionGraph::read_transitions(Input &in) {
     map<int, int> global_to_local_child;
     map<int, int> global_to_cea_parent;
     map<pair<int, int>, int> transition_index;
@@ -161,7 +184,6 @@ void DomainTransitionGraph::read_data(istream &in) {
                 ValueTransitionLabel(the_operator, cea_precond, cea_effect));
         }
     }
-    check_magic(in, "end_DTG");
 }
 
 void DomainTransitionGraph::dump() const {
@@ -7,6 +7,7 @@
 #include <vector>
 using namespace std;
 
+class BinaryTaskFile;
 class CGHeuristic;
 class State;
 class Operator;
@@ -99,6 +100,13 @@ class DomainTransitionGraph {
     // Same as local_to_global_child, but for cea heuristic.
 
     DomainTransitionGraph(const DomainTransitionGraph &other); // copying forbidden
+
+    // Reads the transitions, which are all integers, from a text or
+    // binary task file.
+    template<class Input>
+    void read_transitions(Input &in);
+    static void allocate_all();
+    static void simplify_all();
 public:
     DomainTransitionGraph(int var_index, int node_count);
     void read_data(istream &in);
@@ -109,6 +117,7 @@ public:
     // Build vector of values v' such that there is a transition from value to v'.
 
     static void read_all(istream &in);
+    static void read_all(BinaryTaskFile &in);
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include "g_evaluator.h"
 #include "sum_evaluator.h"
 #include "plugin.h"
+#include "open_lists/indexed_open_list.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -20,7 +21,9 @@ EagerSearch::EagerSearch(
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
       do_pathmax(opts.get<bool>("pathmax")),
       use_multi_path_dependence(opts.get<bool>("mpd")),
-      open_list(opts.get<OpenList<StateID> *>("open")) {
+      open_list(opts.get<OpenList<StateID> *>("open")),
+      memory_budget(opts),
+      external_closed_list(0) {
     if (opts.contains("f_eval")) {
         f_evaluator = opts.get<ScalarEvaluator *>("f_eval");
     } else {
@@ -30,6 +33,14 @@ EagerSearch::EagerSearch(
         preferred_operator_heuristics =
             opts.get_list<Heuristic *>("preferred");
     }
+    if (memory_budget.get_policy() == MemoryBudget::SPILL) {
+        external_closed_list = new ExternalClosedList(opts);
+        search_space.set_external_closed_list(external_closed_list);
+    }
+}
+
+EagerSearch::~EagerSearch() {
+    delete external_closed_list;
 }
 
 void EagerSearch::initialize() {
@@ -91,15 +102,147 @@ void EagerSearch::initialize() {
 
         open_list->insert(initial_state.get_id());
     }
+
+    memory_budget.start();
 }
 
 
 void EagerSearch::statistics() const {
     search_progress.print_statistics();
     search_space.statistics();
+    memory_budget.print_statistics();
+    if (external_closed_list)
+        external_closed_list->print_statistics();
+}
+
+MemoryUsage EagerSearch::get_memory_usage() const {
+    MemoryUsage usage;
+    usage.state_registry = g_state_registry->get_memory_usage();
+    usage.per_state_information =
+        g_state_registry->get_per_state_information_memory_usage();
+    usage.open_list = open_list->get_memory_usage();
+    return usage;
+}
+
+bool EagerSearch::check_memory_budget() {
+    // Returns false if the search has to stop.
+    MemoryUsage usage = get_memory_usage();
+    if (!memory_budget.is_exceeded(usage))
+        return true;
+    cout << "Memory usage is close to the limit: ";
+    usage.dump(cout);
+    cout << " [t=" << g_timer << "]" << endl;
+    if (memory_budget.get_policy() != MemoryBudget::STOP) {
+        bool spill = memory_budget.get_policy() == MemoryBudget::SPILL;
+        if (!spill)
+            memory_budget.start_pruning();
+        prune_open_list(spill);
+        usage = get_memory_usage();
+        cout << (spill ? "After spilling closed states: " :
+                 "After pruning the open list: ");
+        usage.dump(cout);
+        cout << endl;
+        if (!memory_budget.is_exceeded(usage))
+            return true;
+    }
+    cout << "Stopping search because of the memory limit." << endl;
+    return false;
+}
+
+void EagerSearch::prune_open_list(bool spill_closed_nodes) {
+    /*
+      Rebuilds the open list with at most one entry per open state, dropping
+      entries for closed and dead-end states. Entries are reinserted as not
+      preferred, so preferred-only open lists lose their entries.
+      If spill_closed_nodes is set, the closed nodes are moved to the
+      external closed list in between, which gives the open states new IDs.
+    */
+    vector<StateID> entries;
+    while (!open_list->empty())
+        entries.push_back(open_list->remove_min(0));
+    open_list->clear();
+
+    vector<StateID> open_states;
+    vector<bool> reinserted(g_state_registry->size(), false);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        StateID id = entries[i];
+        if (reinserted[id.hash()])
+            continue;
+        SearchNode node = search_space.get_node(
+            g_state_registry->lookup_state(id));
+        if (!node.is_open())
+            continue;
+        reinserted[id.hash()] = true;
+        open_states.push_back(id);
+    }
+
+    if (spill_closed_nodes) {
+        vector<StateID> moved_states;
+        delete search_space.spill_closed_nodes(open_states, moved_states);
+        open_states.swap(moved_states);
+    }
+
+    for (size_t i = 0; i < open_states.size(); ++i) {
+        State s = g_state_registry->lookup_state(open_states[i]);
+        SearchNode node = search_space.get_node(s);
+        if (heuristics.size() == 1) {
+            heuristics[0]->set_evaluator_value(node.get_h());
+        } else {
+            for (size_t j = 0; j < heuristics.size(); ++j)
+                heuristics[j]->evaluate(s);
+            search_progress.inc_evaluations(heuristics.size());
+        }
+        open_list->evaluate(node.get_g(), false);
+        open_list->insert(open_states[i]);
+    }
+    cout << "Rebuilt open list from " << entries.size() << " to "
+         << open_states.size() << " entries." << endl;
+}
+
+void EagerSearch::evaluate_new_successors(const vector<State> &successors) {
+    /*
+      Evaluates all successors that are new with one evaluate_batch call
+      per heuristic. Successors reached by several operators share their
+      slot, so every state is evaluated once, as in the one-by-one loop.
+      Heuristics that depend on the reached path get no batch values, as
+      reach_state has not seen the successors yet; step evaluates them
+      one by one.
+    */
+    batch_states.clear();
+    batch_slot.assign(successors.size(), -1);
+    if (slot_of_state.size() < g_state_registry->size())
+        slot_of_state.resize(g_state_registry->size(), -1);
+    for (size_t i = 0; i < successors.size(); ++i) {
+        const State &succ_state = successors[i];
+        if (!search_space.get_node(succ_state).is_new())
+            continue;
+        int &slot = slot_of_state[succ_state.get_id().hash()];
+        if (slot == -1) {
+            slot = batch_states.size();
+            batch_states.push_back(succ_state);
+        }
+        batch_slot[i] = slot;
+    }
+    for (size_t i = 0; i < batch_states.size(); ++i)
+        slot_of_state[batch_states[i].get_id().hash()] = -1;
+    if (batch_states.empty())
+        return;
+    batch_values.resize(heuristics.size());
+    for (size_t j = 0; j < heuristics.size(); ++j) {
+        if (heuristics[j]->depends_on_reached_path()) {
+            batch_values[j].clear();
+            continue;
+        }
+        batch_values[j].resize(batch_states.size());
+        heuristics[j]->evaluate_batch(&batch_states[0], batch_states.size(),
+                                      &batch_values[j][0]);
+    }
 }
 
 int EagerSearch::step() {
+    if (memory_budget.check_due() && !check_memory_budget())
+        return FAILED;
+
     pair<SearchNode, bool> n = fetch_next_node();
     if (!n.second) {
         return FAILED;
@@ -128,13 +271,21 @@ int EagerSearch::step() {
     }
     search_progress.inc_evaluations(preferred_operator_heuristics.size());
 
+    vector<const Operator *> ops;
+    ops.reserve(applicable_ops.size());
     for (int i = 0; i < applicable_ops.size(); i++) {
         const Operator *op = applicable_ops[i];
-
-        if ((node.get_real_g() + op->get_cost()) >= bound)
-            continue;
-
-        State succ_state = g_state_registry->get_successor_state(s, *op);
+        if ((node.get_real_g() + op->get_cost()) < bound)
+            ops.push_back(op);
+    }
+    vector<State> successors;
+    successors.reserve(ops.size());
+    g_state_registry->get_successor_states(s, ops, successors);
+    evaluate_new_successors(successors);
+
+    for (int i = 0; i < ops.size(); i++) {
+        const Operator *op = ops[i];
+        const State &succ_state = successors[i];
         search_progress.inc_generated();
         bool is_preferred = (preferred_ops.find(op) != preferred_ops.end());
 
@@ -151,8 +302,8 @@ int EagerSearch::step() {
             continue;
 
         // update new path
+        bool h_is_dirty = false;
         if (use_multi_path_dependence || succ_node.is_new()) {
-            bool h_is_dirty = false;
             for (size_t i = 0; i < heuristics.size(); ++i) {
                 /*
                   Note that we can't break out of the loop when
@@ -169,9 +320,16 @@ int EagerSearch::step() {
 
         if (succ_node.is_new()) {
             // We have not seen this state before.
-            // Evaluate and create a new node.
-            for (size_t i = 0; i < heuristics.size(); i++)
-                heuristics[i]->evaluate(succ_state);
+            // Evaluate and create a new node. The batch values are
+            // stale if reach_state has changed the heuristic information
+            // of the state since.
+            int slot = batch_slot[i];
+            for (size_t j = 0; j < heuristics.size(); j++) {
+                if (slot != -1 && !h_is_dirty && !batch_values[j].empty())
+                    heuristics[j]->set_batch_result(batch_values[j][slot]);
+                else
+                    heuristics[j]->evaluate(succ_state);
+            }
             succ_node.clear_h_dirty();
             search_progress.inc_evaluated_states();
             search_progress.inc_evaluations(heuristics.size());
@@ -266,8 +424,10 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
         State s = g_state_registry->lookup_state(id);
         SearchNode node = search_space.get_node(s);
 
-        if (node.is_closed())
+        if (node.is_closed() || search_space.is_spilled_duplicate(node)) {
+            search_progress.inc_stale_entries();
             continue;
+        }
 
         if (use_multi_path_dependence) {
             assert(last_key_removed.size() == 2);
@@ -275,6 +435,7 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
             assert(node.get_h() >= pushed_h);
             if (node.get_h() > pushed_h) {
                 // cout << "LM-A* skip h" << endl;
+                search_progress.inc_stale_entries();
                 continue;
             }
             assert(node.get_h() == pushed_h);
@@ -342,6 +503,9 @@ static SearchEngine *_parse(OptionParser &parser) {
     //because for templated classes the usual method of registering
     //does not work:
     Plugin<OpenList<StateID> >::register_open_lists();
+    // The indexed open list only works for StateIDs.
+    Registry<OpenList<StateID> *>::instance()->register_object(
+        "indexed", IndexedOpenList::_parse);
 
     parser.document_synopsis("Eager best first search", "");
 
@@ -358,6 +522,8 @@ static SearchEngine *_parse(OptionParser &parser) {
     parser.add_list_option<Heuristic *>
         ("preferred",
         "use preferred operators of these heuristics", "[]");
+    MemoryBudget::add_options_to_parser(parser);
+    ExternalClosedList::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
@@ -394,8 +560,24 @@ static SearchEngine *_parse_astar(OptionParser &parser) {
                             "use pathmax correction", "false");
     parser.add_option<bool>("mpd",
                             "use multi-path dependence (LM-A*)", "false");
+    parser.add_option<bool>(
+        "buckets",
+        "use the two-level bucket open list fh_buckets instead of the "
+        "tie-breaking open list. Expands nodes in the same order, but "
+        "needs memory proportional to the largest f value.",
+        "false");
+    parser.add_option<bool>(
+        "indexed",
+        "use the indexed open list, which contains every state at most once "
+        "and updates the key of a state when it is reopened, instead of the "
+        "tie-breaking open list. Expands nodes in the same order.",
+        "false");
+    MemoryBudget::add_options_to_parser(parser);
+    ExternalClosedList::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
+    if (opts.get<bool>("buckets") && opts.get<bool>("indexed"))
+        parser.error("buckets and indexed cannot be used together");
 
     EagerSearch *engine = 0;
     if (!parser.dry_run()) {
@@ -410,8 +592,13 @@ static SearchEngine *_parse_astar(OptionParser &parser) {
         std::vector<ScalarEvaluator *> evals;
         evals.push_back(f_eval);
         evals.push_back(eval);
-        OpenList<StateID> *open = \
-            new TieBreakingOpenList<StateID>(evals, false, false);
+        OpenList<StateID> *open;
+        if (opts.get<bool>("buckets"))
+            open = new FHBucketOpenList<StateID>(f_eval, eval, false);
+        else if (opts.get<bool>("indexed"))
+            open = new IndexedOpenList(evals, false);
+        else
+            open = new TieBreakingOpenList<StateID>(evals, false, false);
 
         opts.set("open", open);
         opts.set("f_eval", f_eval);
@@ -469,6 +656,8 @@ static SearchEngine *_parse_greedy(OptionParser &parser) {
         "boost",
         "boost value for preferred operator open lists", "0");
 
+    MemoryBudget::add_options_to_parser(parser);
+    ExternalClosedList::add_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
 
 
@@ -9,6 +9,8 @@
 #include "state.h"
 #include "timer.h"
 #include "evaluator.h"
+#include "external_closed_list.h"
+#include "memory_budget.h"
 #include "search_progress.h"
 
 class Heuristic;
@@ -25,6 +27,24 @@ class EagerSearch : public SearchEngine {
     OpenList<StateID> *open_list;
     ScalarEvaluator *f_evaluator;
 
+    MemoryBudget memory_budget;
+    ExternalClosedList *external_closed_list;
+
+    MemoryUsage get_memory_usage() const;
+    bool check_memory_budget();
+    void prune_open_list(bool spill_closed_nodes);
+
+    // Values of the new successors of the current expansion, computed by
+    // evaluate_new_successors: batch_values[j][batch_slot[i]] is the value
+    // of heuristics[j] for successor i, if batch_slot[i] != -1 and
+    // batch_values[j] is not empty.
+    std::vector<State> batch_states;
+    std::vector<int> batch_slot;
+    std::vector<std::vector<int> > batch_values;
+    // Slot of each state in the current batch, -1 outside of it.
+    std::vector<int> slot_of_state;
+    void evaluate_new_successors(const std::vector<State> &successors);
+
 protected:
     int step();
     std::pair<SearchNode, bool> fetch_next_node();
@@ -43,6 +63,7 @@ protected:
 
 public:
     EagerSearch(const Options &opts);
+    ~EagerSearch();
     void statistics() const;
 
     void dump_search_space();
@@ -0,0 +1,335 @@
+#include "external_closed_list.h"
+
+#include "globals.h"
+#include "option_parser.h"
+#include "timer.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+using namespace std;
+
+static size_t compared_bytes = 0;
+
+static inline int compare_states(const state_var_t *lhs,
+                                 const state_var_t *rhs) {
+    return memcmp(lhs, rhs, compared_bytes);
+}
+
+struct SpillRecordLess {
+    bool operator()(const pair<const state_var_t *, int> &lhs,
+                    const pair<const state_var_t *, int> &rhs) const {
+        int cmp = compare_states(lhs.first, rhs.first);
+        if (cmp != 0)
+            return cmp < 0;
+        return lhs.second < rhs.second;
+    }
+};
+
+struct QueryLess {
+    const vector<const state_var_t *> &states;
+    explicit QueryLess(const vector<const state_var_t *> &states_)
+        : states(states_) {
+    }
+    bool operator()(int lhs, int rhs) const {
+        return compare_states(states[lhs], states[rhs]) < 0;
+    }
+};
+
+static FILE *open_file(const string &filename, const char *mode) {
+    FILE *file = fopen(filename.c_str(), mode);
+    if (!file) {
+        cerr << "error: could not open " << filename << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    return file;
+}
+
+ExternalClosedList::ExternalClosedList(const Options &opts)
+    : directory(opts.get<string>("spill_dir")),
+      max_runs(opts.get<int>("spill_max_runs")),
+      state_size(g_variable_domain.size() * sizeof(state_var_t)),
+      record_size(state_size + sizeof(int)),
+      num_files_created(0),
+      trace_file(0),
+      num_trace_entries(0),
+      spill_first_id(0),
+      cached_block_run(-1),
+      cached_block(0),
+      num_spilled_states(0),
+      num_batches(0),
+      num_checked_states(0),
+      num_duplicates(0),
+      num_blocks_read(0) {
+    if (max_runs < 1) {
+        cerr << "error: spill_max_runs must be at least 1" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    compared_bytes = state_size;
+    block.resize(INDEX_STRIDE * record_size);
+}
+
+ExternalClosedList::~ExternalClosedList() {
+    for (size_t i = 0; i < runs.size(); ++i)
+        fclose(runs[i].file);
+    if (trace_file)
+        fclose(trace_file);
+}
+
+FILE *ExternalClosedList::create_file(const string &extension,
+                                      string &filename) {
+    ostringstream name;
+    name << directory << "/closed-" << getpid() << "-"
+         << num_files_created++ << "." << extension;
+    filename = name.str();
+    FILE *file = open_file(filename, "w+b");
+    // The data stays accessible through the open file.
+    remove(filename.c_str());
+    return file;
+}
+
+void ExternalClosedList::begin_spill(int first_id, int num_ids) {
+    assert(spill_records.empty());
+    TraceEntry not_reached;
+    not_reached.op_index = NOT_REACHED;
+    not_reached.parent_process = -1;
+    not_reached.parent_id = -1;
+    spill_first_id = first_id;
+    spill_trace.assign(num_ids, not_reached);
+}
+
+void ExternalClosedList::add_state(int id, const state_var_t *buffer, int g,
+                                   bool closed, const TraceEntry &entry) {
+    assert(id >= spill_first_id && id - spill_first_id < spill_trace.size());
+    spill_trace[id - spill_first_id] = entry;
+    if (closed)
+        spill_records.push_back(make_pair(buffer, g));
+}
+
+void ExternalClosedList::write_run(Run &run, const state_var_t *key, int g) {
+    if (run.num_records % INDEX_STRIDE == 0)
+        run.index.insert(run.index.end(), key,
+                         key + g_variable_domain.size());
+    fwrite(key, 1, state_size, run.file);
+    fwrite(&g, sizeof(int), 1, run.file);
+    ++run.num_records;
+}
+
+void ExternalClosedList::finish_run(Run &run) {
+    if (fflush(run.file) != 0 || ferror(run.file)) {
+        cerr << "error: could not write " << run.filename << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+}
+
+void ExternalClosedList::end_spill() {
+    sort(spill_records.begin(), spill_records.end(), SpillRecordLess());
+
+    Run run;
+    run.file = create_file("run", run.filename);
+    run.num_records = 0;
+    for (size_t i = 0; i < spill_records.size(); ++i)
+        write_run(run, spill_records[i].first, spill_records[i].second);
+    finish_run(run);
+    runs.push_back(run);
+
+    // IDs are consecutive across spills, so the trace file only grows
+    // at the end.
+    if (!trace_file)
+        trace_file = create_file("trace", trace_filename);
+    assert(spill_first_id == num_trace_entries);
+    if (!spill_trace.empty() &&
+        (fseeko(trace_file, 0, SEEK_END) != 0 ||
+         fwrite(&spill_trace[0], sizeof(TraceEntry), spill_trace.size(),
+                trace_file) != spill_trace.size() ||
+         fflush(trace_file) != 0)) {
+        cerr << "error: could not write " << trace_filename << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    num_trace_entries += spill_trace.size();
+
+    num_spilled_states += spill_records.size();
+    cout << "Spilled " << spill_records.size() << " closed states to "
+         << run.filename << " [t=" << g_timer << "]" << endl;
+
+    // Release the memory, clear() would keep the capacity.
+    vector<pair<const state_var_t *, int> >().swap(spill_records);
+    vector<TraceEntry>().swap(spill_trace);
+
+    if (runs.size() > max_runs)
+        merge_runs();
+}
+
+void ExternalClosedList::merge_runs() {
+    // K-way merge of all runs. K is small, so we find the minimum linearly.
+    size_t num_runs = runs.size();
+    vector<FILE *> inputs(num_runs);
+    vector<vector<char> > heads(num_runs, vector<char>(record_size));
+    vector<size_t> remaining(num_runs);
+    for (size_t i = 0; i < num_runs; ++i) {
+        inputs[i] = runs[i].file;
+        remaining[i] = runs[i].num_records;
+        if (remaining[i] &&
+            (fseeko(inputs[i], 0, SEEK_SET) != 0 ||
+             fread(&heads[i][0], record_size, 1, inputs[i]) != 1)) {
+            cerr << "error: could not read " << runs[i].filename << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+
+    Run merged;
+    merged.file = create_file("run", merged.filename);
+    merged.num_records = 0;
+    while (true) {
+        int best = -1;
+        int best_g = 0;
+        for (size_t i = 0; i < num_runs; ++i) {
+            if (!remaining[i])
+                continue;
+            int g;
+            memcpy(&g, &heads[i][state_size], sizeof(int));
+            if (best != -1) {
+                int cmp = compare_states(
+                    reinterpret_cast<const state_var_t *>(&heads[i][0]),
+                    reinterpret_cast<const state_var_t *>(&heads[best][0]));
+                if (cmp > 0 || (cmp == 0 && g >= best_g))
+                    continue;
+            }
+            best = i;
+            best_g = g;
+        }
+        if (best == -1)
+            break;
+        write_run(merged,
+                  reinterpret_cast<const state_var_t *>(&heads[best][0]),
+                  best_g);
+        if (--remaining[best] &&
+            fread(&heads[best][0], record_size, 1, inputs[best]) != 1) {
+            cerr << "error: could not read " << runs[best].filename << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+    }
+    finish_run(merged);
+
+    for (size_t i = 0; i < num_runs; ++i)
+        fclose(inputs[i]);
+    runs.clear();
+    runs.push_back(merged);
+    cached_block_run = -1;
+    cout << "Merged " << num_runs << " runs into " << merged.filename
+         << " (" << merged.num_records << " records)" << endl;
+}
+
+const state_var_t *ExternalClosedList::read_record(const Run &run, int run_no,
+                                                   size_t pos, int &g) {
+    size_t block_no = pos / INDEX_STRIDE;
+    if (cached_block_run != run_no || cached_block != block_no) {
+        size_t first = block_no * INDEX_STRIDE;
+        size_t count = min(INDEX_STRIDE, run.num_records - first);
+        if (fseeko(run.file, off_t(first) * record_size, SEEK_SET) != 0 ||
+            fread(&block[0], record_size, count, run.file) != count) {
+            cerr << "error: could not read " << run.filename << endl;
+            exit_with(EXIT_CRITICAL_ERROR);
+        }
+        cached_block_run = run_no;
+        cached_block = block_no;
+        ++num_blocks_read;
+    }
+    const char *record = &block[(pos % INDEX_STRIDE) * record_size];
+    memcpy(&g, record + state_size, sizeof(int));
+    return reinterpret_cast<const state_var_t *>(record);
+}
+
+int ExternalClosedList::lookup_in_run(int run_no, const state_var_t *key) {
+    const Run &run = runs[run_no];
+    size_t num_vars = g_variable_domain.size();
+    // Find the first block starting with a key that is not smaller than
+    // the given key. The key can only occur in the block before it.
+    size_t lo = 0;
+    size_t hi = run.index.size() / num_vars;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (compare_states(&run.index[mid * num_vars], key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    size_t pos = lo == 0 ? 0 : (lo - 1) * INDEX_STRIDE;
+    for (; pos < run.num_records; ++pos) {
+        int g;
+        const state_var_t *record = read_record(run, run_no, pos, g);
+        int cmp = compare_states(record, key);
+        if (cmp == 0)
+            // Records with the same state are sorted by g.
+            return g;
+        else if (cmp > 0)
+            break;
+    }
+    return -1;
+}
+
+void ExternalClosedList::lookup(const vector<const state_var_t *> &states,
+                                vector<int> &spilled_g) {
+    spilled_g.assign(states.size(), -1);
+    if (states.empty())
+        return;
+    // Visiting the states in sorted order turns the lookups into a merge
+    // that reads every block of a run at most once.
+    vector<int> order(states.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    sort(order.begin(), order.end(), QueryLess(states));
+    for (size_t run_no = 0; run_no < runs.size(); ++run_no) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            int g = lookup_in_run(run_no, states[order[i]]);
+            int &best_g = spilled_g[order[i]];
+            if (g != -1 && (best_g == -1 || g < best_g))
+                best_g = g;
+        }
+    }
+    ++num_batches;
+    num_checked_states += states.size();
+    for (size_t i = 0; i < spilled_g.size(); ++i)
+        if (spilled_g[i] != -1)
+            ++num_duplicates;
+}
+
+ExternalClosedList::TraceEntry ExternalClosedList::get_trace_entry(
+    int id) const {
+    if (id < 0 || id >= num_trace_entries) {
+        cerr << "error: state " << id << " has not been spilled" << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    TraceEntry entry;
+    if (fseeko(trace_file, off_t(id) * sizeof(TraceEntry), SEEK_SET) != 0 ||
+        fread(&entry, sizeof(TraceEntry), 1, trace_file) != 1) {
+        cerr << "error: could not read " << trace_filename << endl;
+        exit_with(EXIT_CRITICAL_ERROR);
+    }
+    return entry;
+}
+
+void ExternalClosedList::print_statistics() const {
+    cout << "Spilled states: " << num_spilled_states << endl;
+    cout << "Spill run files: " << runs.size() << endl;
+    cout << "Spilled duplicate checks: " << num_checked_states << " states in "
+         << num_batches << " batches, " << num_duplicates << " duplicates, "
+         << num_blocks_read << " blocks read" << endl;
+}
+
+void ExternalClosedList::add_options_to_parser(OptionParser &parser) {
+    parser.add_option<string>(
+        "spill_dir",
+        "directory for the files of the external closed list "
+        "(memory_policy=SPILL)",
+        ".");
+    parser.add_option<int>(
+        "spill_max_runs",
+        "merge the run files of the external closed list once there are "
+        "more than this many",
+        "8");
+}
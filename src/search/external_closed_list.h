@@ -0,0 +1,123 @@
+#ifndef EXTERNAL_CLOSED_LIST_H
+#define EXTERNAL_CLOSED_LIST_H
+
+#include "state_var_t.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class OptionParser;
+class Options;
+
+/*
+  ExternalClosedList stores closed states that no longer fit into memory
+  on disk, following the idea of delayed duplicate detection (Korf, 2003).
+
+  Every spill writes a run file holding (state, g) records of all closed
+  states of the spill, sorted by the state data. Runs are used for
+  duplicate detection: states generated after a spill are checked in
+  batches by merging them (sorted the same way) against all runs. Only
+  every INDEX_STRIDE-th key of a run is kept in memory to find the blocks
+  that have to be read. Once there are more than max_runs runs, they are
+  merged into one.
+
+  In addition, one TraceEntry per state ID is appended to a trace file,
+  so that plans can be reconstructed with one read per step. IDs are
+  global: the states of the n-th registry are numbered after those of all
+  previously spilled registries, so the trace file is indexed by them.
+
+  All files are written sequentially and are removed right after they
+  have been created, so that they disappear when the planner exits.
+  The states themselves are handed over by SearchSpace::spill_closed_nodes.
+*/
+class ExternalClosedList {
+public:
+    struct TraceEntry {
+        // -1 for the initial state, NOT_REACHED for states without a node.
+        int op_index;
+        // Process that owns the parent (only used by distributed search).
+        int parent_process;
+        int parent_id;
+    };
+    static const int NOT_REACHED = -2;
+private:
+    static const size_t INDEX_STRIDE = 256;
+
+    struct Run {
+        std::string filename;
+        FILE *file;
+        size_t num_records;
+        // Key of the first record of every block of INDEX_STRIDE records.
+        std::vector<state_var_t> index;
+    };
+
+    std::string directory;
+    int max_runs;
+    size_t state_size;
+    size_t record_size;
+    int num_files_created;
+
+    std::vector<Run> runs;
+    std::string trace_filename;
+    FILE *trace_file;
+    int num_trace_entries;
+
+    // Data of the spill that is currently collected.
+    std::vector<std::pair<const state_var_t *, int> > spill_records;
+    std::vector<TraceEntry> spill_trace;
+    int spill_first_id;
+
+    std::vector<char> block;
+    int cached_block_run;
+    size_t cached_block;
+
+    // Statistics
+    size_t num_spilled_states;
+    size_t num_batches;
+    size_t num_checked_states;
+    size_t num_duplicates;
+    size_t num_blocks_read;
+
+    FILE *create_file(const std::string &extension, std::string &filename);
+    void write_run(Run &run, const state_var_t *key, int g);
+    void finish_run(Run &run);
+    void merge_runs();
+    const state_var_t *read_record(const Run &run, int run_no, size_t pos,
+                                   int &g);
+    int lookup_in_run(int run_no, const state_var_t *key);
+public:
+    explicit ExternalClosedList(const Options &opts);
+    ~ExternalClosedList();
+
+    bool is_empty() const {
+        return num_trace_entries == 0;
+    }
+
+    /*
+      A spill consists of a call to begin_spill, one call to add_state for
+      every state of the registry that has a search node and a call to
+      end_spill. The state data must stay valid until end_spill returns.
+      Only closed states are used for duplicate detection.
+    */
+    void begin_spill(int first_id, int num_ids);
+    void add_state(int id, const state_var_t *buffer, int g, bool closed,
+                   const TraceEntry &entry);
+    void end_spill();
+
+    /*
+      Sets spilled_g[i] to the smallest g value with which states[i] has
+      been spilled as closed state, or to -1 if it has not been spilled.
+    */
+    void lookup(const std::vector<const state_var_t *> &states,
+                std::vector<int> &spilled_g);
+
+    // Returns the trace entry of a spilled state ID.
+    TraceEntry get_trace_entry(int id) const;
+
+    void print_statistics() const;
+
+    static void add_options_to_parser(OptionParser &parser);
+};
+
+#endif
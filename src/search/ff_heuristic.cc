@@ -32,20 +32,26 @@ void FFHeuristic::initialize() {
 }
 
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (int i = 0; i < unary_op->precondition.size(); i++)
+    const State &state, int goal) {
+    Proposition &goal_prop = propositions[goal];
+    if (!goal_prop.marked) { // Only consider each subgoal once.
+        goal_prop.marked = true;
+        if (goal_prop.reached_by != -1) {
+            // We have not yet chained back to a start node.
+            const UnaryOperator &unary_op = unary_operators[goal_prop.reached_by];
+            const int *precondition = get_preconditions(unary_op);
+            for (int i = 0; i < unary_op.num_preconditions; i++)
                 mark_preferred_operators_and_relaxed_plan(
-                    state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
+                    state, precondition[i]);
+            int operator_no = unary_op.operator_no;
             if (operator_no != -1) {
                 // This is not an axiom.
-                relaxed_plan[operator_no] = true;
+                if (!relaxed_plan[operator_no]) {
+                    relaxed_plan[operator_no] = true;
+                    relaxed_plan_operators.push_back(operator_no);
+                }
 
-                if (unary_op->cost == unary_op->base_cost) {
+                if (unary_op.cost == unary_op.base_cost) {
                     // This test is implied by the next but cheaper,
                     // so we perform it to save work.
                     // If we had no 0-cost operators and axioms to worry
@@ -69,12 +75,12 @@ int FFHeuristic::compute_heuristic(const State &state) {
         mark_preferred_operators_and_relaxed_plan(state, goal_propositions[i]);
 
     int h_ff = 0;
-    for (int op_no = 0; op_no < relaxed_plan.size(); op_no++) {
-        if (relaxed_plan[op_no]) {
-            relaxed_plan[op_no] = false; // Clean up for next computation.
-            h_ff += get_adjusted_cost(g_operators[op_no]);
-        }
+    for (int i = 0; i < relaxed_plan_operators.size(); i++) {
+        int op_no = relaxed_plan_operators[i];
+        relaxed_plan[op_no] = false; // Clean up for next computation.
+        h_ff += get_adjusted_cost(g_operators[op_no]);
     }
+    relaxed_plan_operators.clear();
     return h_ff;
 }
 
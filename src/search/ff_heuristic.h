@@ -17,11 +17,14 @@
 
 class FFHeuristic : public AdditiveHeuristic {
     // Relaxed plans are represented as a set of operators implemented
-    // as a bit vector.
+    // as a bit vector. The operators of the current relaxed plan are
+    // also listed, so that it can be summed up and cleared without
+    // looking at all operators.
     typedef std::vector<bool> RelaxedPlan;
     RelaxedPlan relaxed_plan;
+    std::vector<int> relaxed_plan_operators;
     void mark_preferred_operators_and_relaxed_plan(
-        const State &state, Proposition *goal);
+        const State &state, int goal);
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
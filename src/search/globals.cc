@@ -1,7 +1,9 @@
 #include "globals.h"
 
 #include "axioms.h"
+#include "binary_task_file.h"
 #include "causal_graph.h"
+#include "compiled_operators.h"
 #include "domain_transition_graph.h"
 #include "heuristic.h"
 #include "legacy_causal_graph.h"
@@ -127,6 +129,15 @@ void read_metric(istream &in) {
     check_magic(in, "end_metric");
 }
 
+static void check_variable_range(int range) {
+    if (range > numeric_limits<state_var_t>::max()) {
+        cerr << "This should not have happened!" << endl;
+        cerr << "Are you using the downward script, or are you using "
+             << "downward-1 directly?" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+}
+
 void read_variables(istream &in) {
     int count;
     in >> count;
@@ -141,12 +152,7 @@ void read_variables(istream &in) {
         int range;
         in >> range;
         g_variable_domain.push_back(range);
-        if (range > numeric_limits<state_var_t>::max()) {
-            cerr << "This should not have happened!" << endl;
-            cerr << "Are you using the downward script, or are you using "
-                 << "downward-1 directly?" << endl;
-            exit_with(EXIT_INPUT_ERROR);
-        }
+        check_variable_range(range);
 
         in >> ws;
         vector<string> fact_names(range);
@@ -157,6 +163,8 @@ void read_variables(istream &in) {
     }
 }
 
+static void add_mutex_group(const vector<pair<int, int> > &invariant_group);
+
 void read_mutexes(istream &in) {
     g_inconsistent_facts.resize(g_variable_domain.size());
     for (size_t i = 0; i < g_variable_domain.size(); ++i)
@@ -165,12 +173,6 @@ void read_mutexes(istream &in) {
     int num_mutex_groups;
     in >> num_mutex_groups;
 
-    /* NOTE: Mutex groups can overlap, in which case the same mutex
-       should not be represented multiple times. The current
-       representation takes care of that automatically by using sets.
-       If we ever change this representation, this is something to be
-       aware of. */
-
     for (size_t i = 0; i < num_mutex_groups; ++i) {
       // printf("mutex_group %lu\n", i);
       // printf("##################################\n");
@@ -185,25 +187,34 @@ void read_mutexes(istream &in) {
             invariant_group.push_back(make_pair(var, val));
         }
         check_magic(in, "end_mutex_group");
-        for (size_t j = 0; j < invariant_group.size(); ++j) {
-            const pair<int, int> &fact1 = invariant_group[j];
-            int var1 = fact1.first, val1 = fact1.second;
-            for (size_t k = 0; k < invariant_group.size(); ++k) {
-                const pair<int, int> &fact2 = invariant_group[k];
-                int var2 = fact2.first;
-                if (var1 != var2) {
-                    /* The "different variable" test makes sure we
-                       don't mark a fact as mutex with itself
-                       (important for correctness) and don't include
-                       redundant mutexes (important to conserve
-                       memory). Note that the preprocessor removes
-                       mutex groups that contain *only* redundant
-                       mutexes, but it can of course generate mutex
-                       groups which lead to *some* redundant mutexes,
-                       where some but not all facts talk about the
-                       same variable. */
-                    g_inconsistent_facts[var1][val1].insert(fact2);
-                }
+        add_mutex_group(invariant_group);
+    }
+}
+
+static void add_mutex_group(const vector<pair<int, int> > &invariant_group) {
+    /* NOTE: Mutex groups can overlap, in which case the same mutex
+       should not be represented multiple times. The current
+       representation takes care of that automatically by using sets.
+       If we ever change this representation, this is something to be
+       aware of. */
+    for (size_t j = 0; j < invariant_group.size(); ++j) {
+        const pair<int, int> &fact1 = invariant_group[j];
+        int var1 = fact1.first, val1 = fact1.second;
+        for (size_t k = 0; k < invariant_group.size(); ++k) {
+            const pair<int, int> &fact2 = invariant_group[k];
+            int var2 = fact2.first;
+            if (var1 != var2) {
+                /* The "different variable" test makes sure we
+                   don't mark a fact as mutex with itself
+                   (important for correctness) and don't include
+                   redundant mutexes (important to conserve
+                   memory). Note that the preprocessor removes
+                   mutex groups that contain *only* redundant
+                   mutexes, but it can of course generate mutex
+                   groups which lead to *some* redundant mutexes,
+                   where some but not all facts talk about the
+                   same variable. */
+                g_inconsistent_facts[var1][val1].insert(fact2);
             }
         }
     }
@@ -263,6 +274,7 @@ void read_everything(istream &in) {
     read_goal(in);
     read_operators(in);
     read_axioms(in);
+    g_compiled_operators = new CompiledOperators(g_operators);
     check_magic(in, "begin_SG");
     g_successor_generator = read_successor_generator(in);
     check_magic(in, "end_SG");
@@ -278,6 +290,80 @@ void read_everything(istream &in) {
     g_state_registry = new StateRegistry;
 }
 
+void read_everything(BinaryTaskFile &in) {
+    in.check_section(BinaryTaskFile::METRIC);
+    g_use_metric = in.read_int() != 0;
+
+    in.check_section(BinaryTaskFile::VARIABLES);
+    int var_count = in.read_int();
+    for (int i = 0; i < var_count; i++) {
+        g_variable_name.push_back(in.read_string());
+        g_axiom_layers.push_back(in.read_int());
+        int range = in.read_int();
+        g_variable_domain.push_back(range);
+        check_variable_range(range);
+        vector<string> fact_names(range);
+        for (size_t j = 0; j < fact_names.size(); j++)
+            fact_names[j] = in.read_string();
+        g_fact_names.push_back(fact_names);
+    }
+
+    in.check_section(BinaryTaskFile::MUTEXES);
+    g_inconsistent_facts.resize(var_count);
+    for (size_t i = 0; i < var_count; ++i)
+        g_inconsistent_facts[i].resize(g_variable_domain[i]);
+    int num_mutex_groups = in.read_int();
+    for (int i = 0; i < num_mutex_groups; ++i) {
+        int num_facts = in.read_int();
+        const int *facts = in.read_ints(2 * num_facts);
+        vector<pair<int, int> > invariant_group;
+        invariant_group.reserve(num_facts);
+        for (int j = 0; j < num_facts; ++j)
+            invariant_group.push_back(make_pair(facts[2 * j], facts[2 * j + 1]));
+        add_mutex_group(invariant_group);
+    }
+
+    in.check_section(BinaryTaskFile::INITIAL_STATE);
+    const int *initial_values = in.read_ints(var_count);
+    g_initial_state_buffer = new state_var_t[var_count];
+    for (int i = 0; i < var_count; i++)
+        g_initial_state_buffer[i] = initial_values[i];
+    g_default_axiom_values.assign(g_initial_state_buffer,
+                                  g_initial_state_buffer + var_count);
+
+    in.check_section(BinaryTaskFile::GOAL);
+    int goal_count = in.read_int();
+    const int *goal_facts = in.read_ints(2 * goal_count);
+    for (int i = 0; i < goal_count; i++)
+        g_goal.push_back(make_pair(goal_facts[2 * i], goal_facts[2 * i + 1]));
+
+    in.check_section(BinaryTaskFile::OPERATORS);
+    int op_count = in.read_int();
+    g_operators.reserve(op_count);
+    for (int i = 0; i < op_count; i++)
+        g_operators.push_back(Operator(in, false));
+
+    in.check_section(BinaryTaskFile::AXIOMS);
+    int axiom_count = in.read_int();
+    g_axioms.reserve(axiom_count);
+    for (int i = 0; i < axiom_count; i++)
+        g_axioms.push_back(Operator(in, true));
+    g_axiom_evaluator = new AxiomEvaluator;
+    g_compiled_operators = new CompiledOperators(g_operators);
+
+    in.check_section(BinaryTaskFile::SUCCESSOR_GENERATOR);
+    g_successor_generator = new SuccessorGenerator(in);
+    in.check_section(BinaryTaskFile::TRANSITION_GRAPHS);
+    DomainTransitionGraph::read_all(in);
+    in.check_section(BinaryTaskFile::CAUSAL_GRAPH);
+    g_legacy_causal_graph = new LegacyCausalGraph(in);
+    in.check_section(BinaryTaskFile::END);
+
+    // As in read_everything for text files, these must be built last.
+    g_causal_graph = new CausalGraph;
+    g_state_registry = new StateRegistry;
+}
+
 void dump_everything() {
     cout << "Use metric? " << g_use_metric << endl;
     cout << "Min Action Cost: " << g_min_action_cost << endl;
@@ -355,6 +441,7 @@ vector<pair<int, int> > g_goal;
 vector<Operator> g_operators;
 vector<Operator> g_axioms;
 AxiomEvaluator *g_axiom_evaluator;
+CompiledOperators *g_compiled_operators;
 SuccessorGenerator *g_successor_generator;
 vector<DomainTransitionGraph *> g_transition_graphs;
 CausalGraph *g_causal_graph;
@@ -362,5 +449,6 @@ LegacyCausalGraph *g_legacy_causal_graph;
 
 Timer g_timer;
 string g_plan_filename = "sas_plan";
+int g_memory_limit_in_mb = 0;
 RandomNumberGenerator g_rng(2011); // Use an arbitrary default seed.
 StateRegistry *g_state_registry = 0;
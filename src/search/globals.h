@@ -10,7 +10,9 @@
 
 class Axiom;
 class AxiomEvaluator;
+class BinaryTaskFile;
 class CausalGraph;
+class CompiledOperators;
 class DomainTransitionGraph;
 class LegacyCausalGraph;
 class Operator;
@@ -26,6 +28,7 @@ void save_plan(const std::vector<const Operator *> &plan, int iter);
 int calculate_plan_cost(const std::vector<const Operator *> &plan);
 
 void read_everything(std::istream &in);
+void read_everything(BinaryTaskFile &in);
 void dump_everything();
 
 void verify_no_axioms_no_cond_effects();
@@ -58,6 +61,7 @@ extern std::vector<std::pair<int, int> > g_goal;
 extern std::vector<Operator> g_operators;
 extern std::vector<Operator> g_axioms;
 extern AxiomEvaluator *g_axiom_evaluator;
+extern CompiledOperators *g_compiled_operators;
 extern SuccessorGenerator *g_successor_generator;
 extern std::vector<DomainTransitionGraph *> g_transition_graphs;
 extern CausalGraph *g_causal_graph;
@@ -67,6 +71,8 @@ extern LegacyCausalGraph *g_legacy_causal_graph;
 
 extern Timer g_timer;
 extern std::string g_plan_filename;
+// Memory limit in MB given with --memory-limit (0 = no limit).
+extern int g_memory_limit_in_mb;
 extern RandomNumberGenerator g_rng;
 // Only one global object for now. Could later be changed to use one instance
 // for each problem in this case the method State::get_id would also have to be
@@ -5,6 +5,9 @@
 #include "plugin.h"
 #include "state.h"
 
+#include <algorithm>
+using namespace std;
+
 
 
 
@@ -29,6 +32,16 @@ int GoalCountHeuristic::compute_heuristic(const State &state) {
     return unsatisfied_goal_count;
 }
 
+void GoalCountHeuristic::compute_heuristic_batch(const State *states, int n,
+                                                 int *out) {
+    fill(out, out + n, 0);
+    for (int i = 0; i < g_goal.size(); i++) {
+        int var = g_goal[i].first, value = g_goal[i].second;
+        for (int j = 0; j < n; j++)
+            out[j] += (states[j][var] != value);
+    }
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Goal count heuristic", "");
     parser.document_language_support("action costs", "ignored by design");
@@ -7,6 +7,8 @@ class GoalCountHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual void compute_heuristic_batch(const State *states, int n,
+                                         int *out);
 public:
     GoalCountHeuristic(const Options &options);
     ~GoalCountHeuristic();
@@ -73,6 +73,12 @@ unsigned int AutoSelectionHash::hash_incremental(const State& state,
 		const unsigned int parent_d_hash, const Operator* op) {
 	return selected_hash->hash_incremental(state, parent_d_hash, op);
 }
+unsigned int AutoSelectionHash::hash_successor(const State& state,
+		const unsigned int parent_d_hash, const Operator* op,
+		const State& successor, const std::vector<int>& changed_vars) {
+	return selected_hash->hash_successor(state, parent_d_hash, op, successor,
+			changed_vars);
+}
 
 // TODO: not sure what to print
 std::string AutoSelectionHash::hash_name() {
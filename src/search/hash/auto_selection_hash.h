@@ -27,6 +27,9 @@ public:
 	unsigned int hash(const state_var_t* state);
 	unsigned int hash_incremental(const State& state,
 			const unsigned int parent_d_hash, const Operator* op);
+	unsigned int hash_successor(const State& state,
+			const unsigned int parent_d_hash, const Operator* op,
+			const State& successor, const std::vector<int>& changed_vars);
 	std::string hash_name();
 private:
 //	void rewrite_option();
@@ -10,6 +10,7 @@
 #include "../operator.h"
 #include "../domain_transition_graph.h"
 #include "../successor_generator.h"
+#include "../state_registry.h"
 
 #include <stdio.h>
 #include <string>
@@ -80,6 +81,20 @@ unsigned int MapBasedHash::hash(const state_var_t* state) {
 	return r;
 }
 
+unsigned int MapBasedHash::hash_successor(const State& parent,
+		const unsigned int parent_d_hash, const Operator* op,
+		const State& successor, const std::vector<int>& changed_vars) {
+	if (isPolynomial) {
+		return hash(successor);
+	}
+	unsigned int ret = parent_d_hash;
+	for (size_t i = 0; i < changed_vars.size(); ++i) {
+		int var = changed_vars[i];
+		ret = ret ^ map[var][successor[var]] ^ map[var][parent[var]];
+	}
+	return ret;
+}
+
 // TODO: not sure this is actually saving up time, or just messing up things.
 // we CANNOT precompute inc_hash for each operator as we are not sure
 // whether each effect CHANGES the state or not.
@@ -703,6 +718,41 @@ std::string ActionBasedStructuredZobristHash::hash_name() {
 	return str;
 }
 
+StateHash::StateHash(const Options &opts) :
+		DistributionHash(opts) {
+}
+
+unsigned int StateHash::fold(size_t hash) {
+	unsigned long long h = hash;
+	return (unsigned int) (h ^ (h >> 32));
+}
+
+unsigned int StateHash::hash(const State& state) {
+	return fold(g_state_registry->get_state_hash(state));
+}
+
+unsigned int StateHash::hash(const state_var_t* state) {
+	return fold(StateRegistry::compute_hash(state));
+}
+
+unsigned int StateHash::hash_incremental(const State& state,
+		const unsigned int parent_d_hash, const Operator* op) {
+	return fold(g_state_registry->get_successor_hash(state, *op));
+}
+
+unsigned int StateHash::hash_successor(const State& state,
+		const unsigned int parent_d_hash, const Operator* op,
+		const State& successor, const std::vector<int>& changed_vars) {
+	return fold(StateRegistry::update_hash(
+			g_state_registry->get_state_hash(state), state.get_raw_data(),
+			successor.get_raw_data(), changed_vars.data(),
+			changed_vars.size()));
+}
+
+std::string StateHash::hash_name() {
+	return "state_hash";
+}
+
 static DistributionHash*_parse_zobrist(OptionParser &parser) {
 	parser.document_synopsis("Zobrist Hash", "Distribution hash for HDA*");
 
@@ -780,7 +830,20 @@ static DistributionHash*_parse_action_structured_zobrist(OptionParser &parser) {
 	else
 		return new ActionBasedStructuredZobristHash(opts);
 }
+static DistributionHash*_parse_state_hash(OptionParser &parser) {
+	parser.document_synopsis("StateHash",
+			"Distribution hash for HDA* that reuses the hashes stored in "
+					"the state registry");
+	Options opts = parser.parse();
+	if (parser.dry_run())
+		return 0;
+	else
+		return new StateHash(opts);
+}
+
 static Plugin<DistributionHash> _plugin_zobrist("zobrist", _parse_zobrist);
+static Plugin<DistributionHash> _plugin_state_hash("state_hash",
+		_parse_state_hash);
 static Plugin<DistributionHash> _plugin_abstraction("abstraction",
 		_parse_abstraction);
 static Plugin<DistributionHash> _plugin_adaptive_abstraction("aabstraction",
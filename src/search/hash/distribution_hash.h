@@ -31,6 +31,18 @@ public:
 	virtual unsigned int hash_incremental(const State& state,
 			const unsigned int parent_d_hash, const Operator* op) = 0;
 
+	/*
+	 Same as hash_incremental, for callers that have already applied op.
+	 successor is the result and changed_vars holds the variables op
+	 changed (see CompiledOperators::apply). Hashes that can use them
+	 override this to avoid going over the effects of op again.
+	 */
+	virtual unsigned int hash_successor(const State& state,
+			const unsigned int parent_d_hash, const Operator* op,
+			const State& successor, const std::vector<int>& changed_vars) {
+		return hash_incremental(state, parent_d_hash, op);
+	}
+
 	virtual std::string hash_name() = 0;
 
 protected:
@@ -50,6 +62,9 @@ public:
 	unsigned int hash(const state_var_t* state);
 	unsigned int hash_incremental(const State& state,
 			const unsigned int parent_d_hash, const Operator* op);
+	unsigned int hash_successor(const State& state,
+			const unsigned int parent_d_hash, const Operator* op,
+			const State& successor, const std::vector<int>& changed_vars);
 protected:
 	std::vector<int> reverse_iter_to_val(std::vector<int> in);
 	void divideIntoTwo(unsigned int var,
@@ -103,4 +118,24 @@ private:
 	double abstraction;
 };
 
+/*
+ Uses the hashes that the state registry stores with every state, so that
+ distributing a state does not need another pass over it. Like
+ ZobristHash, the hash of a successor is computed from the operator
+ effects.
+ */
+class StateHash: public DistributionHash {
+	static unsigned int fold(size_t hash);
+public:
+	StateHash(const Options &opts);
+	unsigned int hash(const State& state);
+	unsigned int hash(const state_var_t* state);
+	unsigned int hash_incremental(const State& state,
+			const unsigned int parent_d_hash, const Operator* op);
+	unsigned int hash_successor(const State& state,
+			const unsigned int parent_d_hash, const Operator* op,
+			const State& successor, const std::vector<int>& changed_vars);
+	std::string hash_name();
+};
+
 #endif /* ZOBRISTHASH_H_ */
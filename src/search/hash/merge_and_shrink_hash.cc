@@ -58,7 +58,7 @@ void MergeAndShrinkHash::dump_options() const {
         ABORT("Unknown merge strategy.");
     }
     cout << endl;
-    shrink_strategy->dump_options();
+    shrink_strategy->dump_options(cout);
     cout << "Label reduction: "
          << (use_label_reduction ? "enabled" : "disabled") << endl
          << "Expensive statistics: "
@@ -6,6 +6,7 @@
 #include "../plugin.h"
 
 #include <cassert>
+#include <iostream>
 #include <limits>
 #include <map>
 #include <vector>
@@ -26,8 +27,8 @@ string ShrinkClique::name() const {
 	return "f-preserving";
 }
 
-void ShrinkClique::dump_strategy_specific_options() const {
-	cout << "Prefer shrinking high or low f states: "
+void ShrinkClique::dump_strategy_specific_options(ostream &out) const {
+	out << "Prefer shrinking high or low f states: "
 			<< (f_start == HIGH ? "high" : "low") << endl
 			<< "Prefer shrinking high or low h states: "
 			<< (h_start == HIGH ? "high" : "low") << endl;
@@ -7,12 +7,18 @@
 #include "g_evaluator.h"
 #include "sum_evaluator.h"
 #include "plugin.h"
+#include "open_lists/indexed_open_list.h"
 #include "per_state_information.h"
+#include "checkpoint.h"
+#include "state_registry.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <set>
 #include <climits>
+#include <sstream>
+#include <dirent.h>
 
 #include <mpi.h>
 using namespace std;
@@ -30,12 +36,18 @@ using namespace std;
 #define MPI_MSG_P_INCM 4
 #define MPI_MSG_PLAN 5 // plan construction
 #define MPI_MSG_PLAN_TERM 6 // plan construction
+#define MPI_MSG_CKPT 7 // sent by process 0 to start a checkpoint. message is its number.
+#define MPI_MSG_CKPT_MARKER 8 // see take_checkpoint
 HDAStarSearch::HDAStarSearch(const Options &opts) :
 		SearchEngine(opts), reopen_closed_nodes(
 				opts.get<bool>("reopen_closed")), do_pathmax(
 				opts.get<bool>("pathmax")), use_multi_path_dependence(
 				opts.get<bool>("mpd")), open_list(
-				opts.get<OpenList<StateID> *>("open")) {
+				opts.get<OpenList<StateID> *>("open")), memory_budget(opts), external_closed_list(
+				0), checkpoint_interval(opts.get<int>("checkpoint_interval")), checkpoint_dir(
+				opts.get<string>("checkpoint_dir")), restart(
+				opts.get<bool>("restart")), checkpoint_number(0), last_checkpoint_time(
+				0) {
 	if (opts.contains("f_eval")) {
 		f_evaluator = opts.get<ScalarEvaluator *>("f_eval");
 	} else {
@@ -78,12 +90,32 @@ HDAStarSearch::HDAStarSearch(const Options &opts) :
 		calc_pi = false;
 	}
 
+	if (memory_budget.get_policy() == MemoryBudget::SPILL) {
+		external_closed_list = new ExternalClosedList(opts);
+		search_space.set_external_closed_list(external_closed_list);
+	}
+
+	if (checkpoint_interval < 0) {
+		cerr << "error: checkpoint_interval must not be negative" << endl;
+		exit_with(EXIT_INPUT_ERROR);
+	}
+	if ((checkpoint_interval > 0 || restart) && external_closed_list) {
+		// The spilled states live in files that vanish with the process.
+		cerr << "error: checkpoints do not support memory_policy=SPILL"
+				<< endl;
+		exit_with(EXIT_UNSUPPORTED);
+	}
+
 	node_sent = 0;
 	msg_sent = 0;
 	term_msg_sent = 0;
 	termination_counter = 0;
 }
 
+HDAStarSearch::~HDAStarSearch() {
+	delete external_closed_list;
+}
+
 void HDAStarSearch::initialize() {
 
 	cout << "Conducting best first search"
@@ -120,8 +152,18 @@ void HDAStarSearch::initialize() {
 	}
 
 	assert(!heuristics.empty());
+	for (size_t i = 0; i < heuristics.size(); i++) {
+		// Successors are evaluated by whichever process generates them,
+		// and HDA* does not track what was reached on the path to them.
+		if (heuristics[i]->depends_on_reached_path()) {
+			cerr << "error: hdastar does not support heuristics that "
+					<< "depend on the reached path, such as lmcount" << endl;
+			exit_with(EXIT_UNSUPPORTED);
+		}
+	}
 
 	const State &initial_state = g_initial_state();
+	initial_state_id = search_space.get_global_id(initial_state.get_id());
 	for (size_t i = 0; i < heuristics.size(); i++)
 		heuristics[i]->evaluate(initial_state);
 	open_list->evaluate(0, false);
@@ -143,6 +185,8 @@ void HDAStarSearch::initialize() {
 	MPI_Comm_rank(MPI_COMM_WORLD, &id);
 	printf("%d/%d processes\n", id, world_size);
 	outgo_buffer.resize(world_size);
+	node_messages_sent.resize(world_size, 0);
+	node_messages_received.resize(world_size, 0);
 
 	n_vars = g_variable_domain.size(); // number of variables for a state. used to convert Node <-> bytes
 	s_var = sizeof(state_var_t); // = sizeof(state_var_t)
@@ -179,6 +223,7 @@ void HDAStarSearch::initialize() {
 	if (buffer_size > buffer_max) {
 		buffer_size = 400000000;
 	}
+	mpi_buffer_size = buffer_size;
 
 
 	mpi_buffer = new unsigned char[buffer_size];
@@ -189,7 +234,9 @@ void HDAStarSearch::initialize() {
 	unsigned int d_hash = hash->hash(initial_state);
 
 	// Put initial state into open_list ONLY for id == 0
-	if (id == (d_hash % world_size)) {
+	if (restart) {
+		read_checkpoint();
+	} else if (id == (d_hash % world_size)) {
 		if (open_list->is_dead_end()) {
 			cout << "Initial state is a dead end." << endl;
 		} else {
@@ -212,6 +259,8 @@ void HDAStarSearch::initialize() {
 		}
 	}
 
+	memory_budget.start();
+
 	MPI_Barrier (MPI_COMM_WORLD);
 
 	timer.reset();
@@ -228,6 +277,468 @@ void HDAStarSearch::statistics() const {
 	printf("Sent %u nodes.\n", node_sent);
 	printf("Sent %u messages.\n", msg_sent);
 	printf("Sent %u termination messages.\n", term_msg_sent);
+	memory_budget.print_statistics();
+	if (external_closed_list) {
+		external_closed_list->print_statistics();
+	}
+}
+
+/*
+ * Tells all other processes to stop and shuts down this process. Only the
+ * process that receives the plan in construct_plan holds it. If there is
+ * an incumbent, the others report the solution with an empty plan, so
+ * that every process exits with the same result.
+ */
+int HDAStarSearch::finish_search() {
+	for (int i = 0; i < world_size; ++i) {
+		if (i != id) {
+			MPI_Bsend(NULL, 0, MPI_BYTE, i, MPI_MSG_FTERM,
+					MPI_COMM_WORLD);
+		}
+	}
+
+	termination();
+	if (incumbent != INT_MAX) {
+		if (!found_solution()) {
+			set_plan(Plan());
+		}
+		return SOLVED;
+	} else {
+		return FAILED;
+	}
+}
+
+MemoryUsage HDAStarSearch::get_memory_usage() const {
+	MemoryUsage usage;
+	usage.state_registry = g_state_registry->get_memory_usage();
+	usage.per_state_information =
+			g_state_registry->get_per_state_information_memory_usage();
+	usage.open_list = open_list->get_memory_usage();
+	usage.message_buffers = mpi_buffer_size;
+	for (int i = 0; i < world_size; ++i) {
+		usage.message_buffers += outgo_buffer[i].capacity();
+	}
+	return usage;
+}
+
+/*
+ * Returns false if the search has to stop, either because this process is
+ * out of memory or because another process has stopped the search.
+ */
+bool HDAStarSearch::check_memory_budget() {
+	int has_received = 0;
+	MPI_Iprobe(MPI_ANY_SOURCE, MPI_MSG_FTERM, MPI_COMM_WORLD, &has_received,
+			MPI_STATUS_IGNORE);
+	if (has_received) {
+		printf("%d received fterm\n", id);
+		return false;
+	}
+
+	MemoryUsage usage = get_memory_usage();
+	if (!memory_budget.is_exceeded(usage)) {
+		return true;
+	}
+	cout << id << ": memory usage is close to the limit: ";
+	usage.dump(cout);
+	cout << " [t=" << g_timer << "]" << endl;
+	if (memory_budget.get_policy() != MemoryBudget::STOP) {
+		bool spill = memory_budget.get_policy() == MemoryBudget::SPILL;
+		if (!spill) {
+			memory_budget.start_pruning();
+		}
+		prune_open_list(spill);
+		usage = get_memory_usage();
+		cout << id
+				<< (spill ?
+						": after spilling closed states: " :
+						": after pruning the open list: ");
+		usage.dump(cout);
+		cout << endl;
+		if (!memory_budget.is_exceeded(usage)) {
+			return true;
+		}
+	}
+	printf("%d stops the search because of the memory limit.\n", id);
+	// The caller lets the other processes know through FTERM.
+	return false;
+}
+
+/*
+ * Rebuilds the open list with at most one entry per open state, dropping
+ * closed states and states whose f-value reaches the incumbent.
+ * If spill_closed_nodes is set, the closed nodes are moved to the external
+ * closed list in between, which gives the open states new IDs.
+ */
+void HDAStarSearch::prune_open_list(bool spill_closed_nodes) {
+	vector<StateID> entries;
+	while (!open_list->empty()) {
+		entries.push_back(open_list->remove_min(0));
+	}
+	open_list->clear();
+
+	vector<StateID> open_states;
+	vector<bool> reinserted(g_state_registry->size(), false);
+	for (size_t i = 0; i < entries.size(); ++i) {
+		StateID state_id = entries[i];
+		if (reinserted[state_id.hash()]) {
+			continue;
+		}
+		State s = g_state_registry->lookup_state(state_id);
+		SearchNode node = search_space.get_node(s);
+		if (!node.is_open() || node.get_g() + node.get_h() >= incumbent) {
+			continue;
+		}
+		reinserted[state_id.hash()] = true;
+		open_states.push_back(state_id);
+	}
+
+	if (spill_closed_nodes) {
+		vector<StateID> moved_states;
+		StateRegistry *old_registry = search_space.spill_closed_nodes(
+				open_states, moved_states, &parent_node_process_id);
+		for (size_t i = 0; i < open_states.size(); ++i) {
+			State old_state = old_registry->lookup_state(open_states[i]);
+			State new_state = g_state_registry->lookup_state(moved_states[i]);
+			distribution_hash_value[new_state] =
+					distribution_hash_value[old_state];
+			parent_node_process_id[new_state] =
+					parent_node_process_id[old_state];
+		}
+		delete old_registry;
+		open_states.swap(moved_states);
+	}
+
+	for (size_t i = 0; i < open_states.size(); ++i) {
+		SearchNode node = search_space.get_node(
+				g_state_registry->lookup_state(open_states[i]));
+		heuristics[0]->set_evaluator_value(node.get_h());
+		open_list->evaluate(node.get_g(), false);
+		open_list->insert(open_states[i]);
+	}
+	printf("%d: rebuilt open list from %lu to %lu entries.\n", id,
+			entries.size(), open_states.size());
+}
+
+/*
+ * While pruning, local successors are evaluated on the dummy state first so
+ * that states which cannot improve the incumbent are never registered. The
+ * value of heuristics[0] is stored in h, so that evaluate_new_successors
+ * does not compute it again; h is -1 if the successor was not evaluated
+ * (dead ends are pruned, so their value -1 is never stored).
+ */
+bool HDAStarSearch::is_pruned_by_incumbent(const State &succ,
+		const SearchNode &node, const Operator *op, int &h) {
+	h = -1;
+	if (!memory_budget.is_pruning() || incumbent == INT_MAX) {
+		return false;
+	}
+	int g = node.get_g() + get_adjusted_cost(*op);
+	heuristics[0]->evaluate_batch(&succ, 1, &h);
+	if (h < 0) { // dead end
+		return true;
+	}
+	return g + h >= incumbent;
+}
+
+/*
+ * Process 0 starts a checkpoint every checkpoint_interval seconds by sending
+ * MPI_MSG_CKPT to all other processes, which join it as soon as they see
+ * the message. Returns false if the search has to stop because another
+ * process has stopped it in the meantime.
+ */
+bool HDAStarSearch::check_checkpoint() {
+	if (id == 0) {
+		if (timer() - last_checkpoint_time < checkpoint_interval) {
+			return true;
+		}
+		int number = checkpoint_number + 1;
+		for (int i = 1; i < world_size; ++i) {
+			MPI_Bsend(&number, 1, MPI_INT, i, MPI_MSG_CKPT, MPI_COMM_WORLD);
+		}
+		return take_checkpoint(number);
+	}
+
+	int has_received = 0;
+	MPI_Iprobe(0, MPI_MSG_CKPT, MPI_COMM_WORLD, &has_received,
+			MPI_STATUS_IGNORE);
+	if (!has_received) {
+		return true;
+	}
+	int number = 0;
+	MPI_Recv(&number, 1, MPI_INT, 0, MPI_MSG_CKPT, MPI_COMM_WORLD,
+			MPI_STATUS_IGNORE);
+	return take_checkpoint(number);
+}
+
+/*
+ * Takes a consistent cut of the distributed search. After flushing its
+ * outgo buffers, every process sends a marker to every process (itself
+ * included) with the number of node messages it has sent to it so far and
+ * its incumbent. A process then keeps receiving node messages until it has
+ * received as many from every process as their markers announce. At that
+ * point no node is in flight and the incumbent is the same everywhere, so
+ * the open lists and closed lists of all processes form a consistent state
+ * of the whole search, which is written to one file per process.
+ *
+ * Every checkpoint is a new generation of files. A process only sends its
+ * marker after it has written the previous checkpoint, so once all markers
+ * are in, the previous generation is complete on every process and older
+ * ones can be removed. A process killed at any point thus leaves at least
+ * one generation that all processes have written (see read_checkpoint).
+ */
+bool HDAStarSearch::take_checkpoint(int number) {
+	flush_outgo_buffers(0);
+	for (int i = 0; i < world_size; ++i) {
+		int marker[3];
+		marker[0] = number;
+		marker[1] = node_messages_sent[i];
+		marker[2] = incumbent;
+		MPI_Bsend(marker, 3, MPI_INT, i, MPI_MSG_CKPT_MARKER, MPI_COMM_WORLD);
+	}
+
+	vector<bool> has_marker(world_size, false);
+	vector<unsigned int> announced(world_size, 0);
+	int missing_markers = world_size;
+	while (true) {
+		int has_received = 0;
+		MPI_Iprobe(MPI_ANY_SOURCE, MPI_MSG_FTERM, MPI_COMM_WORLD,
+				&has_received, MPI_STATUS_IGNORE);
+		if (has_received) {
+			printf("%d received fterm during checkpoint %d\n", id, number);
+			return false;
+		}
+
+		// Markers of the same process arrive in order, so we must not
+		// receive a second one before this checkpoint is complete.
+		for (int i = 0; i < world_size; ++i) {
+			if (has_marker[i]) {
+				continue;
+			}
+			has_received = 0;
+			MPI_Iprobe(i, MPI_MSG_CKPT_MARKER, MPI_COMM_WORLD, &has_received,
+					MPI_STATUS_IGNORE);
+			if (has_received) {
+				int marker[3];
+				MPI_Recv(marker, 3, MPI_INT, i, MPI_MSG_CKPT_MARKER,
+						MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+				assert(marker[0] == number);
+				announced[i] = marker[1];
+				if (marker[2] < incumbent) {
+					incumbent = marker[2];
+				}
+				has_marker[i] = true;
+				--missing_markers;
+			}
+		}
+
+		receive_nodes_from_queue();
+
+		if (missing_markers == 0) {
+			bool is_complete = true;
+			for (int i = 0; i < world_size; ++i) {
+				if (node_messages_received[i] != announced[i]) {
+					is_complete = false;
+				}
+			}
+			if (is_complete) {
+				break;
+			}
+		}
+	}
+
+	remove_checkpoints_outside(number - 1, number);
+	write_checkpoint(number);
+	checkpoint_number = number;
+	last_checkpoint_time = timer();
+	return true;
+}
+
+string HDAStarSearch::get_checkpoint_filename(int number) const {
+	ostringstream filename;
+	filename << checkpoint_dir << "/hdastar-" << id << "." << number
+			<< ".ckpt";
+	return filename.str();
+}
+
+/*
+ * Returns the numbers of the checkpoints of this process in checkpoint_dir.
+ * Files of interrupted writes (*.ckpt.tmp) do not count.
+ */
+vector<int> HDAStarSearch::find_checkpoints() const {
+	vector<int> numbers;
+	DIR *dir = opendir(checkpoint_dir.c_str());
+	if (!dir) {
+		return numbers;
+	}
+	while (dirent *entry = readdir(dir)) {
+		int file_id = -1;
+		int number = -1;
+		int length = 0;
+		if (sscanf(entry->d_name, "hdastar-%d.%d.ckpt%n", &file_id, &number,
+				&length) == 2 && length > 0 && entry->d_name[length] == '\0'
+				&& file_id == id && number >= 0) {
+			numbers.push_back(number);
+		}
+	}
+	closedir(dir);
+	return numbers;
+}
+
+void HDAStarSearch::remove_checkpoints_outside(int first, int last) {
+	vector<int> numbers = find_checkpoints();
+	for (size_t i = 0; i < numbers.size(); ++i) {
+		if (numbers[i] < first || numbers[i] > last) {
+			remove(get_checkpoint_filename(numbers[i]).c_str());
+		}
+	}
+}
+
+static const unsigned int CHECKPOINT_MAGIC = 0x48444131; // "HDA1"
+
+/*
+ * Layout: header, states of the registry (StateRegistry::write_checkpoint),
+ * search node infos (SearchSpace::write_checkpoint) and the HDA* information
+ * of every state. The open list is not written: after a checkpoint it
+ * contains exactly the open nodes (up to duplicates), so it is rebuilt
+ * from them.
+ */
+void HDAStarSearch::write_checkpoint(int number) {
+	WTimer write_timer;
+	CheckpointFile file(get_checkpoint_filename(number),
+			CheckpointFile::WRITE);
+	file.write(CHECKPOINT_MAGIC);
+	file.write(world_size);
+	file.write(id);
+	file.write(n_vars);
+	file.write(g_operators.size());
+	file.write(g_state_registry->get_state_hash(g_initial_state()));
+	file.write(number);
+	file.write(incumbent);
+	file.write(incumbent_goal_state);
+	file.write(node_sent);
+	file.write(msg_sent);
+
+	g_state_registry->write_checkpoint(file);
+	search_space.write_checkpoint(file);
+	for (PerStateInformation<unsigned int>::const_iterator it =
+			distribution_hash_value.begin(g_state_registry);
+			it != distribution_hash_value.end(g_state_registry); ++it) {
+		State s = g_state_registry->lookup_state(*it);
+		file.write(distribution_hash_value[s]);
+		file.write(parent_node_process_id[s]);
+	}
+	file.close();
+	printf("%d: wrote checkpoint %d with %lu states in %.2fs [t=%.2f]\n", id,
+			number, g_state_registry->size(), write_timer(), g_timer());
+}
+
+/*
+ * Restarts from the newest checkpoint that every process has written. The
+ * processes agree on it by repeatedly taking the minimum of the newest
+ * checkpoint each of them has below the last candidate. Newer files of
+ * this process belong to an interrupted checkpoint and are removed, so
+ * that they cannot be mistaken for the next checkpoint of this run.
+ */
+void HDAStarSearch::read_checkpoint() {
+	vector<int> numbers = find_checkpoints();
+	int number = INT_MAX;
+	while (true) {
+		int newest = -1;
+		for (size_t i = 0; i < numbers.size(); ++i) {
+			if (numbers[i] < number && numbers[i] > newest) {
+				newest = numbers[i];
+			}
+		}
+		MPI_Allreduce(&newest, &number, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+		if (number < 0) {
+			cerr << "error: " << checkpoint_dir << " contains no checkpoint "
+					<< "that all processes have written" << endl;
+			exit_with(EXIT_INPUT_ERROR);
+		}
+		int is_present = find(numbers.begin(), numbers.end(), number)
+				!= numbers.end();
+		MPI_Allreduce(MPI_IN_PLACE, &is_present, 1, MPI_INT, MPI_MIN,
+				MPI_COMM_WORLD);
+		if (is_present) {
+			break;
+		}
+	}
+	remove_checkpoints_outside(0, number);
+
+	string filename = get_checkpoint_filename(number);
+	CheckpointFile file(filename, CheckpointFile::READ);
+	unsigned int magic = 0;
+	int file_world_size = 0;
+	int file_id = 0;
+	unsigned int file_n_vars = 0;
+	size_t num_operators = 0;
+	size_t initial_state_hash = 0;
+	file.read(magic);
+	if (magic != CHECKPOINT_MAGIC) {
+		cerr << "error: " << filename << " is not a checkpoint file" << endl;
+		exit_with(EXIT_INPUT_ERROR);
+	}
+	file.read(file_world_size);
+	file.read(file_id);
+	file.read(file_n_vars);
+	file.read(num_operators);
+	file.read(initial_state_hash);
+	if (file_world_size != world_size || file_id != id) {
+		cerr << "error: " << filename << " was written by process " << file_id
+				<< " of " << file_world_size << " processes" << endl;
+		exit_with(EXIT_INPUT_ERROR);
+	}
+	if (file_n_vars != n_vars || num_operators != g_operators.size()
+			|| initial_state_hash
+					!= g_state_registry->get_state_hash(g_initial_state())) {
+		cerr << "error: " << filename << " does not belong to this task"
+				<< endl;
+		exit_with(EXIT_INPUT_ERROR);
+	}
+
+	int file_number = 0;
+	file.read(file_number);
+	if (file_number != number) {
+		cerr << "error: " << filename << " holds checkpoint " << file_number
+				<< endl;
+		exit_with(EXIT_INPUT_ERROR);
+	}
+	checkpoint_number = number;
+	file.read(incumbent);
+	file.read(incumbent_goal_state);
+	file.read(node_sent);
+	file.read(msg_sent);
+
+	g_state_registry->read_checkpoint(file);
+	search_space.read_checkpoint(file);
+	for (PerStateInformation<unsigned int>::const_iterator it =
+			distribution_hash_value.begin(g_state_registry);
+			it != distribution_hash_value.end(g_state_registry); ++it) {
+		State s = g_state_registry->lookup_state(*it);
+		file.read(distribution_hash_value[s]);
+		file.read(parent_node_process_id[s]);
+	}
+	file.close();
+
+	int num_open = 0;
+	for (PerStateInformation<unsigned int>::const_iterator it =
+			distribution_hash_value.begin(g_state_registry);
+			it != distribution_hash_value.end(g_state_registry); ++it) {
+		State s = g_state_registry->lookup_state(*it);
+		SearchNode node = search_space.get_node(s);
+		if (!node.is_open() || node.get_g() + node.get_h() >= incumbent) {
+			continue;
+		}
+		heuristics[0]->set_evaluator_value(node.get_h());
+		open_list->evaluate(node.get_g(), false);
+		open_list->insert(s.get_id());
+		++num_open;
+	}
+	printf("%d: restarted from checkpoint %d with %lu states, %d open\n", id,
+			number, g_state_registry->size(), num_open);
+	if (incumbent != INT_MAX) {
+		printf("id %d: incumbent = %d\n", id, incumbent);
+	}
 }
 
 int HDAStarSearch::step() {
@@ -244,6 +755,15 @@ int HDAStarSearch::step() {
 //	if (id == 0) {
 //		dbgprintf ("cc%d\n", 1);
 //	}
+	if (memory_budget.check_due() && !check_memory_budget()) {
+		return finish_search();
+	}
+	if (checkpoint_interval > 0 && !check_checkpoint()) {
+		// Another process has stopped the search during the checkpoint,
+		// which is abandoned. The previous checkpoint stays usable.
+		return finish_search();
+	}
+
 	receive_nodes_from_queue();
 //	if (id == 0) {
 //		dbgprintf ("cc%d\n", 2);
@@ -282,25 +802,7 @@ int HDAStarSearch::step() {
 //		has_sent_first_term = false;
 		if (termination_detection(has_sent_first_term)) {
 			printf("%d terminated\n", id);
-			Plan plan;
-			State s = n.first.get_state();
-//			search_space.trace_path(s, plan);
-			set_plan(plan); // TODO: this plan is ad hoc void plan.
-
-			for (int i = 0; i < world_size; ++i) {
-				if (i != id) {
-					MPI_Bsend(NULL, 0, MPI_BYTE, i, MPI_MSG_FTERM,
-							MPI_COMM_WORLD);
-				}
-			}
-
-			if (incumbent != INT_MAX) {
-				termination();
-				return SOLVED;
-			} else {
-				termination();
-				return FAILED;
-			}
+			return finish_search();
 		}
 //		if (id == 0) {
 //			printf("cc%d\n", 43);
@@ -344,13 +846,11 @@ int HDAStarSearch::step() {
 			// Each process owns the shortest path they found.
 			if (incumbent < incumbent_goal_state.second) {
 				incumbent_goal_state = std::pair<unsigned int, int>(
-						s.get_id().hash(), incumbent);
+						search_space.get_global_id(s.get_id()), incumbent);
 			}
 		}
-		Plan plan;
-//		search_space.trace_path(s, plan); // TODO: need to implement trace_path for HDA*
-		set_plan(plan); // TODO: this plan is ad hoc void plan.
-
+		// The plan is traced back across the processes when the search
+		// has finished (construct_plan).
 		return IN_PROGRESS;
 	}
 //	if (check_goal_and_set_plan(s)) {
@@ -399,6 +899,14 @@ int HDAStarSearch::step() {
 	///////////////////////////////
 	// Expand node
 	///////////////////////////////
+	vector<const Operator *> local_ops;
+	vector<unsigned int> local_d_hashes;
+	vector<int> local_h_values; // see is_pruned_by_incumbent
+	vector<const Operator *> sent_ops;
+	vector<unsigned int> sent_d_hashes;
+	vector<int> changed_vars;
+	sent_successor_data.clear();
+	unsigned int parent_d_hash = distribution_hash_value[s];
 	for (int i = 0; i < applicable_ops.size(); i++) {
 		if (calc_pi) {
 			calculate_pi();
@@ -409,8 +917,13 @@ int HDAStarSearch::step() {
 			continue;
 		}
 
-		unsigned int d_hash = hash->hash_incremental(s,
-				distribution_hash_value[s], op); // TODO: not sure about int <-> uint.
+		// The successor is built once here in the dummy state of the
+		// registry. It is used for the distribution hash, and for sending
+		// or pruning the node.
+		State &succ = g_state_registry->get_successor_state_by_dummy(s, *op,
+				&changed_vars);
+		unsigned int d_hash = hash->hash_successor(s, parent_d_hash, op, succ,
+				changed_vars); // TODO: not sure about int <-> uint.
 		unsigned int d_process = d_hash % world_size;
 
 //		printf("%u --expd-> %u\n", distribution_hash_value[s], d_hash);
@@ -420,137 +933,124 @@ int HDAStarSearch::step() {
 		if (self_send || (d_process != id)) {
 //			++node_sent;
 			// TODO: TODO: optimize self_send later.
-//		if (true) {
 			if (d_process != id) {
 				++node_sent;
 			}
-//			if (id == 0) {
-//				dbgprintf ("cc%d\n", 10);
-//			}
-
-			// TODO: this allocation is not efficient
-//			unsigned char* d = new unsigned char[node_size];
-			unsigned int size = outgo_buffer[d_process].size();
-			outgo_buffer[d_process].resize(size + node_size);
+			// The dummy state is overwritten by the next operator, so keep
+			// a copy until the sent successors are evaluated below.
+			sent_successor_data.insert(sent_successor_data.end(),
+					succ.get_raw_data(), succ.get_raw_data() + n_vars);
+			sent_ops.push_back(op);
+			sent_d_hashes.push_back(d_hash);
+		} else {
+			int h;
+			if (is_pruned_by_incumbent(succ, node, op, h)) {
+				continue;
+			}
+			// Local successors are registered in one batch below.
+			local_ops.push_back(op);
+			local_d_hashes.push_back(d_hash);
+			local_h_values.push_back(h);
+		}
+	}
 
-			unsigned char* p = outgo_buffer[d_process].data();
-			p += size;
-			// TODO: just put into outgo_buffer space rather than allocating d.
-//			if (id == 0) {
-//				dbgprintf ("cc%.1f\n", 10.1);
-//			}
-			if (generate_node_as_bytes(&node, op, p, d_hash)) {
-//				if (id == 0) {
-//					dbgprintf ("cc%.1f\n", 10.2);
-//				}
-//				unsigned int s = outgo_buffer[d_process].size();
-//				outgo_buffer[d_process].resize(s + node_size);
-//				std::copy(d, d + node_size, &(outgo_buffer[d_process][s]));
-			} else {
-//				if (id == 0) {
-//					dbgprintf ("cc%.1f\n", 10.3);
-//				}
+	send_successors(node, sent_ops, sent_d_hashes);
 
-				outgo_buffer[d_process].resize(size);
-				// the node is >= incumbent
-				// Throw away a node if its over incumbent!
-//				State succ_state = g_state_registry->get_successor_state(s,
-//						*op);
-//				search_progress.inc_generated();
-//				SearchNode succ_node = search_space.get_node(succ_state);
-//				if (succ_node.is_dead_end()) {
-//					continue;
-//				}
-			}
+	vector<State> local_successors;
+	local_successors.reserve(local_ops.size());
+	g_state_registry->get_successor_states(s, local_ops, local_successors);
+	evaluate_new_successors(local_successors, local_h_values);
 
-//			delete[] d;
-		} else {
-//			if (id == 0) {
-//				dbgprintf ("cc%d\n", 11);
-//			}
-			State succ_state = g_state_registry->get_successor_state(s, *op);
-//			search_progress.inc_generated();
-			bool is_preferred = (preferred_ops.find(op) != preferred_ops.end());
+	for (int i = 0; i < local_ops.size(); i++) {
+		const Operator *op = local_ops[i];
+		unsigned int d_hash = local_d_hashes[i];
+		const State &succ_state = local_successors[i];
+//		search_progress.inc_generated();
+		bool is_preferred = (preferred_ops.find(op) != preferred_ops.end());
 
-			SearchNode succ_node = search_space.get_node(succ_state);
+		SearchNode succ_node = search_space.get_node(succ_state);
 
-//			printf("metis %lu %lu %u\n", succ_state.get_id().hash() + 1,
-//					s.get_id().hash() + 1, op->get_cost());
+//		printf("metis %lu %lu %u\n", succ_state.get_id().hash() + 1,
+//				s.get_id().hash() + 1, op->get_cost());
 
-			if (metis) {
-				printf("ms %lu ", succ_state.get_id().hash() + 1);
-				succ_state.dump_raw();
-				printf("mh %lu %u\n", succ_state.get_id().hash() + 1, d_hash);
-				printf("m: %lu %lu\n", s.get_id().hash() + 1,
-						succ_state.get_id().hash() + 1); // op->get_cost(): edge cost has nothing to do
+		if (metis) {
+			printf("ms %lu ", succ_state.get_id().hash() + 1);
+			succ_state.dump_raw();
+			printf("mh %lu %u\n", succ_state.get_id().hash() + 1, d_hash);
+			printf("m: %lu %lu\n", s.get_id().hash() + 1,
+					succ_state.get_id().hash() + 1); // op->get_cost(): edge cost has nothing to do
+		}
+		// same as A*
+
+		if (succ_node.is_new()) {
+			// We have not seen this state before.
+			// Evaluate and create a new node.
+			int slot = batch_slot[i];
+			for (size_t j = 0; j < heuristics.size(); j++) {
+				if (slot != -1)
+					heuristics[j]->set_batch_result(batch_values[j][slot]);
+				else
+					heuristics[j]->evaluate(succ_state);
+			}
+			succ_node.clear_h_dirty();
+			search_progress.inc_evaluated_states();
+			search_progress.inc_evaluations(heuristics.size());
+
+			// Note that we cannot use succ_node.get_g() here as the
+			// node is not yet open. Furthermore, we cannot open it
+			// before having checked that we're not in a dead end. The
+			// division of responsibilities is a bit tricky here -- we
+			// may want to refactor this later.
+			open_list->evaluate(node.get_g() + get_adjusted_cost(*op),
+					is_preferred);
+			bool dead_end = open_list->is_dead_end();
+			if (dead_end) {
+				succ_node.mark_as_dead_end();
+				search_progress.inc_dead_ends();
+				continue;
 			}
-			// same as A*
-
-			if (succ_node.is_new()) {
-				// We have not seen this state before.
-				// Evaluate and create a new node.
-				for (size_t i = 0; i < heuristics.size(); i++)
-					heuristics[i]->evaluate(succ_state);
-				succ_node.clear_h_dirty();
-				search_progress.inc_evaluated_states();
-				search_progress.inc_evaluations(heuristics.size());
-
-				// Note that we cannot use succ_node.get_g() here as the
-				// node is not yet open. Furthermore, we cannot open it
-				// before having checked that we're not in a dead end. The
-				// division of responsibilities is a bit tricky here -- we
-				// may want to refactor this later.
-				open_list->evaluate(node.get_g() + get_adjusted_cost(*op),
-						is_preferred);
-				bool dead_end = open_list->is_dead_end();
-				if (dead_end) {
-					succ_node.mark_as_dead_end();
-					search_progress.inc_dead_ends();
-					continue;
-				}
 
-				int succ_h = heuristics[0]->get_value();
+			int succ_h = heuristics[0]->get_value();
 
-				succ_node.open(succ_h, node, op);
-				distribution_hash_value[succ_state] = d_hash;
-				parent_node_process_id[succ_state] = mpi_state_id(id,
-						s.get_id().hash());
+			succ_node.open(succ_h, node, op);
+			distribution_hash_value[succ_state] = d_hash;
+			parent_node_process_id[succ_state] = mpi_state_id(id,
+					search_space.get_global_id(s.get_id()));
 
-				open_list->insert(succ_state.get_id());
-				if (search_progress.check_h_progress(succ_node.get_g())) {
-					reward_progress();
-				}
+			open_list->insert(succ_state.get_id());
+			if (search_progress.check_h_progress(succ_node.get_g())) {
+				reward_progress();
+			}
 
-//				printf("\n");
-//				printf("\n");
-//				printf("PARENT: %lu\n", s.get_id().hash());
-//				s.dump_pddl();
-//				printf("\n");
-//				printf("CHILD: %lu\n", succ_state.get_id().hash());
-//				succ_state.dump_pddl();
+//			printf("\n");
+//			printf("\n");
+//			printf("PARENT: %lu\n", s.get_id().hash());
+//			s.dump_pddl();
+//			printf("\n");
+//			printf("CHILD: %lu\n", succ_state.get_id().hash());
+//			succ_state.dump_pddl();
 
-			} else if (succ_node.get_g()
-					> node.get_g() + get_adjusted_cost(*op)) {
-				// We found a new cheapest path to an open or closed state.
-				if (reopen_closed_nodes) {
+		} else if (succ_node.get_g()
+				> node.get_g() + get_adjusted_cost(*op)) {
+			// We found a new cheapest path to an open or closed state.
+			if (reopen_closed_nodes) {
 
-					// if we reopen closed nodes, do that
-					if (succ_node.is_closed()) {
-						search_progress.inc_reopened();
-					}
-					succ_node.reopen(node, op);
-					heuristics[0]->set_evaluator_value(succ_node.get_h());
+				// if we reopen closed nodes, do that
+				if (succ_node.is_closed()) {
+					search_progress.inc_reopened();
+				}
+				succ_node.reopen(node, op);
+				heuristics[0]->set_evaluator_value(succ_node.get_h());
 
-					open_list->evaluate(succ_node.get_g(), is_preferred);
+				open_list->evaluate(succ_node.get_g(), is_preferred);
 
-					open_list->insert(succ_state.get_id());
-				} else {
-					// hdastar always reopens closed nodes
-				}
+				open_list->insert(succ_state.get_id());
 			} else {
-				// pruned duplicate state
-//				printf("pruned\n");
+				// hdastar always reopens closed nodes
 			}
+		} else {
+			// pruned duplicate state
+//			printf("pruned\n");
 		}
 	}
 
@@ -599,8 +1099,10 @@ pair<SearchNode, bool> HDAStarSearch::fetch_next_node() {
 			return make_pair(dummy_node, false);
 		}
 
-		if (node.is_closed())
+		if (node.is_closed() || search_space.is_spilled_duplicate(node)) {
+			search_progress.inc_stale_entries();
 			continue;
+		}
 
 		node.close();
 		assert(!node.is_dead_end());
@@ -615,12 +1117,95 @@ pair<SearchNode, bool> HDAStarSearch::fetch_next_node() {
 // MPI related functions
 /////////////////////////////
 
+/*
+ * Evaluates all local successors that are new with one evaluate_batch call
+ * per heuristic. Successors reached by several operators share their slot.
+ * The values of heuristics[0] that are already known (h_values[i] != -1,
+ * see is_pruned_by_incumbent) are not computed again.
+ */
+void HDAStarSearch::evaluate_new_successors(const vector<State> &successors,
+		const vector<int> &h_values) {
+	batch_states.clear();
+	batch_known_h.clear();
+	batch_slot.assign(successors.size(), -1);
+	if (slot_of_state.size() < g_state_registry->size()) {
+		slot_of_state.resize(g_state_registry->size(), -1);
+	}
+	for (size_t i = 0; i < successors.size(); ++i) {
+		const State &succ_state = successors[i];
+		if (!search_space.get_node(succ_state).is_new()) {
+			continue;
+		}
+		int &slot = slot_of_state[succ_state.get_id().hash()];
+		if (slot == -1) {
+			slot = batch_states.size();
+			batch_states.push_back(succ_state);
+			batch_known_h.push_back(h_values[i]);
+		}
+		batch_slot[i] = slot;
+	}
+	for (size_t i = 0; i < batch_states.size(); ++i) {
+		slot_of_state[batch_states[i].get_id().hash()] = -1;
+	}
+	if (batch_states.empty()) {
+		return;
+	}
+	batch_values.resize(heuristics.size());
+	size_t first_heuristic = 0;
+	if (batch_known_h[0] != -1) {
+		// Either all or none of the values are known.
+		batch_values[0] = batch_known_h;
+		first_heuristic = 1;
+	}
+	for (size_t j = first_heuristic; j < heuristics.size(); ++j) {
+		batch_values[j].resize(batch_states.size());
+		heuristics[j]->evaluate_batch(&batch_states[0], batch_states.size(),
+				&batch_values[j][0]);
+	}
+}
+
+/*
+ * Evaluates the successors of node that are sent to other processes (their
+ * data is in sent_successor_data) with one evaluate_batch call, and writes
+ * those that can improve the incumbent to outgo_buffer in the order of ops.
+ * Only the value of heuristics[0] is sent, so the other heuristics are not
+ * evaluated.
+ */
+void HDAStarSearch::send_successors(SearchNode &node,
+		const vector<const Operator *> &ops,
+		const vector<unsigned int> &d_hashes) {
+	if (ops.empty()) {
+		return;
+	}
+	g_state_registry->get_unregistered_states(&sent_successor_data[0],
+			ops.size(), sent_successors);
+	sent_values.resize(ops.size());
+	heuristics[0]->evaluate_batch(&sent_successors[0], ops.size(),
+			&sent_values[0]);
+
+	for (int i = 0; i < ops.size(); i++) {
+		unsigned int d_process = d_hashes[i] % world_size;
+		unsigned int size = outgo_buffer[d_process].size();
+		outgo_buffer[d_process].resize(size + node_size);
+		unsigned char* p = outgo_buffer[d_process].data() + size;
+		if (!generate_node_as_bytes(&node, ops[i], sent_successors[i],
+				sent_values[i], p, d_hashes[i])) {
+			// the node is >= incumbent
+			// Throw away a node if its over incumbent!
+			outgo_buffer[d_process].resize(size);
+		}
+	}
+}
+
 /**
  * To send nodes via MPI we align them as a uchar vector for efficiency.
  * In this function we generate a node and cast as a uchar vector.
+ * s is the successor of parent_node under op, built by the caller, and h
+ * its heuristic value.
  */
 bool HDAStarSearch::generate_node_as_bytes(SearchNode* parent_node,
-		const Operator* op, unsigned char* d, unsigned int d_hash) {
+		const Operator* op, const State &s, int h, unsigned char* d,
+		unsigned int d_hash) {
 	////////////////////////////
 	// State
 	////////////////////////////
@@ -633,7 +1218,6 @@ bool HDAStarSearch::generate_node_as_bytes(SearchNode* parent_node,
 //		dbgprintf ("cc%.2f\n", 10.12);
 //	}
 
-	State s = g_state_registry->get_successor_state_by_dummy(parent_s, *op);
 
 //    printf("\n");
 //    printf("\n");
@@ -653,16 +1237,12 @@ bool HDAStarSearch::generate_node_as_bytes(SearchNode* parent_node,
 
 	// First check if its f value is over/equal incumbent.
 	int g = parent_node->get_g() + get_adjusted_action_cost(*op, cost_type);
-	for (size_t i = 0; i < heuristics.size(); i++) {
-		heuristics[i]->evaluate(s);
-	}
-	int h = heuristics[0]->get_value();
 	if (g + h >= incumbent) {
 //		g_state_registry->reset_dummy_state();
 		return false;
 	}
 	search_progress.inc_evaluated_states();
-	search_progress.inc_evaluations(heuristics.size());
+	search_progress.inc_evaluations();
 
 	// what we need for the state
 	// 1. state_var_t*: can implement
@@ -709,7 +1289,7 @@ bool HDAStarSearch::generate_node_as_bytes(SearchNode* parent_node,
 //	printf("pre = %d, post = %d\n", distribution_hash_value[parent_s], d_hash);
 
 //	typeToBytes(id, &(d[n_vars * s_var + 4 * sizeof(int)]));
-	int state_id = parent_s.get_id().hash();
+	int state_id = search_space.get_global_id(parent_s.get_id());
 
 //	typeToBytes(state_id, &(d[n_vars * s_var + 5 * sizeof(int)]));
 
@@ -771,6 +1351,7 @@ void HDAStarSearch::receive_nodes_from_queue() {
 		unsigned char *d = new unsigned char[d_size];
 		MPI_Recv(d, d_size, MPI_BYTE, source, MPI_MSG_NODE, MPI_COMM_WORLD,
 				MPI_STATUS_IGNORE);
+		++node_messages_received[source];
 
 //		std::vector<SearchNode> nodes;
 //		bytes_to_node(&nodes, d, d_size);
@@ -786,16 +1367,29 @@ void HDAStarSearch::receive_nodes_from_queue() {
 //	++income_counter;
 }
 
+/**
+ * The open list is always the one built in _parse_hdastar, which orders by
+ * [g + h, h]. We know g and h of every received node, so the keys are
+ * computed here and the whole message is inserted in one call instead of
+ * evaluating and inserting every node separately.
+ */
 void HDAStarSearch::bytes_to_nodes(unsigned char* d, unsigned int d_size) {
 	unsigned int n_nodes = d_size / node_size;
+	received_entries.clear();
+	received_keys.clear();
 	for (int i = 0; i < n_nodes; ++i) {
 		bytes_to_node(&(d[node_size * i]));
 	}
+	if (!received_entries.empty()) {
+		open_list->insert_batch(received_entries, received_keys);
+	}
 //	printf("%d recieved %d nodes\n", id, n_nodes);
 }
 
 StateID HDAStarSearch::bytes_to_node(unsigned char* d) {
-	state_var_t* vars = new state_var_t[n_vars];
+	// The registry copies the state, so the buffer can be reused.
+	received_state_buffer.resize(n_vars);
+	state_var_t* vars = &received_state_buffer[0];
 
 //	printf("income d: ");
 //	for (int i = 0; i < n_vars * s_var; ++i) {
@@ -870,12 +1464,11 @@ StateID HDAStarSearch::bytes_to_node(unsigned char* d) {
 		parent_node_process_id[succ_state] = mpi_state_id(parent_process_id,
 				parent_state_id);
 
-		heuristics[0]->set_evaluator_value(h);
 		succ_node.clear_h_dirty();
 
-		open_list->evaluate(g, false);
-		bool dead_end = open_list->is_dead_end();
-		if (dead_end) {
+		// The sender does not check for dead ends.
+		heuristics[0]->set_evaluator_value(h);
+		if (heuristics[0]->is_dead_end()) {
 			succ_node.mark_as_dead_end();
 			search_progress.inc_dead_ends();
 			return StateID::no_state;
@@ -885,7 +1478,9 @@ StateID HDAStarSearch::bytes_to_node(unsigned char* d) {
 
 //		succ_node.dump();
 
-		open_list->insert(succ_state.get_id());
+		received_entries.push_back(succ_state.get_id());
+		received_keys.push_back(g + h);
+		received_keys.push_back(h);
 
 		if (search_progress.check_h_progress(succ_node.get_g())) {
 			reward_progress();
@@ -899,11 +1494,9 @@ StateID HDAStarSearch::bytes_to_node(unsigned char* d) {
 		}
 		// TODO: need to reopen nodes
 		succ_node.reopen(g, h, op);
-		heuristics[0]->set_evaluator_value(h);
-		// TODO: this appears fishy to me. Why is here only heuristic[0]
-		// involved? Is this still feasible in the current version?
-		open_list->evaluate(g, false);
-		open_list->insert(succ_state.get_id());
+		received_entries.push_back(succ_state.get_id());
+		received_keys.push_back(g + h);
+		received_keys.push_back(h);
 //		printf("reopened\n");
 	} else {
 //		printf("pruned\n");
@@ -1074,6 +1667,7 @@ bool HDAStarSearch::flush_outgo_buffers(int f_threshold) {
 //				printf("send..");
 				MPI_Bsend(d, outgo_buffer[i].size(), MPI_BYTE, i, MPI_MSG_NODE,
 						MPI_COMM_WORLD);
+				++node_messages_sent[i];
 //				printf("done!\n");
 
 //				printf("%d sent %lu nodes to %d\n", id,
@@ -1095,6 +1689,15 @@ int HDAStarSearch::termination() {
 	printf("barrier %d\n", id);
 	MPI_Barrier (MPI_COMM_WORLD);
 
+	// A search stopped by the memory limit may still have incumbent
+	// updates in flight, and the barrier does not deliver them. All
+	// processes have to agree on the incumbent before constructing the
+	// plan. The leftover INCM messages are drained below.
+	unsigned int global_incumbent = incumbent;
+	MPI_Allreduce(&incumbent, &global_incumbent, 1, MPI_UNSIGNED, MPI_MIN,
+			MPI_COMM_WORLD);
+	incumbent = global_incumbent;
+
 	construct_plan();
 
 	/**
@@ -1161,7 +1764,7 @@ int HDAStarSearch::termination() {
 	while (has_received) {
 		has_received = 0;
 		MPI_Iprobe(MPI_ANY_SOURCE, MPI_MSG_PLAN, MPI_COMM_WORLD, &has_received,
-				MPI_STATUS_IGNORE);
+				&status);
 		if (has_received) {
 			int source = status.MPI_SOURCE;
 			int d_size;
@@ -1185,6 +1788,30 @@ int HDAStarSearch::termination() {
 
 	printf("PLAN_TERM... ");
 
+	has_received = 1;
+	while (has_received) {
+		has_received = 0;
+		MPI_Iprobe(MPI_ANY_SOURCE, MPI_MSG_CKPT, MPI_COMM_WORLD, &has_received,
+				MPI_STATUS_IGNORE);
+		if (has_received) {
+			MPI_Recv(dummy, 1, MPI_INT, MPI_ANY_SOURCE, MPI_MSG_CKPT,
+					MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		}
+	}
+	printf("CKPT... ");
+
+	has_received = 1;
+	while (has_received) {
+		has_received = 0;
+		MPI_Iprobe(MPI_ANY_SOURCE, MPI_MSG_CKPT_MARKER, MPI_COMM_WORLD,
+				&has_received, MPI_STATUS_IGNORE);
+		if (has_received) {
+			MPI_Recv(dummy, 3, MPI_INT, MPI_ANY_SOURCE, MPI_MSG_CKPT_MARKER,
+					MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		}
+	}
+	printf("CKPT_MARKER... ");
+
 	printf("done!\n");
 	printf("Buffer_detach %d\n", id);
 
@@ -1205,7 +1832,7 @@ int HDAStarSearch::termination() {
 }
 
 void HDAStarSearch::construct_plan() {
-	if (world_size == 1) {
+	if (world_size == 1 || incumbent == INT_MAX) {
 		return;
 	}
 
@@ -1213,16 +1840,21 @@ void HDAStarSearch::construct_plan() {
 	 * message: [stateID(k)] [op(k)] ... [op(n-1)] [op(n)]
 	 *
 	 */
+	// Several processes may hold a goal state with the incumbent cost.
+	// Only the one with the lowest id traces its plan back, so that a
+	// single plan reaches the initial state.
+	int tracing_process = world_size;
 	if (incumbent == incumbent_goal_state.second) {
+		tracing_process = id;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &tracing_process, 1, MPI_INT, MPI_MIN,
+			MPI_COMM_WORLD);
+	if (tracing_process == id) {
 		int gid = incumbent_goal_state.first;
-		State s = g_state_registry->lookup_state(gid);
-		SearchNode s_node = search_space.get_node(s);
-		int op_index = s_node.get_creating_op_index();
+		std::pair<unsigned int, unsigned int> parentid;
+		int op_index = get_plan_step(gid, parentid);
 		int p[2];
 		p[1] = op_index;
-
-		std::pair<unsigned int, unsigned int> parentid =
-				parent_node_process_id[s];
 		p[0] = parentid.second;
 
 //		printf("stateid=%d: op=%d\n", p[0], p[1]);
@@ -1251,7 +1883,7 @@ void HDAStarSearch::construct_plan() {
 //			}
 //			printf("\n");
 
-			if (stateid == g_initial_state().get_id().hash()) {
+			if (stateid == initial_state_id) {
 				Plan pplan;
 				for (int i = 0; i < size - 1; ++i) {
 					const Operator* op = &g_operators[pln[2 + i]];
@@ -1273,14 +1905,9 @@ void HDAStarSearch::construct_plan() {
 				return;
 			}
 
-			State s = g_state_registry->lookup_state(stateid);
-//			s.dump_pddl();
-			SearchNode s_node = search_space.get_node(s);
-			int op_index = s_node.get_creating_op_index();
+			std::pair<unsigned int, unsigned int> parentid;
+			int op_index = get_plan_step(stateid, parentid);
 			pln[1] = op_index;
-
-			std::pair<unsigned int, unsigned int> parentid =
-					parent_node_process_id[s];
 			pln[0] = parentid.second;
 
 			MPI_Bsend(pln, size + 1, MPI_INT, parentid.first, MPI_MSG_PLAN,
@@ -1299,6 +1926,25 @@ void HDAStarSearch::construct_plan() {
 	}
 }
 
+/*
+ * Returns the creating operator of a state given by its global id and sets
+ * parent to the process and global id of its parent.
+ */
+int HDAStarSearch::get_plan_step(int state_id, mpi_state_id &parent) {
+	if (search_space.is_spilled(state_id)) {
+		int parent_process, parent_id;
+		int op_index = search_space.get_spilled_parent(state_id,
+				parent_process, parent_id);
+		parent = mpi_state_id(parent_process, parent_id);
+		return op_index;
+	}
+	State s = g_state_registry->lookup_state(
+			search_space.get_registry_index(state_id));
+	SearchNode s_node = search_space.get_node(s);
+	parent = parent_node_process_id[s];
+	return s_node.get_creating_op_index();
+}
+
 template<typename T>
 void HDAStarSearch::typeToBytes(T& p, unsigned char* d) const {
 	int n = sizeof p;
@@ -1390,6 +2036,30 @@ static SearchEngine *_parse_hdastar(OptionParser &parser) {
 	parser.add_option<bool>("pathmax", "use pathmax correction", "false");
 	parser.add_option<bool>("mpd", "use multi-path dependence (LM-A*)",
 			"false");
+	parser.add_option<bool>("buckets",
+			"use the two-level bucket open list fh_buckets instead of the "
+					"tie-breaking open list. Expands nodes in the same order, "
+					"but needs memory proportional to the largest f value.",
+			"false");
+	parser.add_option<bool>("indexed",
+			"use the indexed open list, which contains every state at most "
+					"once and updates the key of a state when it is reopened, "
+					"instead of the tie-breaking open list. Expands nodes in "
+					"the same order.", "false");
+	MemoryBudget::add_options_to_parser(parser);
+	ExternalClosedList::add_options_to_parser(parser);
+
+	parser.add_option<int>("checkpoint_interval",
+			"write a checkpoint of the search every this many seconds "
+					"(0: never)", "0");
+	parser.add_option<string>("checkpoint_dir",
+			"directory for the checkpoint files (one per process and "
+					"checkpoint, of which the last two are kept)", ".");
+	parser.add_option<bool>("restart",
+			"resume the search from the newest checkpoint in checkpoint_dir "
+					"that all processes have written. It must have been "
+					"written for the same task with the same number of "
+					"processes.", "false");
 
 	// HDA* related options
 	parser.document_note("dist option",
@@ -1398,6 +2068,8 @@ static SearchEngine *_parse_hdastar(OptionParser &parser) {
 
 	SearchEngine::add_options_to_parser(parser);
 	Options opts = parser.parse();
+	if (opts.get<bool>("buckets") && opts.get<bool>("indexed"))
+		parser.error("buckets and indexed cannot be used together");
 
 	HDAStarSearch *engine = 0;
 	if (!parser.dry_run()) {
@@ -1412,8 +2084,14 @@ static SearchEngine *_parse_hdastar(OptionParser &parser) {
 		std::vector<ScalarEvaluator *> evals;
 		evals.push_back(f_eval);
 		evals.push_back(eval);
-		OpenList<StateID> *open = new TieBreakingOpenList<StateID>(evals, false,
-				false);
+		OpenList<StateID> *open;
+		if (opts.get<bool>("buckets")) {
+			open = new FHBucketOpenList<StateID>(f_eval, eval, false);
+		} else if (opts.get<bool>("indexed")) {
+			open = new IndexedOpenList(evals, false);
+		} else {
+			open = new TieBreakingOpenList<StateID>(evals, false, false);
+		}
 
 		opts.set("open", open);
 		opts.set("f_eval", f_eval);
@@ -1,6 +1,7 @@
 #ifndef HDASTAR_SEARCH_H
 #define HDASTAR_SEARCH_H
 
+#include <string>
 #include <vector>
 
 #include "open_lists/open_list.h"
@@ -9,6 +10,8 @@
 #include "state.h"
 #include "timer.h"
 #include "evaluator.h"
+#include "external_closed_list.h"
+#include "memory_budget.h"
 #include "search_progress.h"
 #include "wtimer.h"
 
@@ -46,11 +49,26 @@ class HDAStarSearch: public SearchEngine {
 	unsigned int node_size; // size of SearchNode transfer TODO: extremely tentative to change!
 	unsigned int incumbent; // incumbent goal cost
 	std::vector<std::vector<unsigned char> > outgo_buffer; // It will be copied to mpi_buffer by Bsend.
+	// Successors of the current expansion that are sent, evaluated in one
+	// batch per heuristic before they are written to outgo_buffer.
+	std::vector<state_var_t> sent_successor_data;
+	std::vector<State> sent_successors;
+	std::vector<int> sent_values;
+	// Values of the new local successors of the current expansion, see
+	// EagerSearch.
+	std::vector<State> batch_states;
+	std::vector<int> batch_slot;
+	std::vector<std::vector<int> > batch_values;
+	std::vector<int> slot_of_state; // -1 outside of the current batch
+	std::vector<int> batch_known_h;
+	void evaluate_new_successors(const std::vector<State> &successors,
+			const std::vector<int> &h_values);
 	unsigned int threshold;
 	bool has_sent_first_term; // only for id==0
 	int termination_counter;
 	std::pair<unsigned int,int> incumbent_goal_state; // goal state and its cost
 	unsigned char* mpi_buffer; // used for MPI_Buffer_attach.
+	unsigned int mpi_buffer_size;
 	bool self_send;
 	bool metis;
 
@@ -63,10 +81,49 @@ class HDAStarSearch: public SearchEngine {
 	PerStateInformation<unsigned int> distribution_hash_value; // to store dist value for incremental hashing
 	PerStateInformation<std::pair<unsigned int, unsigned int> > parent_node_process_id; // to store parent id to reconstruct plan.
 
+	MemoryBudget memory_budget;
+	ExternalClosedList *external_closed_list;
+	int initial_state_id; // global id (see SearchSpace)
+
+	// Checkpoints (see take_checkpoint)
+	int checkpoint_interval; // seconds, 0 disables checkpoints
+	std::string checkpoint_dir;
+	bool restart;
+	int checkpoint_number;
+	double last_checkpoint_time;
+	std::vector<unsigned int> node_messages_sent; // per destination
+	std::vector<unsigned int> node_messages_received; // per source
+
+	// Open list entries and their [f, h] keys collected from a received
+	// message, inserted with one insert_batch call (see bytes_to_nodes).
+	std::vector<StateID> received_entries;
+	std::vector<int> received_keys;
+	// The state of the node that bytes_to_node is decoding.
+	std::vector<state_var_t> received_state_buffer;
+
 //	void node_to_bytes(SearchNode* n, unsigned char* d);
 	int termination();
+	int finish_search();
+	MemoryUsage get_memory_usage() const;
+	bool check_memory_budget();
+	void prune_open_list(bool spill_closed_nodes);
+	int get_plan_step(int state_id, mpi_state_id &parent);
+	bool check_checkpoint();
+	bool take_checkpoint(int number);
+	std::string get_checkpoint_filename(int number) const;
+	std::vector<int> find_checkpoints() const;
+	void remove_checkpoints_outside(int first, int last);
+	void write_checkpoint(int number);
+	void read_checkpoint();
+	// succ is the successor of node under op.
+	bool is_pruned_by_incumbent(const State &succ, const SearchNode &node,
+			const Operator *op, int &h);
+	void send_successors(SearchNode &node,
+			const std::vector<const Operator *> &ops,
+			const std::vector<unsigned int> &d_hashes);
+	// h is the value of heuristics[0] for s.
 	bool generate_node_as_bytes(SearchNode* parent_node, const Operator* op,
-			unsigned char* d, unsigned int d_hash);
+			const State &s, int h, unsigned char* d, unsigned int d_hash);
 	StateID bytes_to_node(unsigned char* d);
 	void bytes_to_nodes(unsigned char* d, unsigned int d_size);
 	void receive_nodes_from_queue();
@@ -115,6 +172,7 @@ protected:
 
 public:
 	HDAStarSearch(const Options &opts);
+	~HDAStarSearch();
 	void statistics() const;
 	void search();
 	void dump_search_space();
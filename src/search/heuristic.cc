@@ -59,6 +59,45 @@ void Heuristic::evaluate(const State &state) {
     evaluator_value = heuristic;
 }
 
+void Heuristic::evaluate_batch(const State *states, int n, int *out) {
+    if (n == 0)
+        return;
+    if (heuristic == NOT_INITIALIZED) {
+        initialize();
+        // Any value other than NOT_INITIALIZED would do. The heuristic
+        // has no current state until set_batch_result is called.
+        heuristic = DEAD_END;
+        evaluator_value = DEAD_END;
+    }
+    compute_heuristic_batch(states, n, out);
+#ifndef NDEBUG
+    for (int i = 0; i < n; ++i)
+        assert(out[i] == DEAD_END || out[i] >= 0);
+#endif
+}
+
+void Heuristic::compute_heuristic_batch(const State *states, int n,
+                                        int *out) {
+    // Keep the preferred operators of the current state.
+    vector<const Operator *> current_preferred;
+    current_preferred.swap(preferred_operators);
+    for (int i = 0; i < n; ++i) {
+        out[i] = compute_heuristic(states[i]);
+        for (int j = 0; j < preferred_operators.size(); j++)
+            preferred_operators[j]->unmark();
+        preferred_operators.clear();
+    }
+    preferred_operators.swap(current_preferred);
+}
+
+void Heuristic::set_batch_result(int value) {
+    assert(heuristic != NOT_INITIALIZED);
+    assert(value == DEAD_END || value >= 0);
+    preferred_operators.clear();
+    heuristic = value;
+    evaluator_value = value;
+}
+
 bool Heuristic::is_dead_end() const {
     return evaluator_value == DEAD_END;
 }
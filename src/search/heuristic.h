@@ -28,6 +28,11 @@ protected:
     enum {DEAD_END = -1};
     virtual void initialize() {}
     virtual int compute_heuristic(const State &state) = 0;
+    // Computes the values of n states into out, with DEAD_END for dead
+    // ends. The default calls compute_heuristic for each state and drops
+    // the preferred operators; heuristics that can share work between
+    // the states, such as table lookups, should override it.
+    virtual void compute_heuristic_batch(const State *states, int n, int *out);
     // Usage note: It's OK to set the same operator as preferred
     // multiple times -- it will still only appear in the list of
     // preferred operators for this heuristic once.
@@ -41,6 +46,17 @@ public:
     virtual ~Heuristic();
 
     void evaluate(const State &state);
+    /*
+      Evaluates n states at once, e.g. all successors of an expansion, and
+      stores their values in out (negative for dead ends). The current
+      value of the heuristic is not changed; use set_batch_result to make
+      one of the values current before passing it on to an open list.
+      No preferred operators are computed for the states.
+    */
+    void evaluate_batch(const State *states, int n, int *out);
+    // Sets the heuristic value as if evaluate had computed value, which
+    // has to come from evaluate_batch.
+    void set_batch_result(int value);
     bool is_dead_end() const;
     int get_heuristic();
     // changed to virtual, so HeuristicProxy can delegate this:
@@ -48,6 +64,9 @@ public:
     virtual bool dead_ends_are_reliable() const {return true; }
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    // True if the value of a state depends on the information reach_state
+    // has gathered for it, so it must not be evaluated before reach_state.
+    virtual bool depends_on_reached_path() const {return false; }
 
     // for abstract parent ScalarEvaluator
     int get_value() const;
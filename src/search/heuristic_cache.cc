@@ -0,0 +1,238 @@
+#include "heuristic_cache.h"
+
+#include "globals.h"
+#include "operator.h"
+#include "option_parser.h"
+#include "state.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+using namespace std;
+
+static const char MAGIC[8] = {'F', 'D', 'H', 'C', 'A', 'C', 'H', 'E'};
+static const int VERSION = 1;
+static const int BYTE_ORDER_MARK = 0x01020304;
+
+struct CacheFileHeader {
+    char magic[8];
+    int version;
+    int byte_order_mark;
+    unsigned long long task_fingerprint;
+    unsigned long long key_size;
+    unsigned long long data_size;
+};
+
+static size_t padded(size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+// 64-bit FNV-1a.
+class Fingerprint {
+    unsigned long long hash;
+public:
+    Fingerprint()
+        : hash(14695981039346656037ULL) {
+    }
+
+    void add_bytes(const void *bytes, size_t count) {
+        const unsigned char *p = static_cast<const unsigned char *>(bytes);
+        for (size_t i = 0; i < count; ++i) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void add(int value) {
+        add_bytes(&value, sizeof(value));
+    }
+
+    void add(const Operator &op) {
+        const vector<Prevail> &prevail = op.get_prevail();
+        add(prevail.size());
+        for (size_t i = 0; i < prevail.size(); ++i) {
+            add(prevail[i].var);
+            add(prevail[i].prev);
+        }
+        const vector<PrePost> &pre_post = op.get_pre_post();
+        add(pre_post.size());
+        for (size_t i = 0; i < pre_post.size(); ++i) {
+            add(pre_post[i].var);
+            add(pre_post[i].pre);
+            add(pre_post[i].post);
+            const vector<Prevail> &cond = pre_post[i].cond;
+            add(cond.size());
+            for (size_t j = 0; j < cond.size(); ++j) {
+                add(cond[j].var);
+                add(cond[j].prev);
+            }
+        }
+        add(op.get_cost());
+    }
+
+    unsigned long long get() const {
+        return hash;
+    }
+};
+
+static unsigned long long compute_task_fingerprint() {
+    Fingerprint fingerprint;
+    fingerprint.add(g_use_metric);
+    int num_vars = g_variable_domain.size();
+    fingerprint.add(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        fingerprint.add(g_variable_domain[var]);
+        fingerprint.add(g_axiom_layers[var]);
+        fingerprint.add(g_default_axiom_values[var]);
+        fingerprint.add(g_initial_state()[var]);
+    }
+    fingerprint.add(g_goal.size());
+    for (size_t i = 0; i < g_goal.size(); ++i) {
+        fingerprint.add(g_goal[i].first);
+        fingerprint.add(g_goal[i].second);
+    }
+    fingerprint.add(g_operators.size());
+    for (size_t i = 0; i < g_operators.size(); ++i)
+        fingerprint.add(g_operators[i]);
+    fingerprint.add(g_axioms.size());
+    for (size_t i = 0; i < g_axioms.size(); ++i)
+        fingerprint.add(g_axioms[i]);
+    return fingerprint.get();
+}
+
+unsigned long long get_task_fingerprint() {
+    // Thread-safe initialization: PDBs may be built in parallel.
+    static const unsigned long long task_fingerprint =
+        compute_task_fingerprint();
+    return task_fingerprint;
+}
+
+// Creates the directory and its missing parents, like mkdir -p.
+static bool make_directories(const string &path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        string prefix = path.substr(0, pos);
+        if (mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST)
+            return false;
+        if (pos == string::npos)
+            return true;
+    }
+}
+
+HeuristicCache::HeuristicCache(const string &directory_, const string &key_)
+    : directory(directory_), key(key_), data(0), size(0), mapping(0),
+      mapping_size(0) {
+    Fingerprint fingerprint;
+    unsigned long long task_fingerprint = get_task_fingerprint();
+    fingerprint.add_bytes(&task_fingerprint, sizeof(task_fingerprint));
+    fingerprint.add_bytes(key.data(), key.size());
+    ostringstream name;
+    name << directory << "/" << hex << fingerprint.get() << ".fdcache";
+    filename = name.str();
+}
+
+HeuristicCache::~HeuristicCache() {
+    if (mapping)
+        munmap(mapping, mapping_size);
+}
+
+bool HeuristicCache::load() {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        size_t(file_stat.st_size) < sizeof(CacheFileHeader)) {
+        close(fd);
+        return false;
+    }
+    mapping_size = file_stat.st_size;
+    mapping = mmap(0, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = 0;
+        return false;
+    }
+
+    const char *file_data = static_cast<const char *>(mapping);
+    const CacheFileHeader *header =
+        reinterpret_cast<const CacheFileHeader *>(file_data);
+    size_t key_offset = sizeof(CacheFileHeader);
+    size_t data_offset = key_offset + padded(header->key_size);
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header->version != VERSION ||
+        header->byte_order_mark != BYTE_ORDER_MARK ||
+        header->task_fingerprint != get_task_fingerprint() ||
+        header->key_size != key.size() ||
+        data_offset + padded(header->data_size) != mapping_size ||
+        memcmp(file_data + key_offset, key.data(), key.size()) != 0) {
+        munmap(mapping, mapping_size);
+        mapping = 0;
+        return false;
+    }
+    data = file_data + data_offset;
+    size = header->data_size;
+    return true;
+}
+
+void HeuristicCache::save(const char *block, size_t block_size) const {
+    ostringstream temporary_name;
+    // Threads of one process may write entries at the same time.
+    static int num_saves = 0;
+    temporary_name << filename << ".tmp." << getpid() << "."
+                   << __sync_fetch_and_add(&num_saves, 1);
+    string temporary_filename = temporary_name.str();
+
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order_mark = BYTE_ORDER_MARK;
+    header.task_fingerprint = get_task_fingerprint();
+    header.key_size = key.size();
+    header.data_size = block_size;
+    static const char padding[8] = {0};
+
+    FILE *file = fopen(temporary_filename.c_str(), "wb");
+    if (!file && errno == ENOENT && make_directories(directory))
+        file = fopen(temporary_filename.c_str(), "wb");
+    bool ok = file != 0;
+    if (ok) {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(key.data(), 1, key.size(), file) == key.size() &&
+             fwrite(padding, 1, padded(key.size()) - key.size(), file) ==
+             padded(key.size()) - key.size() &&
+             fwrite(block, 1, block_size, file) == block_size &&
+             fwrite(padding, 1, padded(block_size) - block_size, file) ==
+             padded(block_size) - block_size;
+        ok = (fclose(file) == 0) && ok;
+        ok = ok && rename(temporary_filename.c_str(), filename.c_str()) == 0;
+        if (!ok)
+            remove(temporary_filename.c_str());
+    }
+    if (!ok)
+        cout << "Warning: could not write heuristic cache file " << filename
+             << endl;
+}
+
+void HeuristicCache::add_option_to_parser(OptionParser &parser) {
+    parser.add_option<string>(
+        "cache_dir",
+        "directory in which what the heuristic builds is stored and from "
+        "which it is loaded in later runs on the same task with the same "
+        "options. Default: no caching.",
+        "",
+        OptionFlags(false));
+}
+
+string HeuristicCache::get_directory(const Options &opts) {
+    if (!opts.contains("cache_dir"))
+        return "";
+    return opts.get<string>("cache_dir");
+}
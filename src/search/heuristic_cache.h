@@ -0,0 +1,66 @@
+#ifndef HEURISTIC_CACHE_H
+#define HEURISTIC_CACHE_H
+
+#include <cstddef>
+#include <string>
+
+class OptionParser;
+class Options;
+
+/*
+  HeuristicCache stores what an expensive heuristic builds, such as PDB
+  tables, merge-and-shrink lookup tables and landmark graphs, in a cache
+  directory (option cache_dir), so that later runs on the same task with
+  the same construction options load it instead of building it again.
+
+  An entry belongs to the task fingerprint (see get_task_fingerprint) and
+  a key in which the heuristic describes everything else its data
+  depends on. The file name is a hash of both. The file repeats them, so
+  that hash collisions and files of other tasks or format versions are
+  treated as missing entries. A file consists of the magic bytes
+  "FDHCACHE", the format version, the integer 0x01020304 (byte order),
+  the task fingerprint, the key length and the data size, followed by
+  the key and the data, each padded to a multiple of 8 bytes. Loading
+  maps the file into memory, and the data is used in place.
+
+  Entries are written under a temporary name and then renamed, so runs
+  that share a cache directory never read partial files. The directory
+  and its missing parents are created when the first entry is written.
+  The cache is only an optimization: if an entry cannot be written, the
+  planner prints a warning and continues.
+*/
+class HeuristicCache {
+    std::string directory;
+    std::string key;
+    std::string filename;
+    const char *data;
+    size_t size;
+    void *mapping;
+    size_t mapping_size;
+public:
+    HeuristicCache(const std::string &directory, const std::string &key);
+    ~HeuristicCache();
+
+    // Maps the entry into memory. Returns false if there is no valid entry.
+    bool load();
+    // The data of the loaded entry, valid as long as this object lives.
+    const char *get_data() const {return data; }
+    size_t get_size() const {return size; }
+
+    void save(const char *data, size_t size) const;
+
+    const std::string &get_filename() const {return filename; }
+
+    static void add_option_to_parser(OptionParser &parser);
+    // Returns the directory given with cache_dir, or "" if caching is off.
+    static std::string get_directory(const Options &opts);
+};
+
+/*
+  A hash of all task data that heuristics can depend on: variables,
+  initial state, goal, operators (with costs) and axioms. Names are not
+  included. Computed on the first call.
+*/
+unsigned long long get_task_fingerprint();
+
+#endif
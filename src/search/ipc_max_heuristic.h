@@ -21,6 +21,7 @@ public:
     ~IPCMaxHeuristic();
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    virtual bool depends_on_reached_path() const;
 };
 
 #endif
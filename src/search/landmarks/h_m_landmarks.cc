@@ -593,6 +593,12 @@ HMLandmarks::HMLandmarks(const Options &opts)
     // we can then free all unneeded memory after computation is done.
 }
 
+bool HMLandmarks::get_cache_key(std::ostream &key) const {
+    key << "lm_hm" << std::endl
+        << "m: " << m_ << std::endl;
+    return true;
+}
+
 void HMLandmarks::init() {
     // get all the m or less size subsets in the domain
     std::vector<std::vector<Fluent> > msets;
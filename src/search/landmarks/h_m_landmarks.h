@@ -78,6 +78,7 @@ private:
     typedef __gnu_cxx::hash_map<int, std::set<int> > TriggerSet;
 
     virtual void generate_landmarks();
+    virtual bool get_cache_key(std::ostream &key) const;
 
     void compute_h_m_landmarks();
     void compute_noop_landmarks(int op_index, int noop_index,
@@ -23,6 +23,11 @@ public:
                 synergy->compute_heuristics(state);
             return get_heuristic_value();
         }
+        // Both values come from the shared computation of the first
+        // proxy, which needs the landmarks reached on the path.
+        virtual bool depends_on_reached_path() const {
+            return true;
+        }
     };
 
     class FFHeuristicProxy : public HeuristicProxy {
@@ -55,6 +55,9 @@ public:
     }
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    virtual bool depends_on_reached_path() const {
+        return true;
+    }
     virtual bool dead_ends_are_reliable() const {
         return true;
     }
@@ -1,23 +1,46 @@
 #include "landmark_factory.h"
 #include "../exact_timer.h"
+#include "../heuristic_cache.h"
 #include "util.h"
 
 #include <limits>
 #include <fstream>
+#include <sstream>
 
 using namespace __gnu_cxx;
 using namespace std;
 
 LandmarkFactory::LandmarkFactory(const Options &opts)
-    : lm_graph(new LandmarkGraph(opts)) {
+    : lm_graph(new LandmarkGraph(opts)),
+      cache_dir(HeuristicCache::get_directory(opts)),
+      cost_type(opts.get<int>("cost_type")) {
 }
 
 LandmarkGraph *LandmarkFactory::compute_lm_graph() {
     ExactTimer lm_generation_timer;
-    generate_landmarks();
-
-    // the following replaces the old "build_lm_graph"
-    generate();
+    HeuristicCache *cache = 0;
+    ostringstream key;
+    if (!cache_dir.empty() && get_cache_key(key)) {
+        lm_graph->dump_options(key);
+        key << "cost_type: " << cost_type << endl;
+        cache = new HeuristicCache(cache_dir, key.str());
+    }
+    if (cache && cache->load()) {
+        lm_graph->read_flat(reinterpret_cast<const int *>(cache->get_data()));
+        cout << "Loaded landmark graph from " << cache->get_filename() << endl;
+    } else {
+        generate_landmarks();
+
+        // the following replaces the old "build_lm_graph"
+        generate();
+        if (cache) {
+            vector<int> data;
+            lm_graph->write_flat(data);
+            cache->save(reinterpret_cast<const char *>(&data[0]),
+                        data.size() * sizeof(int));
+        }
+    }
+    delete cache;
     cout << "Landmarks generation time: " << lm_generation_timer << endl;
     if (lm_graph->number_of_landmarks() == 0)
         cout << "Warning! No landmarks found. Task unsolvable?" << endl;
@@ -6,8 +6,10 @@
 
 #include <ext/hash_map>
 #include <ext/hash_set>
+#include <iosfwd>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 class LandmarkFactory {
@@ -18,10 +20,17 @@ public:
     // returns a landmarkgraph created by a factory class.
     // take care to delete the pointer when you don't need it anymore!
     // (method should principally anyways be called by every inheriting class)
+    // With the option cache_dir, the graph is loaded from or stored in the heuristic cache.
     LandmarkGraph *compute_lm_graph();
 protected:
     LandmarkGraph *lm_graph;
+    const std::string cache_dir;
+    const int cost_type;
     virtual void generate_landmarks() = 0;
+    /* Writes the name of the factory and its own options (the ones of the graph are added
+       by compute_lm_graph) for the key of the cache. Returns false if the graph of the
+       factory cannot be cached. */
+    virtual bool get_cache_key(std::ostream &key) const = 0;
     void generate();
     void discard_noncausal_landmarks();
     void discard_disjunctive_landmarks();
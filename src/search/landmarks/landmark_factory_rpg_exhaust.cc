@@ -1,3 +1,4 @@
+#include <iostream>
 #include <vector>
 
 #include "landmark_factory_rpg_exhaust.h"
@@ -13,6 +14,11 @@ LandmarkFactoryRpgExhaust::LandmarkFactoryRpgExhaust(const Options &opts)
     : LandmarkFactory(opts) {
 }
 
+bool LandmarkFactoryRpgExhaust::get_cache_key(ostream &key) const {
+    key << "lm_exhaust" << endl;
+    return true;
+}
+
 void LandmarkFactoryRpgExhaust::generate_landmarks() {
     cout << "Generating landmarks by testing all facts with RPG method" << endl;
 
@@ -10,6 +10,7 @@ public:
     virtual ~LandmarkFactoryRpgExhaust() {}
 private:
     void generate_landmarks();
+    virtual bool get_cache_key(std::ostream &key) const;
 };
 
 #endif
@@ -11,6 +11,7 @@
 #include "../plugin.h"
 
 #include <cassert>
+#include <iostream>
 #include <limits>
 #include <ext/hash_map>
 #include <ext/hash_set>
@@ -21,6 +22,11 @@ LandmarkFactoryRpgSasp::LandmarkFactoryRpgSasp(const Options &opts)
     : LandmarkFactory(opts) {
 }
 
+bool LandmarkFactoryRpgSasp::get_cache_key(ostream &key) const {
+    key << "lm_rhw" << endl;
+    return true;
+}
+
 void LandmarkFactoryRpgSasp::get_greedy_preconditions_for_lm(
     const LandmarkNode *lmp, const Operator &o, hash_map<int, int> &result) const {
     // Computes a subset of the actual preconditions of o for achieving lmp - takes into account
@@ -34,6 +34,7 @@ class LandmarkFactoryRpgSasp : public LandmarkFactory {
                                     const __gnu_cxx::hash_set<int> &exclude);
 
     void build_disjunction_classes();
+    virtual bool get_cache_key(std::ostream &key) const;
 public:
     LandmarkFactoryRpgSasp(const Options &opts);
     virtual ~LandmarkFactoryRpgSasp() {}
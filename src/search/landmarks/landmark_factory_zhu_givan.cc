@@ -17,6 +17,11 @@ LandmarkFactoryZhuGivan::LandmarkFactoryZhuGivan(const Options &opts)
     : LandmarkFactory(opts) {
 }
 
+bool LandmarkFactoryZhuGivan::get_cache_key(std::ostream &key) const {
+    key << "lm_zg" << std::endl;
+    return true;
+}
+
 void LandmarkFactoryZhuGivan::generate_landmarks() {
     cout << "Generating landmarks using Zhu/Givan label propagation\n";
 
@@ -6,6 +6,8 @@
 #include "landmark_types.h"
 #include "../globals.h"
 
+#include <vector>
+
 using namespace __gnu_cxx;
 
 class LandmarkFactoryZhuGivan : public LandmarkFactory {
@@ -21,20 +23,20 @@ public:
         }
     };
 
-    typedef vector<vector<plan_graph_node> > proposition_layer;
+    typedef std::vector<std::vector<plan_graph_node> > proposition_layer;
 
     // triggers[i][j] is a list of operators that could reach/change
     // labels on some proposition, after proposition (i,j) has changed
-    vector<vector<vector<int> > > triggers;
+    std::vector<std::vector<std::vector<int> > > triggers;
 
     void compute_triggers();
 
     // Note: must include operators that only have conditional effects
-    vector<int> operators_without_preconditions;
+    std::vector<int> operators_without_preconditions;
 
     bool operator_applicable(const Operator &, const proposition_layer &) const;
 
-    bool operator_cond_effect_fires(const vector<Prevail> &cond,
+    bool operator_cond_effect_fires(const std::vector<Prevail> &cond,
                                     const proposition_layer &layer) const;
 
     // Apply operator and propagate labels to next layer. Returns set of
@@ -51,7 +53,7 @@ public:
 
     // Calculate the union of precondition labels of a conditional effect,
     // using the labels from current
-    lm_set union_of_condition_labels(const vector<Prevail> &cond,
+    lm_set union_of_condition_labels(const std::vector<Prevail> &cond,
                                      const proposition_layer &current) const;
 
     // Relaxed exploration, returns the last proposition layer
@@ -66,6 +68,7 @@ public:
     bool satisfies_goal_conditions(const proposition_layer &) const;
 
     void generate_landmarks();
+    virtual bool get_cache_key(std::ostream &key) const;
 
 public:
     LandmarkFactoryZhuGivan(const Options &opts);
@@ -2,11 +2,13 @@
 
 #include "../exact_timer.h"
 #include "../globals.h"
+#include "../heuristic_cache.h"
 #include "../operator.h"
 #include "../state.h"
 
 #include <cassert>
 #include <ext/hash_map>
+#include <iostream>
 #include <list>
 #include <map>
 #include <set>
@@ -325,6 +327,146 @@ void LandmarkGraph::dump() const {
     cout << "Landmark graph end." << endl;
 }
 
+void LandmarkGraph::dump_options(ostream &out) const {
+    out << "reasonable_orders: " << reasonable_orders << endl
+        << "only_causal_landmarks: " << only_causal_landmarks << endl
+        << "disjunctive_landmarks: " << disjunctive_landmarks << endl
+        << "conjunctive_landmarks: " << conjunctive_landmarks << endl
+        << "no_orders: " << no_orders << endl
+        << "lm_cost_type: " << lm_cost_type << endl;
+}
+
+enum FlatLandmarkType {
+    FLAT_SIMPLE,
+    FLAT_DISJUNCTIVE,
+    FLAT_CONJUNCTIVE
+};
+
+static void write_flat_list(const set<int> &values, vector<int> &data) {
+    data.push_back(values.size());
+    data.insert(data.end(), values.begin(), values.end());
+}
+
+static const int *read_flat_list(const int *data, set<int> &values) {
+    int size = *data++;
+    values.insert(data, data + size);
+    return data + size;
+}
+
+void LandmarkGraph::write_flat(vector<int> &data) const {
+    /* Layout: number of landmarks, landmark cost, then for every landmark in the order
+       of the ids its type, for simple landmarks the fact by which they are found (see
+       make_disj_node_simple), in_goal, min_cost, its facts, first and possible achievers
+       and forward orders (each preceded by their number) and the number of children
+       followed by (child id, edge type) pairs. */
+    map<const LandmarkNode *, pair<int, int> > simple_lm_facts;
+    for (hash_map<pair<int, int>, LandmarkNode *, hash_int_pair>::const_iterator it =
+             simple_lms_to_nodes.begin(); it != simple_lms_to_nodes.end(); ++it)
+        simple_lm_facts[it->second] = it->first;
+
+    data.push_back(landmarks_count);
+    data.push_back(landmarks_cost);
+    for (int id = 0; id < landmarks_count; ++id) {
+        const LandmarkNode &node = *ordered_nodes[id];
+        assert(node.get_id() == id);
+        if (node.disjunctive) {
+            data.push_back(FLAT_DISJUNCTIVE);
+        } else if (node.conjunctive) {
+            data.push_back(FLAT_CONJUNCTIVE);
+        } else {
+            data.push_back(FLAT_SIMPLE);
+            const pair<int, int> &fact = simple_lm_facts[&node];
+            data.push_back(fact.first);
+            data.push_back(fact.second);
+        }
+        data.push_back(node.in_goal);
+        data.push_back(node.min_cost);
+        data.push_back(node.vars.size());
+        for (size_t i = 0; i < node.vars.size(); ++i) {
+            data.push_back(node.vars[i]);
+            data.push_back(node.vals[i]);
+        }
+        write_flat_list(node.first_achievers, data);
+        write_flat_list(node.possible_achievers, data);
+        data.push_back(node.forward_orders.size());
+        for (hash_set<pair<int, int>, hash_int_pair>::const_iterator it =
+                 node.forward_orders.begin(); it != node.forward_orders.end(); ++it) {
+            data.push_back(it->first);
+            data.push_back(it->second);
+        }
+        data.push_back(node.children.size());
+        for (hash_map<LandmarkNode *, edge_type, hash_pointer>::const_iterator it =
+                 node.children.begin(); it != node.children.end(); ++it) {
+            data.push_back(it->first->get_id());
+            data.push_back(it->second);
+        }
+    }
+}
+
+void LandmarkGraph::read_flat(const int *data) {
+    assert(nodes.empty());
+    int num_landmarks = *data++;
+    landmarks_cost = *data++;
+    // Children are added when all nodes exist.
+    vector<vector<pair<int, int> > > children(num_landmarks);
+    ordered_nodes.resize(num_landmarks);
+    for (int id = 0; id < num_landmarks; ++id) {
+        int type = *data++;
+        pair<int, int> simple_fact;
+        if (type == FLAT_SIMPLE) {
+            simple_fact.first = *data++;
+            simple_fact.second = *data++;
+        }
+        bool in_goal = *data++;
+        int min_cost = *data++;
+        int num_facts = *data++;
+        vector<int> vars;
+        vector<int> vals;
+        for (int i = 0; i < num_facts; ++i) {
+            vars.push_back(*data++);
+            vals.push_back(*data++);
+        }
+        LandmarkNode *node = new LandmarkNode(vars, vals, type == FLAT_DISJUNCTIVE,
+                                              type == FLAT_CONJUNCTIVE);
+        nodes.insert(node);
+        if (type == FLAT_SIMPLE) {
+            simple_lms_to_nodes.insert(make_pair(simple_fact, node));
+        } else if (type == FLAT_DISJUNCTIVE) {
+            for (int i = 0; i < num_facts; ++i)
+                disj_lms_to_nodes.insert(make_pair(make_pair(vars[i], vals[i]), node));
+        } else {
+            ++conj_lms;
+        }
+        ++landmarks_count;
+        node->assign_id(id);
+        ordered_nodes[id] = node;
+
+        node->in_goal = in_goal;
+        node->min_cost = min_cost;
+        data = read_flat_list(data, node->first_achievers);
+        data = read_flat_list(data, node->possible_achievers);
+        int num_forward_orders = *data++;
+        for (int i = 0; i < num_forward_orders; ++i) {
+            node->forward_orders.insert(make_pair(data[0], data[1]));
+            data += 2;
+        }
+        int num_children = *data++;
+        for (int i = 0; i < num_children; ++i) {
+            children[id].push_back(make_pair(data[0], data[1]));
+            data += 2;
+        }
+    }
+    for (int id = 0; id < num_landmarks; ++id) {
+        LandmarkNode *node = ordered_nodes[id];
+        for (size_t i = 0; i < children[id].size(); ++i) {
+            LandmarkNode *child = ordered_nodes[children[id][i].first];
+            edge_type type = static_cast<edge_type>(children[id][i].second);
+            node->children[child] = type;
+            child->parents[node] = type;
+        }
+    }
+}
+
 void LandmarkGraph::add_options_to_parser(OptionParser &parser) {
     Heuristic::add_options_to_parser(parser);
     parser.add_option<bool>("reasonable_orders",
@@ -358,4 +500,5 @@ void LandmarkGraph::add_options_to_parser(OptionParser &parser) {
                            cost_types,
                            "landmark action cost adjustment",
                            "NORMAL");
+    HeuristicCache::add_option_to_parser(parser);
 }
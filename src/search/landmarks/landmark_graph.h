@@ -5,6 +5,7 @@
 #include <set>
 #include <map>
 #include <ext/hash_map>
+#include <iosfwd>
 #include <list>
 #include <ext/hash_set>
 #include <cassert>
@@ -203,6 +204,15 @@ public:
     }
     void dump_node(const LandmarkNode *node_p) const;
     void dump() const;
+
+    // ------------------------------------------------------------------------------
+    // methods needed for the landmark graph cache (see LandmarkFactory::compute_lm_graph)
+    // Writes the options of the graph, which are part of the cache key.
+    void dump_options(std::ostream &out) const;
+    /* Writes the landmarks with their ids, orderings and achievers and the landmark
+       cost as a flat list of integers, and restores them in a graph without landmarks. */
+    void write_flat(std::vector<int> &data) const;
+    void read_flat(const int *data);
 private:
     void generate_operators_lookups();
     Exploration *exploration;
@@ -14,6 +14,10 @@ LandmarkGraphMerged::LandmarkGraphMerged(const Options &opts)
 LandmarkGraphMerged::~LandmarkGraphMerged() {
 }
 
+bool LandmarkGraphMerged::get_cache_key(ostream &) const {
+    return false;
+}
+
 LandmarkNode *LandmarkGraphMerged::get_matching_landmark(const LandmarkNode &lm) const {
     if (!lm.disjunctive && !lm.conjunctive) {
         pair<int, int> lm_fact = make_pair(lm.vars[0], lm.vals[0]);
@@ -9,6 +9,8 @@ class LandmarkGraphMerged : public LandmarkFactory {
     std::vector<LandmarkGraph *> lm_graphs;
     void generate_landmarks();
     LandmarkNode *get_matching_landmark(const LandmarkNode &lm) const;
+    // Not cached: merging is cheap, and the merged graphs have their own caches.
+    virtual bool get_cache_key(std::ostream &key) const;
 public:
     LandmarkGraphMerged(const Options &opts);
     virtual ~LandmarkGraphMerged();
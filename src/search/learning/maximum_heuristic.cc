@@ -134,3 +134,11 @@ bool MaxHeuristic::reach_state(const State &parent_state, const Operator &op,
     }
     return ret;
 }
+
+bool MaxHeuristic::depends_on_reached_path() const {
+    for (int i = 0; i < heuristics.size(); i++) {
+        if (heuristics[i]->depends_on_reached_path())
+            return true;
+    }
+    return false;
+}
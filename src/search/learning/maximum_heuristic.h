@@ -42,6 +42,7 @@ public:
     virtual void print_statistics() const;
     virtual bool reach_state(const State &parent_state, const Operator &op,
                              const State &state);
+    virtual bool depends_on_reached_path() const;
 };
 
 #endif
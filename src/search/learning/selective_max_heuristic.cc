@@ -522,6 +522,14 @@ bool SelectiveMaxHeuristic::reach_state(const State &parent_state, const Operato
     return ret;
 }
 
+bool SelectiveMaxHeuristic::depends_on_reached_path() const {
+    for (int i = 0; i < num_heuristics; i++) {
+        if (heuristics[i]->depends_on_reached_path())
+            return true;
+    }
+    return false;
+}
+
 void SelectiveMaxHeuristic::print_statistics() const {
     cout << "Selective Max Statistics" << endl;
     cout << "Num evals: " << num_evals << endl;
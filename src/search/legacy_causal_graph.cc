@@ -1,5 +1,6 @@
 #include "legacy_causal_graph.h"
 
+#include "binary_task_file.h"
 #include "globals.h"
 
 #include <algorithm>
@@ -9,6 +10,16 @@ using namespace std;
 
 LegacyCausalGraph::LegacyCausalGraph(istream &in) {
     check_magic(in, "begin_CG");
+    read_arcs(in);
+    check_magic(in, "end_CG");
+}
+
+LegacyCausalGraph::LegacyCausalGraph(BinaryTaskFile &in) {
+    read_arcs(in);
+}
+
+template<class Input>
+void LegacyCausalGraph::read_arcs(Input &in) {
     int var_count = g_variable_domain.size();
     arcs.resize(var_count);
     inverse_arcs.resize(var_count);
@@ -28,7 +39,6 @@ LegacyCausalGraph::LegacyCausalGraph(istream &in) {
             edges[to_node].push_back(from_node);
         }
     }
-    check_magic(in, "end_CG");
 
     for (int i = 0; i < var_count; i++) {
         sort(edges[i].begin(), edges[i].end());
@@ -4,6 +4,7 @@
 #include <iosfwd>
 #include <vector>
 
+class BinaryTaskFile;
 
 class LegacyCausalGraph {
     /*
@@ -16,8 +17,12 @@ class LegacyCausalGraph {
     std::vector<std::vector<int> > arcs;
     std::vector<std::vector<int> > inverse_arcs;
     std::vector<std::vector<int> > edges;
+
+    template<class Input>
+    void read_arcs(Input &in);
 public:
     LegacyCausalGraph(std::istream &in);
+    LegacyCausalGraph(BinaryTaskFile &in);
     ~LegacyCausalGraph() {}
     const std::vector<int> &get_successors(int var) const;
     const std::vector<int> &get_predecessors(int var) const;
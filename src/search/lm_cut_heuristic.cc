@@ -18,7 +18,6 @@ using namespace std;
 // construction and destruction
 LandmarkCutHeuristic::LandmarkCutHeuristic(const Options &opts)
     : Heuristic(opts) {
-    num_propositions = 2; // artificial goal and artificial precondition
 }
 
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
@@ -30,18 +29,37 @@ void LandmarkCutHeuristic::initialize() {
 
     ::verify_no_axioms_no_cond_effects();
 
-    // Build propositions.
-    assert(num_propositions == 2);
-    propositions.resize(g_variable_domain.size());
+    // Number propositions.
+    num_propositions = 0;
     for (int var = 0; var < g_variable_domain.size(); var++) {
-        for (int value = 0; value < g_variable_domain[var]; value++)
-            propositions[var].push_back(RelaxedProposition());
+        proposition_offset.push_back(num_propositions);
         num_propositions += g_variable_domain[var];
     }
+    artificial_precondition = num_propositions++;
+    artificial_goal = num_propositions++;
 
     // Build relaxed operators for operators and axioms.
-    for (int i = 0; i < g_operators.size(); i++)
-        build_relaxed_operator(g_operators[i]);
+    precondition_begin.push_back(0);
+    effect_begin.push_back(0);
+    vector<int> precondition;
+    vector<int> effect;
+    for (int i = 0; i < g_operators.size(); i++) {
+        const Operator &op = g_operators[i];
+        const vector<Prevail> &prevail = op.get_prevail();
+        const vector<PrePost> &pre_post = op.get_pre_post();
+        precondition.clear();
+        effect.clear();
+        for (int j = 0; j < prevail.size(); j++)
+            precondition.push_back(
+                proposition_offset[prevail[j].var] + prevail[j].prev);
+        for (int j = 0; j < pre_post.size(); j++) {
+            int offset = proposition_offset[pre_post[j].var];
+            if (pre_post[j].pre != -1)
+                precondition.push_back(offset + pre_post[j].pre);
+            effect.push_back(offset + pre_post[j].post);
+        }
+        add_relaxed_operator(precondition, effect, get_adjusted_cost(op));
+    }
 
     // Simplify relaxed operators.
     // simplify();
@@ -49,115 +67,118 @@ void LandmarkCutHeuristic::initialize() {
        but only after trying out whether and how much the change to
        unary operators hurts. */
 
-    // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
+    // Build artificial goal operator.
+    precondition.clear();
+    effect.clear();
     for (int i = 0; i < g_goal.size(); i++) {
         int var = g_goal[i].first, val = g_goal[i].second;
-        RelaxedProposition *goal_prop = &propositions[var][val];
-        goal_op_pre.push_back(goal_prop);
+        precondition.push_back(proposition_offset[var] + val);
     }
-    goal_op_eff.push_back(&artificial_goal);
-    add_relaxed_operator(goal_op_pre, goal_op_eff, 0, 0);
+    effect.push_back(artificial_goal);
+    add_relaxed_operator(precondition, effect, 0);
+    num_operators = base_cost.size();
 
     // Cross-reference relaxed operators.
-    for (int i = 0; i < relaxed_operators.size(); i++) {
-        RelaxedOperator *op = &relaxed_operators[i];
-        for (int j = 0; j < op->precondition.size(); j++)
-            op->precondition[j]->precondition_of.push_back(op);
-        for (int j = 0; j < op->effects.size(); j++)
-            op->effects[j]->effect_of.push_back(op);
-    }
+    build_cross_references(precondition_begin, preconditions,
+                           precondition_of_begin, precondition_of);
+    build_cross_references(effect_begin, effects,
+                           effect_of_begin, effect_of);
+
+    relaxed_operators.resize(num_operators);
+    propositions.resize(num_propositions);
+    initial_propositions.resize(g_variable_domain.size());
+    second_exploration_queue.resize(num_propositions);
+    supported_begin.resize(num_propositions + 2);
+    supported.resize(num_operators);
+    zone_mark.resize(num_propositions, 0);
+    achieves_goal_zone.resize(num_operators, 0);
+    current_round = 0;
 }
 
-void LandmarkCutHeuristic::build_relaxed_operator(const Operator &op) {
-    const vector<Prevail> &prevail = op.get_prevail();
-    const vector<PrePost> &pre_post = op.get_pre_post();
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (int i = 0; i < prevail.size(); i++)
-        precondition.push_back(&propositions[prevail[i].var][prevail[i].prev]);
-    for (int i = 0; i < pre_post.size(); i++) {
-        if (pre_post[i].pre != -1)
-            precondition.push_back(&propositions[pre_post[i].var][
-                                       pre_post[i].pre]);
-        effects.push_back(&propositions[pre_post[i].var][pre_post[i].post]);
-    }
-    add_relaxed_operator(precondition, effects, &op, get_adjusted_cost(op));
+void LandmarkCutHeuristic::add_relaxed_operator(
+    const vector<int> &precondition, const vector<int> &effect, int cost) {
+    if (precondition.empty())
+        preconditions.push_back(artificial_precondition);
+    else
+        preconditions.insert(preconditions.end(), precondition.begin(),
+                             precondition.end());
+    precondition_begin.push_back(preconditions.size());
+    effects.insert(effects.end(), effect.begin(), effect.end());
+    effect_begin.push_back(effects.size());
+    base_cost.push_back(cost);
 }
 
-void LandmarkCutHeuristic::add_relaxed_operator(
-    const vector<RelaxedProposition *> &precondition,
-    const vector<RelaxedProposition *> &effects,
-    const Operator *op, int base_cost) {
-    RelaxedOperator relaxed_op(precondition, effects, op, base_cost);
-    if (relaxed_op.precondition.empty())
-        relaxed_op.precondition.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
+/*
+  Inverts the operator -> proposition lists given by begin and targets.
+  The operators of every proposition are in increasing order, as they
+  were when the lists were built by appending.
+*/
+void LandmarkCutHeuristic::build_cross_references(
+    const vector<int> &begin, const vector<int> &targets,
+    vector<int> &reverse_begin, vector<int> &reverse) const {
+    reverse_begin.assign(num_propositions + 1, 0);
+    for (int i = 0; i < targets.size(); i++)
+        ++reverse_begin[targets[i] + 1];
+    for (int prop = 0; prop < num_propositions; prop++)
+        reverse_begin[prop + 1] += reverse_begin[prop];
+    vector<int> next(reverse_begin.begin(), reverse_begin.end() - 1);
+    reverse.resize(targets.size());
+    for (int op = 0; op < num_operators; op++)
+        for (int i = begin[op]; i < begin[op + 1]; i++)
+            reverse[next[targets[i]]++] = op;
 }
 
 // heuristic computation
 void LandmarkCutHeuristic::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            RelaxedProposition &prop = propositions[var][value];
-            prop.status = UNREACHED;
-        }
-    }
+    for (int i = 0; i < num_propositions; i++)
+        propositions[i].status = UNREACHED;
 
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (int i = 0; i < relaxed_operators.size(); i++) {
+    for (int i = 0; i < num_operators; i++) {
         RelaxedOperator &op = relaxed_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.h_max_supporter = 0;
+        op.cost = base_cost[i] * COST_MULTIPLIER;
+        op.unsatisfied_preconditions =
+            precondition_begin[i + 1] - precondition_begin[i];
+        op.h_max_supporter = -1;
         op.h_max_supporter_cost = numeric_limits<int>::max();
     }
 }
 
-void LandmarkCutHeuristic::setup_exploration_queue_state(const State &state) {
-    for (int var = 0; var < propositions.size(); var++) {
-        RelaxedProposition *init_prop = &propositions[var][state[var]];
-        enqueue_if_necessary(init_prop, 0);
-    }
-    enqueue_if_necessary(&artificial_precondition, 0);
+void LandmarkCutHeuristic::setup_exploration_queue_state() {
+    for (int var = 0; var < initial_propositions.size(); var++)
+        enqueue_if_necessary(initial_propositions[var], 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
-void LandmarkCutHeuristic::first_exploration(const State &state) {
+void LandmarkCutHeuristic::first_exploration() {
     assert(priority_queue.empty());
     setup_exploration_queue();
-    setup_exploration_queue_state(state);
+    setup_exploration_queue_state();
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        int prop_cost = propositions[prop].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            RelaxedOperator *relaxed_op = triggered_operators[i];
-            relaxed_op->unsatisfied_preconditions--;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (int j = 0; j < relaxed_op->effects.size(); j++) {
-                    RelaxedProposition *effect = relaxed_op->effects[j];
-                    enqueue_if_necessary(effect, target_cost);
-                }
+        for (int i = precondition_of_begin[prop];
+             i < precondition_of_begin[prop + 1]; i++) {
+            int op_id = precondition_of[i];
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            relaxed_op.unsatisfied_preconditions--;
+            assert(relaxed_op.unsatisfied_preconditions >= 0);
+            if (relaxed_op.unsatisfied_preconditions == 0) {
+                relaxed_op.h_max_supporter = prop;
+                relaxed_op.h_max_supporter_cost = prop_cost;
+                enqueue_effects(op_id, prop_cost + relaxed_op.cost);
             }
         }
     }
 }
 
-void LandmarkCutHeuristic::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutHeuristic::first_exploration_incremental() {
     assert(priority_queue.empty());
     /* We pretend that this queue has had as many pushes already as we
        have propositions to avoid switching from bucket-based to
@@ -166,38 +187,31 @@ void LandmarkCutHeuristic::first_exploration_incremental(
     */
     priority_queue.add_virtual_pushes(num_propositions);
     for (int i = 0; i < cut.size(); i++) {
-        RelaxedOperator *relaxed_op = cut[i];
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (int j = 0; j < relaxed_op->effects.size(); j++) {
-            RelaxedProposition *effect = relaxed_op->effects[j];
-            enqueue_if_necessary(effect, cost);
-        }
+        const RelaxedOperator &relaxed_op = relaxed_operators[cut[i]];
+        enqueue_effects(cut[i],
+                        relaxed_op.h_max_supporter_cost + relaxed_op.cost);
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        int prop_cost = propositions[prop].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            RelaxedOperator *relaxed_op = triggered_operators[i];
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        for (int i = precondition_of_begin[prop];
+             i < precondition_of_begin[prop + 1]; i++) {
+            int op_id = precondition_of[i];
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            if (relaxed_op.h_max_supporter == prop) {
+                int old_supp_cost = relaxed_op.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(op_id);
+                    int new_supp_cost = relaxed_op.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (int j = 0; j < relaxed_op->effects.size(); j++) {
-                            RelaxedProposition *effect = relaxed_op->effects[j];
-                            enqueue_if_necessary(effect, target_cost);
-                        }
+                        enqueue_effects(op_id, new_supp_cost + relaxed_op.cost);
                     }
                 }
             }
@@ -205,46 +219,61 @@ void LandmarkCutHeuristic::first_exploration_incremental(
     }
 }
 
-void LandmarkCutHeuristic::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue, vector<RelaxedOperator *> &cut) {
-    assert(second_exploration_queue.empty());
+void LandmarkCutHeuristic::second_exploration() {
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
-
-    for (int var = 0; var < propositions.size(); var++) {
-        RelaxedProposition *init_prop = &propositions[var][state[var]];
-        init_prop->status = BEFORE_GOAL_ZONE;
-        second_exploration_queue.push_back(init_prop);
+    /* Every proposition enters the stack at most once per round, so
+       the preallocated buffer suffices. The hot loop works on raw
+       pointers, which the compiler can keep in registers even though
+       we store to other arrays. */
+    const int *eff_begin = &effect_begin[0];
+    const int *eff = &effects[0];
+    const RelaxedOperator *ops = &relaxed_operators[0];
+    int *stack = &second_exploration_queue[0];
+    int stack_size = 0;
+
+    unsigned int *zone = &zone_mark[0];
+    const unsigned int before_goal_zone = before_goal_zone_mark();
+    zone[artificial_precondition] = before_goal_zone;
+    stack[stack_size++] = artificial_precondition;
+    for (int var = 0; var < initial_propositions.size(); var++) {
+        int init_prop = initial_propositions[var];
+        zone[init_prop] = before_goal_zone;
+        stack[stack_size++] = init_prop;
     }
 
-    while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
-        second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            RelaxedOperator *relaxed_op = triggered_operators[i];
-            if (relaxed_op->h_max_supporter == prop) {
-                bool reached_goal_zone = false;
-                for (int j = 0; j < relaxed_op->effects.size(); j++) {
-                    RelaxedProposition *effect = relaxed_op->effects[j];
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
-                        reached_goal_zone = true;
-                        cut.push_back(relaxed_op);
-                        break;
-                    }
-                }
-                if (!reached_goal_zone) {
-                    for (int j = 0; j < relaxed_op->effects.size(); j++) {
-                        RelaxedProposition *effect = relaxed_op->effects[j];
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
-                            second_exploration_queue.push_back(effect);
-                        }
+    /* Group the operators by h^max supporter with a counting sort, so
+       that we visit only the operators supported by a proposition
+       instead of all operators it is a precondition of. Bucket 0 holds
+       the unreached operators, and the operators of proposition p end
+       up in supported[supported_begin[p]] up to (excluding)
+       supported[supported_begin[p + 1]], in increasing order. */
+    int *sup_begin = &supported_begin[0];
+    int *sup = &supported[0];
+    fill(sup_begin, sup_begin + num_propositions + 2, 0);
+    for (int op_id = 0; op_id < num_operators; ++op_id)
+        ++sup_begin[ops[op_id].h_max_supporter + 2];
+    for (int p = 0; p <= num_propositions; ++p)
+        sup_begin[p + 1] += sup_begin[p];
+    for (int op_id = 0; op_id < num_operators; ++op_id)
+        sup[sup_begin[ops[op_id].h_max_supporter + 1]++] = op_id;
+    while (stack_size) {
+        int prop = stack[--stack_size];
+        const int *op_end = sup + sup_begin[prop + 1];
+        for (const int *op_iter = sup + sup_begin[prop];
+             op_iter != op_end; ++op_iter) {
+            int op_id = *op_iter;
+            if (achieves_goal_zone[op_id] == current_round) {
+                assert(ops[op_id].cost > 0);
+                cut.push_back(op_id);
+            } else {
+                const int *effect_end = eff + eff_begin[op_id + 1];
+                for (const int *effect = eff + eff_begin[op_id];
+                     effect != effect_end; ++effect) {
+                    if (zone[*effect] != before_goal_zone) {
+                        assert(propositions[*effect].status == REACHED);
+                        zone[*effect] = before_goal_zone;
+                        stack[stack_size++] = *effect;
                     }
                 }
             }
@@ -252,17 +281,46 @@ void LandmarkCutHeuristic::second_exploration(
     }
 }
 
-void LandmarkCutHeuristic::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
-    // a zero-cost action that is relaxed unreachable. (This can only
-    // happen in domains which have zero-cost actions to start with.)
-    // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        const vector<RelaxedOperator *> &effect_of = subgoal->effect_of;
-        for (int i = 0; i < effect_of.size(); i++)
-            if (effect_of[i]->cost == 0)
-                mark_goal_plateau(effect_of[i]->h_max_supporter);
+void LandmarkCutHeuristic::start_round() {
+    // Every round uses two new marks, so the old ones become invalid
+    // without touching the propositions.
+    if (current_round == MAX_ROUND) {
+        fill(zone_mark.begin(), zone_mark.end(), 0);
+        fill(achieves_goal_zone.begin(), achieves_goal_zone.end(), 0);
+        current_round = 0;
+    }
+    ++current_round;
+}
+
+void LandmarkCutHeuristic::mark_goal_plateau() {
+    /*
+      Marks the artificial goal and everything that reaches it with
+      zero-cost operators from their h^max supporters. The marked set
+      does not depend on the order, so we use a stack instead of
+      recursion.
+
+      NOTE: a supporter can be missing (-1) if we got here through a
+      zero-cost action that is relaxed unreachable. (This can only
+      happen in domains which have zero-cost actions to start with.)
+      For example, this happens in pegsol-strips #01.
+    */
+    assert(goal_plateau_queue.empty());
+    start_round();
+    const unsigned int goal_zone = goal_zone_mark();
+    goal_plateau_queue.push_back(artificial_goal);
+    while (!goal_plateau_queue.empty()) {
+        int subgoal = goal_plateau_queue.back();
+        goal_plateau_queue.pop_back();
+        if (subgoal == -1 || zone_mark[subgoal] == goal_zone)
+            continue;
+        zone_mark[subgoal] = goal_zone;
+        for (int i = effect_of_begin[subgoal];
+             i < effect_of_begin[subgoal + 1]; i++) {
+            achieves_goal_zone[effect_of[i]] = current_round;
+            const RelaxedOperator &op = relaxed_operators[effect_of[i]];
+            if (op.cost == 0)
+                goal_plateau_queue.push_back(op.h_max_supporter);
+        }
     }
 }
 
@@ -271,26 +329,26 @@ void LandmarkCutHeuristic::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (int i = 0; i < relaxed_operators.size(); i++) {
-        const RelaxedOperator *op = &relaxed_operators[i];
-        const vector<RelaxedProposition *> &prec = op->precondition;
-        if (op->unsatisfied_preconditions) {
+    for (int i = 0; i < num_operators; i++) {
+        const RelaxedOperator &op = relaxed_operators[i];
+        int begin = precondition_begin[i], end = precondition_begin[i + 1];
+        if (op.unsatisfied_preconditions) {
             bool reachable = true;
-            for (int j = 0; j < prec.size(); j++) {
-                if (prec[j]->status == UNREACHED) {
+            for (int j = begin; j < end; j++) {
+                if (propositions[preconditions[j]].status == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op->h_max_supporter);
+            assert(op.h_max_supporter == -1);
         } else {
-            assert(op->h_max_supporter);
-            int h_max_cost = op->h_max_supporter_cost;
-            assert(h_max_cost == op->h_max_supporter->h_max_cost);
-            for (int j = 0; j < prec.size(); j++) {
-                assert(prec[j]->status != UNREACHED);
-                assert(prec[j]->h_max_cost <= h_max_cost);
+            assert(op.h_max_supporter != -1);
+            int h_max_cost = op.h_max_supporter_cost;
+            assert(h_max_cost == propositions[op.h_max_supporter].h_max_cost);
+            for (int j = begin; j < end; j++) {
+                assert(propositions[preconditions[j]].status != UNREACHED);
+                assert(propositions[preconditions[j]].h_max_cost <= h_max_cost);
             }
         }
     }
@@ -299,37 +357,29 @@ void LandmarkCutHeuristic::validate_h_max() const {
 
 int LandmarkCutHeuristic::compute_heuristic(const State &state) {
     // TODO: Possibly put back in some kind of preferred operator mechanism.
-    for (int i = 0; i < relaxed_operators.size(); i++) {
-        RelaxedOperator &op = relaxed_operators[i];
-        op.cost = op.base_cost * COST_MULTIPLIER;
-    }
+    for (int var = 0; var < initial_propositions.size(); var++)
+        initial_propositions[var] = proposition_offset[var] + state[var];
 
     //cout << "*" << flush;
     int total_cost = 0;
 
-    // The following two variables could be declared inside the loop
-    // ("second_exploration_queue" even inside second_exploration),
-    // but having them here saves reallocations and hence provides a
-    // measurable speed boost.
-    vector<RelaxedOperator *> cut;
-    vector<RelaxedProposition *> second_exploration_queue;
-    first_exploration(state);
+    first_exploration();
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (propositions[artificial_goal].status == UNREACHED)
         return DEAD_END;
 
     int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
+    while (propositions[artificial_goal].h_max_cost != 0) {
         num_iterations++;
-        //cout << "h_max = " << artificial_goal.h_max_cost << "..." << endl;
+        //cout << "h_max = " << propositions[artificial_goal].h_max_cost << "..." << endl;
         //cout << "total_cost = " << total_cost << "..." << endl;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau();
         assert(cut.empty());
-        second_exploration(state, second_exploration_queue, cut);
+        second_exploration();
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
         for (int i = 0; i < cut.size(); i++) {
-            cut_cost = min(cut_cost, cut[i]->cost);
+            cut_cost = min(cut_cost, relaxed_operators[cut[i]].cost);
             if (COST_MULTIPLIER > 1) {
                 /* We're using this "if" here because COST_MULTIPLIER
                    is currently a global constant and usually 1, which
@@ -352,34 +402,20 @@ int LandmarkCutHeuristic::compute_heuristic(const State &state) {
                    only be applicable in the unit-cost (or zero- and
                    unit-cost) case.
                 */
-                cut_cost = min(cut_cost, cut[i]->base_cost);
+                cut_cost = min(cut_cost, base_cost[cut[i]]);
             }
         }
         for (int i = 0; i < cut.size(); i++)
-            cut[i]->cost -= cut_cost;
+            relaxed_operators[cut[i]].cost -= cut_cost;
         //cout << "{" << cut_cost << "}" << flush;
         total_cost += cut_cost;
 
-        first_exploration_incremental(cut);
+        first_exploration_incremental();
         // validate_h_max();  // too expensive to use even in regular debug mode
         // TODO: Need better name for all explorations; e.g. this could
         //       be "recompute_h_max"; second_exploration could be
         //       "mark_zones" or whatever.
         cut.clear();
-
-        // TODO: Make this more efficient. For example, we can use
-        //       a round-dependent counter for GOAL_ZONE and BEFORE_GOAL_ZONE,
-        //       or something based on total_cost, in which case we don't
-        //       need a per-round reinitialization.
-        for (int var = 0; var < propositions.size(); var++) {
-            for (int value = 0; value < propositions[var].size(); value++) {
-                RelaxedProposition &prop = propositions[var][value];
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
-        }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     //cout << "[" << total_cost << "]" << flush;
     //cout << "**************************" << endl;
@@ -13,9 +13,6 @@
 class Operator;
 class State;
 
-class RelaxedProposition;
-class RelaxedOperator;
-
 class Options;
 /* TODO: Check the impact of using unary relaxed operators instead of
    multi-effect ones.
@@ -40,9 +37,7 @@ class Options;
 
 enum PropositionStatus {
     UNREACHED = 0,
-    REACHED = 1,
-    GOAL_ZONE = 2,
-    BEFORE_GOAL_ZONE = 3
+    REACHED = 1
 };
 
 const int COST_MULTIPLIER = 1;
@@ -57,31 +52,42 @@ const int COST_MULTIPLIER = 1;
    see the effect, though.
  */
 
-struct RelaxedOperator {
-    const Operator *op;
-    std::vector<RelaxedProposition *> precondition;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
+/*
+  The relaxed task is stored in flat arrays indexed by 32-bit ids
+  instead of objects linked by pointers. Propositions are numbered
+  variable by variable (see proposition_offset), followed by the
+  artificial precondition and the artificial goal. Relaxed operators
+  have the ids of g_operators, followed by the artificial goal
+  operator. The static cross references use a compressed sparse row
+  layout: the preconditions of operator op are
+  preconditions[precondition_begin[op]] up to (excluding)
+  preconditions[precondition_begin[op + 1]], and likewise for effects,
+  precondition_of and effect_of. The per-evaluation data of operators
+  and propositions lives in two small contiguous arrays.
+
+  Membership in the goal zone and in the zone before it is not stored
+  in the status but as a mark that is unique to the current round of
+  cut computation (see zone_mark), so nothing has to be reset between
+  rounds. In every round, the operators with an effect in the goal
+  zone are marked as well, and second_exploration follows the h^max
+  supporter edges through a list of operators grouped by supporter
+  that it builds in linear time.
+
+  All operator lists are in increasing order of ids. Ties between h^max
+  supporters depend on the order in which operators and propositions
+  are processed, so changing it changes the heuristic values.
+*/
 
+struct RelaxedOperator {
     int cost;
     int unsatisfied_preconditions;
+    int h_max_supporter; // proposition id, or -1 if unreached
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(const std::vector<RelaxedProposition *> &pre,
-                    const std::vector<RelaxedProposition *> &eff,
-                    const Operator *the_op, int base)
-        : op(the_op), precondition(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
 };
 
 struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
-    PropositionStatus status;
     int h_max_cost;
+    int status; // PropositionStatus
     /* TODO: Also add the rpg depth? The Python implementation used
        this for tie breaking, and it led to better landmark extraction
        than just using the cost. However, the Python implementation
@@ -99,54 +105,104 @@ struct RelaxedProposition {
        depths). See if the init h values degrade compared to Python
        without explicit depth tie-breaking, then decide.
     */
-
-    RelaxedProposition() {
-    }
 };
 
 class LandmarkCutHeuristic : public Heuristic {
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition> > propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    // Static structure of the relaxed task.
+    std::vector<int> proposition_offset;
+    int artificial_precondition;
+    int artificial_goal;
     int num_propositions;
-    AdaptiveQueue<RelaxedProposition *> priority_queue;
+    int num_operators;
+    std::vector<int> base_cost; // 0 for the artificial goal operator
+    std::vector<int> precondition_begin;
+    std::vector<int> preconditions;
+    std::vector<int> effect_begin;
+    std::vector<int> effects;
+    std::vector<int> precondition_of_begin;
+    std::vector<int> precondition_of;
+    std::vector<int> effect_of_begin;
+    std::vector<int> effect_of;
+
+    // Per-evaluation data. The buffers are reused across evaluations.
+    std::vector<RelaxedOperator> relaxed_operators;
+    std::vector<RelaxedProposition> propositions;
+    AdaptiveQueue<int> priority_queue;
+    std::vector<int> cut;
+    std::vector<int> second_exploration_queue;
+    std::vector<int> goal_plateau_queue;
+    std::vector<int> initial_propositions;
+    // Operators grouped by h^max supporter (CSR, rebuilt every round).
+    std::vector<int> supported_begin;
+    std::vector<int> supported;
+    // 2 * current_round for the goal zone, one more before the goal zone
+    std::vector<unsigned int> zone_mark;
+    // current_round if the operator has an effect in the goal zone
+    std::vector<unsigned int> achieves_goal_zone;
+    unsigned int current_round;
+    static const unsigned int MAX_ROUND = (~0u - 1) / 2;
+
+    unsigned int goal_zone_mark() const {
+        return 2 * current_round;
+    }
+    unsigned int before_goal_zone_mark() const {
+        return 2 * current_round + 1;
+    }
 
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
-    void build_relaxed_operator(const Operator &op);
-    void add_relaxed_operator(const std::vector<RelaxedProposition *> &precondition,
-                              const std::vector<RelaxedProposition *> &effects,
-                              const Operator *op, int base_cost);
+    void add_relaxed_operator(const std::vector<int> &precondition,
+                              const std::vector<int> &effect,
+                              int cost);
+    void build_cross_references(const std::vector<int> &begin,
+                                const std::vector<int> &targets,
+                                std::vector<int> &reverse_begin,
+                                std::vector<int> &reverse) const;
     void setup_exploration_queue();
-    void setup_exploration_queue_state(const State &state);
-    void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
-    void second_exploration(const State &state, std::vector<RelaxedProposition *> &queue,
-                            std::vector<RelaxedOperator *> &cut);
+    void setup_exploration_queue_state();
+    void first_exploration();
+    void first_exploration_incremental();
+    void second_exploration();
+    void start_round();
+    void mark_goal_plateau();
+    void validate_h_max() const;
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(int prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        RelaxedProposition &prop = propositions[prop_id];
+        if (prop.status == UNREACHED || prop.h_max_cost > cost) {
+            prop.status = REACHED;
+            prop.h_max_cost = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
-    void validate_h_max() const;
+    void enqueue_effects(int op_id, int cost) {
+        const int *begin = &effects[0] + effect_begin[op_id];
+        const int *end = &effects[0] + effect_begin[op_id + 1];
+        for (const int *effect = begin; effect != end; ++effect)
+            enqueue_if_necessary(*effect, cost);
+    }
+
+    inline void update_h_max_supporter(int op_id);
 public:
     LandmarkCutHeuristic(const Options &opts);
     virtual ~LandmarkCutHeuristic();
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (int i = 0; i < precondition.size(); i++)
-        if (precondition[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = precondition[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutHeuristic::update_h_max_supporter(int op_id) {
+    RelaxedOperator &op = relaxed_operators[op_id];
+    assert(!op.unsatisfied_preconditions);
+    int supporter_cost = propositions[op.h_max_supporter].h_max_cost;
+    for (int i = precondition_begin[op_id];
+         i < precondition_begin[op_id + 1]; ++i) {
+        int prop_cost = propositions[preconditions[i]].h_max_cost;
+        if (prop_cost > supporter_cost) {
+            op.h_max_supporter = preconditions[i];
+            supporter_cost = prop_cost;
+        }
+    }
+    op.h_max_supporter_cost = supporter_cost;
 }
 
 #endif
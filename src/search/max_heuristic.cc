@@ -42,53 +42,49 @@ void HSPMaxHeuristic::initialize() {
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (int var = 0; var < propositions.size(); var++) {
-        for (int value = 0; value < propositions[var].size(); value++) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-        }
-    }
+    for (int prop_id = 0; prop_id < propositions.size(); prop_id++)
+        propositions[prop_id].cost = -1;
 
-    // Deal with operators and axioms without preconditions.
     for (int i = 0; i < unary_operators.size(); i++) {
         UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
+        op.unsatisfied_preconditions = op.num_preconditions;
         op.cost = op.base_cost; // will be increased by precondition costs
+    }
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    // Deal with operators and axioms without preconditions.
+    for (int i = 0; i < unary_operators_without_preconditions.size(); i++) {
+        const UnaryOperator &op =
+            unary_operators[unary_operators_without_preconditions[i]];
+        enqueue_if_necessary(op.effect, op.base_cost);
     }
 }
 
 void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
-    for (int var = 0; var < propositions.size(); var++) {
-        Proposition *init_prop = &propositions[var][state[var]];
-        enqueue_if_necessary(init_prop, 0);
-    }
+    for (int var = 0; var < proposition_offsets.size(); var++)
+        enqueue_if_necessary(get_prop_id(var, state[var]), 0);
 }
 
 void HSPMaxHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        const Proposition &prop = propositions[top_pair.second];
+        int prop_cost = prop.cost;
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (prop.is_goal && --unsolved_goals == 0)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (int i = 0; i < triggered_operators.size(); i++) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            unary_op->unsatisfied_preconditions--;
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+        const int *triggered_operators = get_precondition_of(prop);
+        for (int i = 0; i < prop.num_precondition_of; i++) {
+            UnaryOperator &unary_op = unary_operators[triggered_operators[i]];
+            unary_op.unsatisfied_preconditions--;
+            unary_op.cost = max(unary_op.cost,
+                                unary_op.base_cost + prop_cost);
+            assert(unary_op.unsatisfied_preconditions >= 0);
+            if (unary_op.unsatisfied_preconditions == 0)
+                enqueue_if_necessary(unary_op.effect, unary_op.cost);
         }
     }
 }
@@ -100,7 +96,7 @@ int HSPMaxHeuristic::compute_heuristic(const State &state) {
 
     int total_cost = 0;
     for (int i = 0; i < goal_propositions.size(); i++) {
-        int prop_cost = goal_propositions[i]->cost;
+        int prop_cost = propositions[goal_propositions[i]].cost;
         if (prop_cost == -1)
             return DEAD_END;
         total_cost = max(total_cost, prop_cost);
@@ -6,19 +6,20 @@
 #include <cassert>
 
 class HSPMaxHeuristic : public RelaxationHeuristic {
-    AdaptiveQueue<Proposition *> queue;
+    AdaptiveQueue<int> queue; // proposition ids
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
 
-    void enqueue_if_necessary(Proposition *prop, int cost) {
+    void enqueue_if_necessary(int prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            queue.push(cost, prop);
+        Proposition &prop = propositions[prop_id];
+        if (prop.cost == -1 || prop.cost > cost) {
+            prop.cost = cost;
+            queue.push(cost, prop_id);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop.cost != -1 && prop.cost <= cost);
     }
 protected:
     virtual void initialize();
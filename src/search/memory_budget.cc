@@ -0,0 +1,94 @@
+#include "memory_budget.h"
+
+#include "globals.h"
+#include "option_parser.h"
+#include "utilities.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static const size_t BYTES_PER_KB = 1024;
+static const size_t BYTES_PER_MB = 1024 * 1024;
+
+void MemoryUsage::dump(ostream &os) const {
+    os << "state registry: " << state_registry / BYTES_PER_KB << " KB, "
+       << "per-state information: " << per_state_information / BYTES_PER_KB
+       << " KB, open list: " << open_list / BYTES_PER_KB << " KB";
+    if (message_buffers)
+        os << ", message buffers: " << message_buffers / BYTES_PER_KB << " KB";
+    os << " (total: " << get_total() / BYTES_PER_KB << " KB)";
+}
+
+MemoryBudget::MemoryBudget(const Options &opts)
+    : limit(g_memory_limit_in_mb * BYTES_PER_MB),
+      base_usage(0),
+      policy(Policy(opts.get_enum("memory_policy"))),
+      steps_until_check(CHECK_INTERVAL),
+      pruning(false) {
+    int margin = opts.get<int>("memory_margin");
+    if (margin < 0 || margin >= 100) {
+        cerr << "error: memory_margin must be in [0, 100)" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    soft_limit = limit / 100 * (100 - margin);
+}
+
+void MemoryBudget::start() {
+    if (limit == 0)
+        return;
+    int current_kb = get_current_memory_in_kb();
+    if (current_kb > 0)
+        base_usage = size_t(current_kb) * BYTES_PER_KB;
+    cout << "Memory limit: " << limit / BYTES_PER_MB << " MB, "
+         << "in use before search: " << base_usage / BYTES_PER_MB << " MB"
+         << endl;
+    if (base_usage >= soft_limit)
+        cout << "Warning: memory limit is reached before the search starts."
+             << endl;
+}
+
+bool MemoryBudget::is_exceeded(const MemoryUsage &usage) {
+    if (usage.get_total() > peak_usage.get_total())
+        peak_usage = usage;
+    return base_usage + usage.get_total() >= soft_limit;
+}
+
+void MemoryBudget::print_statistics() const {
+    if (limit == 0)
+        return;
+    cout << "Peak accounted search memory: ";
+    peak_usage.dump(cout);
+    cout << endl;
+}
+
+void MemoryBudget::add_options_to_parser(OptionParser &parser) {
+    vector<string> policies;
+    vector<string> policies_doc;
+    policies.push_back("STOP");
+    policies_doc.push_back(
+        "stop the search, print statistics and report the best solution "
+        "found so far");
+    policies.push_back("PRUNE");
+    policies_doc.push_back(
+        "drop stale and incumbent-dominated open list entries and stop "
+        "registering states that cannot improve the incumbent; stop if "
+        "this does not bring the usage below the margin");
+    policies.push_back("SPILL");
+    policies_doc.push_back(
+        "write the closed states to disk and continue with delayed "
+        "duplicate detection against them");
+    parser.add_enum_option(
+        "memory_policy",
+        policies,
+        "What to do when the search gets close to the limit given by "
+        "--memory-limit. Has no effect without a memory limit.",
+        "STOP",
+        policies_doc);
+    parser.add_option<int>(
+        "memory_margin",
+        "react when the memory usage is within this many percent "
+        "of --memory-limit",
+        "10");
+}
@@ -0,0 +1,122 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <cstddef>
+#include <iosfwd>
+
+class OptionParser;
+class Options;
+
+/*
+  Breakdown of the memory held by the main data structures of a search.
+  All values are in bytes and are estimates: they account for the
+  allocated storage of the containers, not for allocator overhead.
+
+  The registry part covers the state data pool and the hash table used
+  for duplicate detection, the per-state part covers everything stored in
+  PerStateInformation objects (search node infos, HDA* metadata, ...).
+  message_buffers is only used by the distributed search engines.
+*/
+struct MemoryUsage {
+    size_t state_registry;
+    size_t per_state_information;
+    size_t open_list;
+    size_t message_buffers;
+
+    MemoryUsage()
+        : state_registry(0), per_state_information(0), open_list(0),
+          message_buffers(0) {
+    }
+
+    size_t get_total() const {
+        return state_registry + per_state_information + open_list +
+               message_buffers;
+    }
+
+    void dump(std::ostream &os) const;
+};
+
+/*
+  MemoryBudget decides when a search engine has to react to a shrinking
+  amount of memory. The limit is given on the command line with
+  --memory-limit (in MB, see g_memory_limit_in_mb) and is compared
+  against the memory that was already in use when the search started
+  (heuristic tables, the task, ...) plus the current MemoryUsage of the
+  search data structures.
+
+  Once the usage gets within memory_margin percent of the limit, the
+  engine takes the action selected by memory_policy:
+    STOP:  stop the search in an orderly way, printing statistics and
+           reporting the best solution found so far (if any).
+    PRUNE: remove stale and incumbent-dominated entries from the open list
+           and stop registering states that cannot improve the incumbent.
+           If pruning does not bring the usage back below the margin, the
+           search stops as with STOP.
+    SPILL: write the closed states to disk (see ExternalClosedList) and
+           continue with the open states only. Stops as with STOP if the
+           open states alone exceed the margin. Heuristics that keep
+           per-state information (e.g. lmcount) lose it for the open
+           states, which are moved to a new StateRegistry.
+
+  Computing a MemoryUsage is not free, so engines should only do so when
+  check_due() returns true.
+*/
+class MemoryBudget {
+public:
+    enum Policy {
+        STOP = 0,
+        PRUNE = 1,
+        SPILL = 2
+    };
+private:
+    static const int CHECK_INTERVAL = 1000;
+
+    size_t limit;
+    size_t soft_limit;
+    size_t base_usage;
+    Policy policy;
+    int steps_until_check;
+    bool pruning;
+    MemoryUsage peak_usage;
+public:
+    explicit MemoryBudget(const Options &opts);
+
+    bool is_enabled() const {
+        return limit != 0;
+    }
+
+    /*
+      Remembers the memory that is in use before the search data
+      structures start growing. Should be called at the end of
+      SearchEngine::initialize().
+    */
+    void start();
+
+    bool check_due() {
+        if (limit == 0 || --steps_until_check > 0)
+            return false;
+        steps_until_check = CHECK_INTERVAL;
+        return true;
+    }
+
+    // Returns true if the usage is within the margin of the limit.
+    bool is_exceeded(const MemoryUsage &usage);
+
+    Policy get_policy() const {
+        return policy;
+    }
+
+    // Set once the PRUNE policy has been triggered.
+    bool is_pruning() const {
+        return pruning;
+    }
+    void start_pruning() {
+        pruning = true;
+    }
+
+    void print_statistics() const;
+
+    static void add_options_to_parser(OptionParser &parser);
+};
+
+#endif
@@ -88,6 +88,10 @@ using namespace __gnu_cxx;
 //        grep for it). It should only be defined once.
 static const int infinity = numeric_limits<int>::max();
 
+/* Below this number of states, transitions are built and mapped by one
+   thread. */
+static const int MIN_PARALLEL_STATES = 4096;
+
 inline int get_op_index(const Operator *op) {
     /* TODO: The op_index computation is duplicated from
      LabelReducer::get_op_index() and actually belongs neither
@@ -401,14 +405,23 @@ void Abstraction::normalize(bool reduce_labels) {
 //        cout << "without label reduction" << endl;
     }
 
-    typedef vector<pair<AbstractStateRef, int> > StateBucket;
-
-    /* First, partition by target state. Also replace operators by
-       their canonical representatives via label reduction and clear
-       away the transitions that have been processed. */
-    vector<StateBucket> target_buckets(num_states);
-    for (int op_no = 0; op_no < transitions_by_op.size(); op_no++) {
-        vector<AbstractTransition> &transitions = transitions_by_op[op_no];
+    /* The transitions are partitioned by target state, then by src state
+       and finally by operator, which sorts them and makes duplicates
+       adjacent. The buckets of each partition are stored contiguously in
+       one vector (counting sort), which avoids growing a vector per
+       state. */
+    typedef vector<pair<AbstractStateRef, int> > StateBuckets;
+
+    /* First, replace operators by their canonical representatives via
+       label reduction and count the transitions of each bucket. */
+    int num_ops = transitions_by_op.size();
+    vector<int> reduced_op_nos(num_ops, -1);
+    vector<int> num_reduced_transitions(num_ops, 0);
+    vector<int> target_bucket_end(num_states, 0);
+    vector<int> src_bucket_end(num_states, 0);
+    int num_transitions = 0;
+    for (int op_no = 0; op_no < num_ops; op_no++) {
+        const vector<AbstractTransition> &transitions = transitions_by_op[op_no];
         if (!transitions.empty()) {
             int reduced_op_no;
             if (reducer) {
@@ -418,34 +431,60 @@ void Abstraction::normalize(bool reduce_labels) {
             } else {
                 reduced_op_no = op_no;
             }
+            reduced_op_nos[op_no] = reduced_op_no;
+            num_reduced_transitions[reduced_op_no] += transitions.size();
+            num_transitions += transitions.size();
             for (int i = 0; i < transitions.size(); i++) {
                 const AbstractTransition &t = transitions[i];
-                target_buckets[t.target].push_back(
-                    make_pair(t.src, reduced_op_no));
+                ++target_bucket_end[t.target];
+                ++src_bucket_end[t.src];
             }
-            vector<AbstractTransition> ().swap(transitions);
         }
     }
+    for (AbstractStateRef state = 1; state < num_states; state++) {
+        target_bucket_end[state] += target_bucket_end[state - 1];
+        src_bucket_end[state] += src_bucket_end[state - 1];
+    }
 
-    // Second, partition by src state.
-    vector<StateBucket> src_buckets(num_states);
+    /* Partition by target state and clear away the transitions that have
+       been processed. Buckets are filled from their end, so afterwards
+       target_bucket_end[target] is the start of the bucket of target. */
+    StateBuckets target_buckets(num_transitions);
+    for (int op_no = num_ops - 1; op_no >= 0; op_no--) {
+        vector<AbstractTransition> &transitions = transitions_by_op[op_no];
+        int reduced_op_no = reduced_op_nos[op_no];
+        for (int i = transitions.size() - 1; i >= 0; i--) {
+            const AbstractTransition &t = transitions[i];
+            target_buckets[--target_bucket_end[t.target]] =
+                make_pair(t.src, reduced_op_no);
+        }
+        vector<AbstractTransition> ().swap(transitions);
+    }
 
-    for (AbstractStateRef target = 0; target < num_states; target++) {
-        StateBucket &bucket = target_buckets[target];
-        for (int i = 0; i < bucket.size(); i++) {
-            AbstractStateRef src = bucket[i].first;
-            int op_no = bucket[i].second;
-            src_buckets[src].push_back(make_pair(target, op_no));
+    // Second, partition by src state, again filling buckets from the end.
+    StateBuckets src_buckets(num_transitions);
+    int bucket_end = num_transitions;
+    for (AbstractStateRef target = num_states - 1; target >= 0; target--) {
+        int bucket_start = target_bucket_end[target];
+        for (int i = bucket_end - 1; i >= bucket_start; i--) {
+            AbstractStateRef src = target_buckets[i].first;
+            int op_no = target_buckets[i].second;
+            src_buckets[--src_bucket_end[src]] = make_pair(target, op_no);
         }
+        bucket_end = bucket_start;
     }
-    vector<StateBucket> ().swap(target_buckets);
+    StateBuckets ().swap(target_buckets);
 
     // Finally, partition by operator and drop duplicates.
+    for (int op_no = 0; op_no < num_ops; op_no++)
+        transitions_by_op[op_no].reserve(num_reduced_transitions[op_no]);
     for (AbstractStateRef src = 0; src < num_states; src++) {
-        StateBucket &bucket = src_buckets[src];
-        for (int i = 0; i < bucket.size(); i++) {
-            int target = bucket[i].first;
-            int op_no = bucket[i].second;
+        int bucket_start = src_bucket_end[src];
+        bucket_end = src + 1 < num_states ? src_bucket_end[src + 1] :
+                     num_transitions;
+        for (int i = bucket_start; i < bucket_end; i++) {
+            int target = src_buckets[i].first;
+            int op_no = src_buckets[i].second;
 
             vector<AbstractTransition> &op_bucket = transitions_by_op[op_no];
             AbstractTransition trans(src, target);
@@ -581,54 +620,65 @@ CompositeAbstraction::CompositeAbstraction(
     for (int i = 0; i < abs2->relevant_operators.size(); i++)
         abs2->relevant_operators[i]->marker2 = true;
 
-    int multiplier = abs2->size();
+    /* The transitions of the relevant operators are built with several
+       threads, one operator at a time. */
+    vector<int> relevant_op_nos;
     for (int op_no = 0; op_no < g_operators.size(); op_no++) {
+        const Operator *op = &g_operators[op_no];
+        if (op->marker1 || op->marker2) {
+            relevant_operators.push_back(op);
+            relevant_op_nos.push_back(op_no);
+        }
+    }
+
+    int multiplier = abs2->size();
+    int num_relevant_ops = relevant_op_nos.size();
+#pragma omp parallel for schedule(dynamic) if (num_states >= MIN_PARALLEL_STATES)
+    for (int k = 0; k < num_relevant_ops; k++) {
+        int op_no = relevant_op_nos[k];
         const Operator *op = &g_operators[op_no];
         bool relevant1 = op->marker1;
         bool relevant2 = op->marker2;
-        if (relevant1 || relevant2) {
-            vector<AbstractTransition> &transitions = transitions_by_op[op_no];
-            relevant_operators.push_back(op);
-            const vector<AbstractTransition> &bucket1 =
-                abs1->transitions_by_op[op_no];
-            const vector<AbstractTransition> &bucket2 =
-                abs2->transitions_by_op[op_no];
-            if (relevant1 && relevant2) {
-                transitions.reserve(bucket1.size() * bucket2.size());
-                for (int i = 0; i < bucket1.size(); i++) {
-                    int src1 = bucket1[i].src;
-                    int target1 = bucket1[i].target;
-                    for (int j = 0; j < bucket2.size(); j++) {
-                        int src2 = bucket2[j].src;
-                        int target2 = bucket2[j].target;
-                        int src = src1 * multiplier + src2;
-                        int target = target1 * multiplier + target2;
-                        transitions.push_back(AbstractTransition(src, target));
-                    }
+        vector<AbstractTransition> &transitions = transitions_by_op[op_no];
+        const vector<AbstractTransition> &bucket1 =
+            abs1->transitions_by_op[op_no];
+        const vector<AbstractTransition> &bucket2 =
+            abs2->transitions_by_op[op_no];
+        if (relevant1 && relevant2) {
+            transitions.reserve(bucket1.size() * bucket2.size());
+            for (int i = 0; i < bucket1.size(); i++) {
+                int src1 = bucket1[i].src;
+                int target1 = bucket1[i].target;
+                for (int j = 0; j < bucket2.size(); j++) {
+                    int src2 = bucket2[j].src;
+                    int target2 = bucket2[j].target;
+                    int src = src1 * multiplier + src2;
+                    int target = target1 * multiplier + target2;
+                    transitions.push_back(AbstractTransition(src, target));
                 }
-            } else if (relevant1) {
-                assert(!relevant2);
-                transitions.reserve(bucket1.size() * abs2->size());
-                for (int i = 0; i < bucket1.size(); i++) {
-                    int src1 = bucket1[i].src;
-                    int target1 = bucket1[i].target;
-                    for (int s2 = 0; s2 < abs2->size(); s2++) {
-                        int src = src1 * multiplier + s2;
-                        int target = target1 * multiplier + s2;
-                        transitions.push_back(AbstractTransition(src, target));
-                    }
+            }
+        } else if (relevant1) {
+            assert(!relevant2);
+            transitions.reserve(bucket1.size() * abs2->size());
+            for (int i = 0; i < bucket1.size(); i++) {
+                int src1 = bucket1[i].src;
+                int target1 = bucket1[i].target;
+                for (int s2 = 0; s2 < abs2->size(); s2++) {
+                    int src = src1 * multiplier + s2;
+                    int target = target1 * multiplier + s2;
+                    transitions.push_back(AbstractTransition(src, target));
                 }
-            } else if (relevant2) {
-                assert(!relevant1);
-                transitions.reserve(bucket2.size() * abs1->size());
-                for (int i = 0; i < bucket2.size(); i++) {
-                    int src2 = bucket2[i].src;
-                    int target2 = bucket2[i].target;
-                    for (int s1 = 0; s1 < abs1->size(); s1++) {
-                        int src = s1 * multiplier + src2;
-                        int target = s1 * multiplier + target2;
-                        transitions.push_back(AbstractTransition(src, target));
-                    }
+            }
+        } else if (relevant2) {
+            assert(!relevant1);
+            transitions.reserve(bucket2.size() * abs1->size());
+            for (int i = 0; i < bucket2.size(); i++) {
+                int src2 = bucket2[i].src;
+                int target2 = bucket2[i].target;
+                for (int s1 = 0; s1 < abs1->size(); s1++) {
+                    int src = s1 * multiplier + src2;
+                    int target = s1 * multiplier + target2;
+                    transitions.push_back(AbstractTransition(src, target));
                 }
             }
         }
@@ -669,6 +719,53 @@ AbstractStateRef CompositeAbstraction::get_abstract_state(const State &state) co
     return lookup_table[state1][state2];
 }
 
+int Abstraction::add_lookup_node(
+    AbstractionLookupNode &node, vector<AbstractionLookupNode> &nodes,
+    vector<const Abstraction *> &node_abstractions) const {
+    node.table_offset = 0;
+    if (!nodes.empty())
+        node.table_offset = nodes.back().table_offset + nodes.back().table_size;
+    nodes.push_back(node);
+    node_abstractions.push_back(this);
+    return nodes.size() - 1;
+}
+
+int AtomicAbstraction::add_lookup_nodes(
+    vector<AbstractionLookupNode> &nodes,
+    vector<const Abstraction *> &node_abstractions) const {
+    AbstractionLookupNode node;
+    node.variable = variable;
+    node.components[0] = node.components[1] = -1;
+    node.num_columns = 1;
+    node.table_size = lookup_table.size();
+    return add_lookup_node(node, nodes, node_abstractions);
+}
+
+int CompositeAbstraction::add_lookup_nodes(
+    vector<AbstractionLookupNode> &nodes,
+    vector<const Abstraction *> &node_abstractions) const {
+    AbstractionLookupNode node;
+    node.variable = -1;
+    for (int i = 0; i < 2; ++i)
+        node.components[i] = components[i]->add_lookup_nodes(
+            nodes, node_abstractions);
+    // All rows have the size of the second component when it was merged.
+    node.num_columns = lookup_table.empty() ? 0 : lookup_table[0].size();
+    node.table_size = lookup_table.size() * size_t(node.num_columns);
+    return add_lookup_node(node, nodes, node_abstractions);
+}
+
+void AtomicAbstraction::write_lookup_table(int *table) const {
+    copy(lookup_table.begin(), lookup_table.end(), table);
+}
+
+void CompositeAbstraction::write_lookup_table(int *table) const {
+    for (size_t row = 0; row < lookup_table.size(); ++row) {
+        assert(lookup_table[row].size() == lookup_table[0].size());
+        table = copy(lookup_table[row].begin(), lookup_table[row].end(), table);
+    }
+}
+
 void Abstraction::apply_abstraction(
     vector<slist<AbstractStateRef> > &collapsed_groups) {
     /* Note on how this method interacts with the distance information
@@ -752,7 +849,9 @@ void Abstraction::apply_abstraction(
 
     vector<vector<AbstractTransition> > new_transitions_by_op(
         transitions_by_op.size());
-    for (int op_no = 0; op_no < transitions_by_op.size(); op_no++) {
+    int num_ops = transitions_by_op.size();
+#pragma omp parallel for schedule(dynamic) if (num_states >= MIN_PARALLEL_STATES)
+    for (int op_no = 0; op_no < num_ops; op_no++) {
         const vector<AbstractTransition> &transitions =
             transitions_by_op[op_no];
         vector<AbstractTransition> &new_transitions =
@@ -798,6 +897,36 @@ int Abstraction::get_cost(const State &state) const {
     return cost;
 }
 
+size_t Abstraction::get_lookup_size() const {
+    vector<AbstractionLookupNode> nodes;
+    vector<const Abstraction *> node_abstractions;
+    add_lookup_nodes(nodes, node_abstractions);
+    size_t num_table_entries = nodes.back().table_offset + nodes.back().table_size;
+    return sizeof(AbstractionLookupHeader) +
+           nodes.size() * sizeof(AbstractionLookupNode) +
+           (num_table_entries + goal_distances.size()) * sizeof(int);
+}
+
+void Abstraction::write_lookup(char *block) const {
+    vector<AbstractionLookupNode> nodes;
+    vector<const Abstraction *> node_abstractions;
+    add_lookup_nodes(nodes, node_abstractions);
+
+    AbstractionLookupHeader *header =
+        reinterpret_cast<AbstractionLookupHeader *>(block);
+    header->num_nodes = nodes.size();
+    header->num_table_entries = nodes.back().table_offset + nodes.back().table_size;
+    header->num_abstract_states = goal_distances.size();
+    AbstractionLookupNode *lookup_nodes =
+        reinterpret_cast<AbstractionLookupNode *>(header + 1);
+    copy(nodes.begin(), nodes.end(), lookup_nodes);
+    int *tables = reinterpret_cast<int *>(lookup_nodes + nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+        node_abstractions[i]->write_lookup_table(tables + nodes[i].table_offset);
+    copy(goal_distances.begin(), goal_distances.end(),
+         tables + header->num_table_entries);
+}
+
 int Abstraction::get_abst_id(const State &state) const {
     return get_abstract_state(state);
 }
@@ -1,6 +1,7 @@
 #ifndef MERGE_AND_SHRINK_ABSTRACTION_H
 #define MERGE_AND_SHRINK_ABSTRACTION_H
 
+#include "abstraction_lookup.h"
 #include "shrink_strategy.h"
 
 #include "../operator_cost.h"
@@ -75,6 +76,16 @@ protected:
     std::vector<int> varset;
 
     virtual AbstractStateRef get_abstract_state(const State &state) const = 0;
+    /* Appends the lookup nodes of the merge tree below this abstraction
+       and of the abstraction itself, and returns the id of the latter. */
+    virtual int add_lookup_nodes(
+        std::vector<AbstractionLookupNode> &nodes,
+        std::vector<const Abstraction *> &node_abstractions) const = 0;
+    int add_lookup_node(
+        AbstractionLookupNode &node,
+        std::vector<AbstractionLookupNode> &nodes,
+        std::vector<const Abstraction *> &node_abstractions) const;
+    virtual void write_lookup_table(int *table) const = 0;
     virtual void apply_abstraction_to_lookup_table(const std::vector<
                                                        AbstractStateRef> &abstraction_mapping) = 0;
     virtual int memory_estimate() const;
@@ -94,6 +105,9 @@ public:
     bool is_solvable() const;
 
     int get_cost(const State &state) const;
+    // Size and contents of the block read by AbstractionLookup.
+    size_t get_lookup_size() const;
+    void write_lookup(char *block) const;
     int get_abst_id(const State &state) const;
 
     int size() const;
@@ -152,6 +166,10 @@ protected:
     virtual void apply_abstraction_to_lookup_table(const std::vector<
                                                        AbstractStateRef> &abstraction_mapping);
     virtual AbstractStateRef get_abstract_state(const State &state) const;
+    virtual int add_lookup_nodes(
+        std::vector<AbstractionLookupNode> &nodes,
+        std::vector<const Abstraction *> &node_abstractions) const;
+    virtual void write_lookup_table(int *table) const;
     virtual int memory_estimate() const;
 public:
     AtomicAbstraction(bool is_unit_cost, OperatorCost cost_type, int variable);
@@ -166,6 +184,10 @@ protected:
     virtual void apply_abstraction_to_lookup_table(
         const std::vector<AbstractStateRef> &abstraction_mapping);
     virtual AbstractStateRef get_abstract_state(const State &state) const;
+    virtual int add_lookup_nodes(
+        std::vector<AbstractionLookupNode> &nodes,
+        std::vector<const Abstraction *> &node_abstractions) const;
+    virtual void write_lookup_table(int *table) const;
     virtual int memory_estimate() const;
 public:
     CompositeAbstraction(
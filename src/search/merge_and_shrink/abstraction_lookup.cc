@@ -0,0 +1,79 @@
+#include "abstraction_lookup.h"
+
+#include "../state.h"
+
+#include <cassert>
+#include <limits>
+using namespace std;
+
+// Same as Abstraction::PRUNED_STATE.
+static const int PRUNED_STATE = -1;
+
+AbstractionLookup::AbstractionLookup(const char *block) {
+    const AbstractionLookupHeader *header =
+        reinterpret_cast<const AbstractionLookupHeader *>(block);
+    num_nodes = header->num_nodes;
+    nodes = reinterpret_cast<const AbstractionLookupNode *>(header + 1);
+    tables = reinterpret_cast<const int *>(nodes + num_nodes);
+    goal_distances = tables + header->num_table_entries;
+    assert(num_nodes > 0);
+}
+
+AbstractionLookup::~AbstractionLookup() {
+}
+
+int AbstractionLookup::get_cost(const State &state) const {
+    node_states.resize(num_nodes);
+    for (int i = 0; i < num_nodes; ++i) {
+        const AbstractionLookupNode &node = nodes[i];
+        const int *table = tables + node.table_offset;
+        if (node.variable != -1) {
+            node_states[i] = table[state[node.variable]];
+            continue;
+        }
+        int state1 = node_states[node.components[0]];
+        int state2 = node_states[node.components[1]];
+        if (state1 == PRUNED_STATE || state2 == PRUNED_STATE)
+            node_states[i] = PRUNED_STATE;
+        else
+            node_states[i] = table[size_t(state1) * node.num_columns + state2];
+    }
+    int abstract_state = node_states[num_nodes - 1];
+    if (abstract_state == PRUNED_STATE)
+        return -1;
+    assert(goal_distances[abstract_state] != numeric_limits<int>::max());
+    return goal_distances[abstract_state];
+}
+
+void AbstractionLookup::get_costs(const State *states, int n,
+                                  int *result) const {
+    node_states.resize(size_t(num_nodes) * n);
+    for (int i = 0; i < num_nodes; ++i) {
+        const AbstractionLookupNode &node = nodes[i];
+        const int *table = tables + node.table_offset;
+        int *current = &node_states[size_t(i) * n];
+        if (node.variable != -1) {
+            for (int j = 0; j < n; ++j)
+                current[j] = table[states[j][node.variable]];
+            continue;
+        }
+        const int *states1 = &node_states[size_t(node.components[0]) * n];
+        const int *states2 = &node_states[size_t(node.components[1]) * n];
+        for (int j = 0; j < n; ++j) {
+            if (states1[j] == PRUNED_STATE || states2[j] == PRUNED_STATE)
+                current[j] = PRUNED_STATE;
+            else
+                current[j] = table[size_t(states1[j]) * node.num_columns +
+                                   states2[j]];
+        }
+    }
+    const int *final_states = &node_states[size_t(num_nodes - 1) * n];
+    for (int j = 0; j < n; ++j) {
+        if (final_states[j] == PRUNED_STATE) {
+            result[j] = -1;
+        } else {
+            result[j] = goal_distances[final_states[j]];
+            assert(result[j] != numeric_limits<int>::max());
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef MERGE_AND_SHRINK_ABSTRACTION_LOOKUP_H
+#define MERGE_AND_SHRINK_ABSTRACTION_LOOKUP_H
+
+#include <cstddef>
+#include <vector>
+
+class State;
+
+/*
+  The part of a final abstraction that is needed to look up goal
+  distances, stored in one block of memory without pointers, so that it
+  can be placed in memory shared by the MPI ranks of a node (see
+  Abstraction::write_lookup). The block consists of an
+  AbstractionLookupHeader, one AbstractionLookupNode per abstraction in
+  the merge tree (components before the abstractions they are merged
+  into, the final abstraction last), the lookup tables of all nodes and
+  the goal distances of the final abstraction.
+*/
+
+struct AbstractionLookupHeader {
+    size_t num_nodes;
+    size_t num_table_entries;
+    size_t num_abstract_states;
+};
+
+struct AbstractionLookupNode {
+    int variable; // -1 for composite abstractions
+    int components[2]; // node ids for composite abstractions
+    int num_columns; // row length of the lookup table of composites
+    size_t table_offset;
+    size_t table_size;
+};
+
+class AbstractionLookup {
+    const AbstractionLookupNode *nodes;
+    int num_nodes;
+    const int *tables;
+    const int *goal_distances;
+    // Abstract states of all nodes, node by node.
+    mutable std::vector<int> node_states;
+public:
+    // The block must outlive the lookup.
+    explicit AbstractionLookup(const char *block);
+    ~AbstractionLookup();
+
+    // Both return -1 for states pruned by the abstraction.
+    int get_cost(const State &state) const;
+    void get_costs(const State *states, int n, int *result) const;
+};
+
+#endif
@@ -5,12 +5,17 @@
 #include "variable_order_finder.h"
 
 #include "../globals.h"
+#include "../heuristic_cache.h"
+#include "../node_shared_memory.h"
 #include "../option_parser.h"
 #include "../plugin.h"
+#include "../rng.h"
 #include "../state.h"
 #include "../timer.h"
 
 #include <cassert>
+#include <cstring>
+#include <sstream>
 #include <vector>
 using namespace std;
 
@@ -20,10 +25,18 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
       merge_strategy(MergeStrategy(opts.get_enum("merge_strategy"))),
       shrink_strategy(opts.get<ShrinkStrategy *>("shrink_strategy")),
       use_label_reduction(opts.get<bool>("reduce_labels")),
-      use_expensive_statistics(opts.get<bool>("expensive_statistics")) {
+      use_expensive_statistics(opts.get<bool>("expensive_statistics")),
+      shared(opts.get<bool>("shared")),
+      cache_dir(HeuristicCache::get_directory(opts)),
+      cache(0),
+      shared_block(0),
+      lookup(0) {
 }
 
 MergeAndShrinkHeuristic::~MergeAndShrinkHeuristic() {
+    delete lookup;
+    delete shared_block;
+    delete cache;
 }
 
 void MergeAndShrinkHeuristic::dump_options() const {
@@ -56,7 +69,7 @@ void MergeAndShrinkHeuristic::dump_options() const {
         ABORT("Unknown merge strategy.");
     }
     cout << endl;
-    shrink_strategy->dump_options();
+    shrink_strategy->dump_options(cout);
     cout << "Label reduction: "
          << (use_label_reduction ? "enabled" : "disabled") << endl
          << "Expensive statistics: "
@@ -173,24 +186,100 @@ void MergeAndShrinkHeuristic::initialize() {
 
     verify_no_axioms_no_cond_effects();
 
+    build_lookup();
+
+    cout << "Done initializing merge-and-shrink heuristic [" << timer << "]"
+         << endl << "initial h value: " << compute_heuristic(g_initial_state()) << endl;
+}
+
+void MergeAndShrinkHeuristic::build_lookup() {
+    if (shared && !is_node_leader()) {
+        cout << "Using the abstraction of the node leader..." << endl;
+        shared_block = new NodeSharedBlock(0);
+        shared_block->publish();
+        lookup = new AbstractionLookup(shared_block->get_data());
+        return;
+    }
+
+    if (!cache_dir.empty()) {
+        cache = new HeuristicCache(cache_dir, get_cache_key());
+        if (cache->load()) {
+            cout << "Loaded abstraction from " << cache->get_filename() << endl;
+            size_t size = cache->get_size();
+            const char *block = cache->get_data();
+            if (shared) {
+                shared_block = new NodeSharedBlock(size);
+                memcpy(shared_block->get_writable_data(), block, size);
+                shared_block->publish();
+                block = shared_block->get_data();
+                delete cache;
+                cache = 0;
+            }
+            lookup = new AbstractionLookup(block);
+            cout << "Abstraction lookup tables: " << size << " bytes"
+                 << (shared ? " (shared by the node)" : "") << endl;
+            return;
+        }
+    }
+
     cout << "Building abstraction..." << endl;
-    final_abstraction = build_abstraction();
+    Abstraction *final_abstraction = build_abstraction();
     if (!final_abstraction->is_solvable()) {
         cout << "Abstract problem is unsolvable!" << endl;
     }
-
-    cout << "Done initializing merge-and-shrink heuristic [" << timer << "]"
-         << endl << "initial h value: " << compute_heuristic(g_initial_state()) << endl;
     cout << "Estimated peak memory for abstraction: " << final_abstraction->get_peak_memory_estimate() << " bytes" << endl;
+
+    size_t size = final_abstraction->get_lookup_size();
+    char *block;
+    if (shared) {
+        shared_block = new NodeSharedBlock(size);
+        block = shared_block->get_writable_data();
+    } else {
+        lookup_block.resize(size);
+        block = &lookup_block[0];
+    }
+    final_abstraction->write_lookup(block);
+    if (cache) {
+        cache->save(block, size);
+        delete cache;
+        cache = 0;
+    }
+    if (shared)
+        shared_block->publish();
+    lookup = new AbstractionLookup(block);
+    cout << "Abstraction lookup tables: " << size << " bytes"
+         << (shared ? " (shared by the node)" : "") << endl;
+    // The lookup tables of the components are still leaked (see
+    // build_abstraction).
+    delete final_abstraction;
+}
+
+string MergeAndShrinkHeuristic::get_cache_key() const {
+    ostringstream key;
+    key << "merge_and_shrink" << endl
+        << "Merge strategy: " << merge_strategy << endl;
+    shrink_strategy->dump_options(key);
+    key << "Label reduction: " << use_label_reduction << endl
+        << "Cost type: " << cost_type << endl
+        << "Random state: " << g_rng.get_state_hash() << endl;
+    return key.str();
 }
 
 int MergeAndShrinkHeuristic::compute_heuristic(const State &state) {
-    int cost = final_abstraction->get_cost(state);
+    int cost = lookup->get_cost(state);
     if (cost == -1)
         return DEAD_END;
     return cost;
 }
 
+void MergeAndShrinkHeuristic::compute_heuristic_batch(
+    const State *states, int n, int *out) {
+    lookup->get_costs(states, n, out);
+    for (int i = 0; i < n; ++i)
+        if (out[i] == -1)
+            out[i] = DEAD_END;
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Merge-and-shrink heuristic",
@@ -285,6 +374,12 @@ static Heuristic *_parse(OptionParser &parser) {
                             "prints a big warning on stderr with information on the performance impact. "
                             "Don't use when benchmarking!)",
                             "false");
+    parser.add_option<bool>("shared",
+                            "build the abstraction only on one MPI rank per node and "
+                            "share its lookup tables with the other ranks of the node. "
+                            "All ranks must then be given the same heuristics.",
+                            "false");
+    HeuristicCache::add_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.help_mode())
@@ -5,7 +5,13 @@
 
 #include "../heuristic.h"
 
+#include <string>
+#include <vector>
+
 class Abstraction;
+class AbstractionLookup;
+class HeuristicCache;
+class NodeSharedBlock;
 
 enum MergeStrategy {
     MERGE_LINEAR_CG_GOAL_LEVEL,
@@ -22,15 +28,32 @@ class MergeAndShrinkHeuristic : public Heuristic {
     ShrinkStrategy *const shrink_strategy;
     const bool use_label_reduction;
     const bool use_expensive_statistics;
-
-    Abstraction *final_abstraction;
+    const bool shared;
+    const std::string cache_dir;
+
+    /* The lookup block of the final abstraction, either in lookup_block,
+       in a cache file from an earlier run (with cache_dir) or, if shared,
+       in memory shared by the MPI ranks of the node. Only the node leader
+       builds or loads the abstraction then. */
+    std::vector<char> lookup_block;
+    HeuristicCache *cache;
+    NodeSharedBlock *shared_block;
+    AbstractionLookup *lookup;
     Abstraction *build_abstraction();
+    void build_lookup();
+
+    /* The options that the abstraction depends on, and the state of the
+       random number generator, since the merge and shrink strategies
+       may break ties randomly. */
+    std::string get_cache_key() const;
 
     void dump_options() const;
     void warn_on_unusual_options() const;
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual void compute_heuristic_batch(const State *states, int n,
+                                         int *out);
 public:
     MergeAndShrinkHeuristic(const Options &opts);
     ~MergeAndShrinkHeuristic();
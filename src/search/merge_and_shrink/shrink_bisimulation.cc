@@ -5,11 +5,16 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
 #include <ext/hash_map>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace __gnu_cxx;
 
@@ -78,18 +83,165 @@ struct Signature {
 };
 
 
-// TODO: This is a general tool that probably belongs somewhere else.
+/* Below this number of states, signatures are computed by one thread. */
+static const int MIN_PARALLEL_STATES = 4096;
+
+/* Returns the number of threads to use for an abstraction with
+   num_states states. With one thread, the sequential code paths are
+   taken, which avoid the overhead of the parallel ones. */
+static int get_num_threads(int num_states) {
+#ifdef _OPENMP
+    if (num_states >= MIN_PARALLEL_STATES)
+        return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+/* Sorts with several threads: the chunks are sorted in parallel and
+   then merged pairwise, in parallel within each round. The elements
+   must be totally ordered (Signature is, by the state), so that the
+   result is the same as with a sequential sort. */
 template<class T>
-void release_memory(vector<T> &vec) {
-    vector<T>().swap(vec);
+static void parallel_sort(vector<T> &elements, int num_threads) {
+    const size_t min_chunk_size = 16384;
+    const int max_num_chunks = 64;
+    int num_chunks = min(size_t(max_num_chunks),
+                         max(size_t(1), elements.size() / min_chunk_size));
+    if (num_threads == 1 || num_chunks == 1) {
+        ::sort(elements.begin(), elements.end());
+        return;
+    }
+    vector<size_t> bounds(num_chunks + 1);
+    for (int i = 0; i <= num_chunks; ++i)
+        bounds[i] = elements.size() * i / num_chunks;
+    typename vector<T>::iterator begin = elements.begin();
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    for (int i = 0; i < num_chunks; ++i)
+        ::sort(begin + bounds[i], begin + bounds[i + 1]);
+    for (int width = 1; width < num_chunks; width *= 2) {
+        // The last rounds have only one merge each.
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) if (num_chunks - width > 2 * width)
+        for (int i = 0; i < num_chunks - width; i += 2 * width) {
+            int end = min(i + 2 * width, num_chunks);
+            ::inplace_merge(begin + bounds[i], begin + bounds[i + width],
+                            begin + bounds[end]);
+        }
+    }
+}
+
+/* Whether a transition contributes to the successor signature of its
+   source state. Greedy bisimulation only considers transitions on
+   optimal paths. */
+static inline bool is_signature_transition(
+    const Abstraction &abs, bool greedy, int op_cost,
+    const AbstractTransition &trans) {
+    if (!greedy)
+        return true;
+    int src_h = abs.get_goal_distance(trans.src);
+    int target_h = abs.get_goal_distance(trans.target);
+    assert(target_h + op_cost >= src_h);
+    return target_h + op_cost == src_h;
+}
+
+/* Adds the number of successor signature entries contributed by the
+   operators op_begin, ..., op_end - 1 to num_entries[state]. */
+static void count_signature_entries(
+    const Abstraction &abs, bool greedy, int op_begin, int op_end,
+    vector<int> &num_entries) {
+    for (int op_no = op_begin; op_no < op_end; ++op_no) {
+        const vector<AbstractTransition> &transitions =
+            abs.get_transitions_for_op(op_no);
+        int op_cost = abs.get_cost_for_op(op_no);
+        for (size_t i = 0; i < transitions.size(); ++i) {
+            const AbstractTransition &trans = transitions[i];
+            if (is_signature_transition(abs, greedy, op_cost, trans))
+                ++num_entries[trans.src];
+        }
+    }
 }
 
+/* Writes the successor signature entries contributed by the operators
+   op_begin, ..., op_end - 1 into entries, those of each state from
+   position next_entry[state] on, and advances next_entry. */
+static void place_signature_entries(
+    const Abstraction &abs, bool greedy, const vector<int> &state_to_group,
+    int op_begin, int op_end, vector<int> &next_entry,
+    vector<pair<int, int> > &entries) {
+    for (int op_no = op_begin; op_no < op_end; ++op_no) {
+        const vector<AbstractTransition> &transitions =
+            abs.get_transitions_for_op(op_no);
+        int op_cost = abs.get_cost_for_op(op_no);
+        for (size_t i = 0; i < transitions.size(); ++i) {
+            const AbstractTransition &trans = transitions[i];
+            if (is_signature_transition(abs, greedy, op_cost, trans))
+                entries[next_entry[trans.src]++] = make_pair(
+                    op_no, state_to_group[trans.target]);
+        }
+    }
+}
+
+/* Compares and hashes successor signatures given by a representative
+   state, for the hash tables of refine_with_hashing. */
+class SuccessorSignatureTable {
+    const vector<int> &succ_sig_start;
+    const vector<int> &succ_sig_size;
+    const vector<pair<int, int> > &entries;
+public:
+    SuccessorSignatureTable(const vector<int> &succ_sig_start_,
+                            const vector<int> &succ_sig_size_,
+                            const vector<pair<int, int> > &entries_)
+        : succ_sig_start(succ_sig_start_), succ_sig_size(succ_sig_size_),
+          entries(entries_) {
+    }
+
+    // hash function adapted from Python's hash function for tuples.
+    size_t operator()(int state) const {
+        const pair<int, int> *sig = &entries[0] + succ_sig_start[state];
+        size_t hash_value = 0x345678;
+        size_t mult = 1000003;
+        for (int i = succ_sig_size[state] - 1; i >= 0; --i) {
+            hash_value = (hash_value ^ sig[i].first) * mult;
+            mult += 82520 + i + i;
+            hash_value = (hash_value ^ sig[i].second) * mult;
+            mult += 82520 + i + i;
+        }
+        hash_value += 97531;
+        return hash_value;
+    }
+
+    bool operator()(int state1, int state2) const {
+        const pair<int, int> *sig1 = &entries[0] + succ_sig_start[state1];
+        const pair<int, int> *sig2 = &entries[0] + succ_sig_start[state2];
+        return succ_sig_size[state1] == succ_sig_size[state2] &&
+               ::equal(sig1, sig1 + succ_sig_size[state1], sig2);
+    }
+
+    // Same order as for SuccessorSignature.
+    bool less(int state1, int state2) const {
+        const pair<int, int> *sig1 = &entries[0] + succ_sig_start[state1];
+        const pair<int, int> *sig2 = &entries[0] + succ_sig_start[state2];
+        return ::lexicographical_compare(sig1, sig1 + succ_sig_size[state1],
+                                         sig2, sig2 + succ_sig_size[state2]);
+    }
+};
+
+struct SignatureLess {
+    const SuccessorSignatureTable &table;
+    explicit SignatureLess(const SuccessorSignatureTable &table_)
+        : table(table_) {
+    }
+    bool operator()(int state1, int state2) const {
+        return table.less(state1, state2);
+    }
+};
+
 ShrinkBisimulation::ShrinkBisimulation(const Options &opts)
     : ShrinkStrategy(opts),
       greedy(opts.get<bool>("greedy")),
       threshold(opts.get<int>("threshold")),
       group_by_h(opts.get<bool>("group_by_h")),
-      at_limit(AtLimit(opts.get_enum("at_limit"))) {
+      at_limit(AtLimit(opts.get_enum("at_limit"))),
+      refinement(Refinement(opts.get_enum("refinement"))) {
 }
 
 ShrinkBisimulation::~ShrinkBisimulation() {
@@ -99,19 +251,21 @@ string ShrinkBisimulation::name() const {
     return "bisimulation";
 }
 
-void ShrinkBisimulation::dump_strategy_specific_options() const {
-    cout << "Bisimulation type: " << (greedy ? "greedy" : "exact") << endl;
-    cout << "Bisimulation threshold: " << threshold << endl;
-    cout << "Group by h: " << (group_by_h ? "yes" : "no") << endl;
-    cout << "At limit: ";
+void ShrinkBisimulation::dump_strategy_specific_options(ostream &out) const {
+    out << "Bisimulation type: " << (greedy ? "greedy" : "exact") << endl;
+    out << "Bisimulation threshold: " << threshold << endl;
+    out << "Group by h: " << (group_by_h ? "yes" : "no") << endl;
+    out << "At limit: ";
     if (at_limit == RETURN) {
-        cout << "return";
+        out << "return";
     } else if (at_limit == USE_UP) {
-        cout << "use up limit";
+        out << "use up limit";
     } else {
         ABORT("Unknown setting for at_limit.");
     }
-    cout << endl;
+    out << endl;
+    out << "Refinement: "
+        << (refinement == SORTING ? "sorting" : "hashing") << endl;
 }
 
 bool ShrinkBisimulation::reduce_labels_before_shrinking() const {
@@ -210,6 +364,83 @@ int ShrinkBisimulation::initialize_groups(const Abstraction &abs,
     return num_groups;
 }
 
+void ShrinkBisimulation::compute_successor_signatures(
+    const Abstraction &abs,
+    const vector<int> &state_to_group,
+    vector<int> &succ_sig_start,
+    vector<int> &succ_sig_size,
+    vector<pair<int, int> > &entries) const {
+    int num_states = abs.size();
+    int num_ops = abs.get_num_ops();
+    int num_threads = get_num_threads(num_states);
+
+    /* The operators are split into ranges with about the same number of
+       transitions, one per thread. Each range counts its entries for
+       every state, so that it can place them from its own offset within
+       the entries of the state, without synchronizing with the others. */
+    vector<int> range_start(num_threads + 1, num_ops);
+    range_start[0] = 0;
+    if (num_threads > 1) {
+        size_t num_transitions = 0;
+        for (int op_no = 0; op_no < num_ops; ++op_no)
+            num_transitions += abs.get_transitions_for_op(op_no).size();
+        size_t transitions_so_far = 0;
+        int range = 1;
+        for (int op_no = 0; op_no < num_ops && range < num_threads; ++op_no) {
+            transitions_so_far += abs.get_transitions_for_op(op_no).size();
+            while (range < num_threads &&
+                   transitions_so_far * num_threads >= num_transitions * range)
+                range_start[range++] = op_no + 1;
+        }
+    }
+
+    vector<vector<int> > next_entry(num_threads, vector<int>(num_states, 0));
+    if (num_threads == 1) {
+        count_signature_entries(abs, greedy, 0, num_ops, next_entry[0]);
+    } else {
+#pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+        for (int range = 0; range < num_threads; ++range)
+            count_signature_entries(abs, greedy, range_start[range],
+                                    range_start[range + 1], next_entry[range]);
+    }
+
+    succ_sig_start.resize(num_states + 1);
+    int num_entries = 0;
+    for (int state = 0; state < num_states; ++state) {
+        succ_sig_start[state] = num_entries;
+        for (int range = 0; range < num_threads; ++range) {
+            int range_entries = next_entry[range][state];
+            next_entry[range][state] = num_entries;
+            num_entries += range_entries;
+        }
+    }
+    succ_sig_start[num_states] = num_entries;
+    entries.resize(num_entries);
+
+    if (num_threads == 1) {
+        place_signature_entries(abs, greedy, state_to_group, 0, num_ops,
+                                next_entry[0], entries);
+    } else {
+#pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+        for (int range = 0; range < num_threads; ++range)
+            place_signature_entries(abs, greedy, state_to_group,
+                                    range_start[range], range_start[range + 1],
+                                    next_entry[range], entries);
+    }
+
+    // Canonicalize the representation: sorted and uniquified.
+    succ_sig_size.resize(num_states);
+#pragma omp parallel for schedule(dynamic, 1024) if (num_threads > 1)
+    for (int state = 0; state < num_states; ++state) {
+        vector<pair<int, int> >::iterator begin =
+            entries.begin() + succ_sig_start[state];
+        vector<pair<int, int> >::iterator end =
+            entries.begin() + succ_sig_start[state + 1];
+        ::sort(begin, end);
+        succ_sig_size[state] = ::unique(begin, end) - begin;
+    }
+}
+
 void ShrinkBisimulation::compute_signatures(
     const Abstraction &abs,
     vector<Signature> &signatures,
@@ -229,27 +460,20 @@ void ShrinkBisimulation::compute_signatures(
     signatures.push_back(Signature(infinity, false, -1, SuccessorSignature(), -1));
 
     // Step 2: Add transition information.
-    int num_ops = abs.get_num_ops();
-    for (int op_no = 0; op_no < num_ops; ++op_no) {
-        const vector<AbstractTransition> &transitions =
-            abs.get_transitions_for_op(op_no);
-        int op_cost = abs.get_cost_for_op(op_no);
-        for (size_t i = 0; i < transitions.size(); ++i) {
-            const AbstractTransition &trans = transitions[i];
-            assert(signatures[trans.src + 1].state == trans.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = abs.get_goal_distance(trans.src);
-                int target_h = abs.get_goal_distance(trans.target);
-                assert(target_h + op_cost >= src_h);
-                skip_transition = (target_h + op_cost != src_h);
-            }
-            if (!skip_transition) {
-                int target_group = state_to_group[trans.target];
-                signatures[trans.src + 1].succ_signature.push_back(
-                    make_pair(op_no, target_group));
-            }
-        }
+    vector<int> succ_sig_start;
+    vector<int> succ_sig_size;
+    vector<pair<int, int> > entries;
+    compute_successor_signatures(abs, state_to_group,
+                                 succ_sig_start, succ_sig_size, entries);
+    int num_states = abs.size();
+    int num_threads = get_num_threads(num_states);
+#pragma omp parallel for schedule(dynamic, 1024) if (num_threads > 1)
+    for (int state = 0; state < num_states; ++state) {
+        assert(signatures[state + 1].state == state);
+        vector<pair<int, int> >::const_iterator begin =
+            entries.begin() + succ_sig_start[state];
+        signatures[state + 1].succ_signature.assign(
+            begin, begin + succ_sig_size[state]);
     }
 
     /* Step 3: Canonicalize the representation. The resulting
@@ -267,131 +491,262 @@ void ShrinkBisimulation::compute_signatures(
           bisimulation round.
      */
 
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
-    }
-
-    ::sort(signatures.begin(), signatures.end());
+    parallel_sort(signatures, num_threads);
     /* TODO: Should we sort an index set rather than shuffle the whole
        signatures around? But since swapping vectors is fast, we
        probably don't have to worry about that. */
 }
 
-void ShrinkBisimulation::compute_abstraction(
-    Abstraction &abs,
-    int target_size,
-    EquivalenceRelation &equivalence_relation) {
+void ShrinkBisimulation::refine_with_sorting(
+    const Abstraction &abs, int target_size,
+    vector<int> &state_to_group, int &num_groups,
+    bool &stable, bool &stop_requested) {
     int num_states = abs.size();
-
-    vector<int> state_to_group(num_states);
+    int max_h = abs.get_max_h();
     vector<Signature> signatures;
     signatures.reserve(num_states + 2);
+    compute_signatures(abs, signatures, state_to_group);
+
+    // Verify size of signatures and presence of sentinels.
+    assert(signatures.size() == num_states + 2);
+    assert(signatures[0].h_and_goal == -2);
+    assert(signatures[num_states + 1].h_and_goal == infinity);
+
+    int sig_start = 1; // Skip over initial sentinel.
+    while (true) {
+        int h_and_goal = signatures[sig_start].h_and_goal;
+        int group = signatures[sig_start].group;
+        if (h_and_goal > max_h) {
+            // We have hit the end sentinel.
+            assert(h_and_goal == infinity);
+            assert(sig_start + 1 == signatures.size());
+            break;
+        }
 
-    int num_groups = initialize_groups(abs, state_to_group);
-    // cout << "number of initial groups: " << num_groups << endl;
-
-    // assert(num_groups <= target_size); // TODO: We currently violate this; see issue250
-
-    int max_h = abs.get_max_h();
-    assert(max_h >= 0 && max_h != infinity);
-
-    bool stable = false;
-    bool stop_requested = false;
-    while (!stable && !stop_requested && num_groups < target_size) {
-        stable = true;
-
-        signatures.clear();
-        compute_signatures(abs, signatures, state_to_group);
-
-        // Verify size of signatures and presence of sentinels.
-        assert(signatures.size() == num_states + 2);
-        assert(signatures[0].h_and_goal == -2);
-        assert(signatures[num_states + 1].h_and_goal == infinity);
-
-        int sig_start = 1; // Skip over initial sentinel.
-        while (true) {
-            int h_and_goal = signatures[sig_start].h_and_goal;
-            int group = signatures[sig_start].group;
-            if (h_and_goal > max_h) {
-                // We have hit the end sentinel.
-                assert(h_and_goal == infinity);
-                assert(sig_start + 1 == signatures.size());
-                break;
+        // Compute the number of groups needed after splitting.
+        int num_old_groups = 0;
+        int num_new_groups = 0;
+        int sig_end;
+        for (sig_end = sig_start; true; ++sig_end) {
+            if (group_by_h) {
+                if (signatures[sig_end].h_and_goal != h_and_goal)
+                    break;
+            } else {
+                if (signatures[sig_end].group != group)
+                    break;
             }
 
-            // Compute the number of groups needed after splitting.
-            int num_old_groups = 0;
-            int num_new_groups = 0;
-            int sig_end;
-            for (sig_end = sig_start; true; ++sig_end) {
-                if (group_by_h) {
-                    if (signatures[sig_end].h_and_goal != h_and_goal)
-                        break;
-                } else {
-                    if (signatures[sig_end].group != group)
-                        break;
-                }
+            const Signature &prev_sig = signatures[sig_end - 1];
+            const Signature &curr_sig = signatures[sig_end];
 
-                const Signature &prev_sig = signatures[sig_end - 1];
-                const Signature &curr_sig = signatures[sig_end];
+            if (sig_end == sig_start)
+                assert(prev_sig.group != curr_sig.group);
 
-                if (sig_end == sig_start)
-                    assert(prev_sig.group != curr_sig.group);
+            if (prev_sig.group != curr_sig.group) {
+                ++num_old_groups;
+                ++num_new_groups;
+            } else if (prev_sig.succ_signature != curr_sig.succ_signature) {
+                ++num_new_groups;
+            }
+        }
+        assert(sig_end > sig_start);
+
+        if (at_limit == RETURN &&
+            num_groups - num_old_groups + num_new_groups > target_size) {
+            /* Can't split the group (or the set of groups for
+               this h value) -- would exceed bound on abstract
+               state number.
+            */
+            stop_requested = true;
+            break;
+        } else if (num_new_groups != num_old_groups) {
+            // Split into new groups.
+            stable = false;
+
+            int new_group_no = -1;
+            for (size_t i = sig_start; i < sig_end; ++i) {
+                const Signature &prev_sig = signatures[i - 1];
+                const Signature &curr_sig = signatures[i];
 
                 if (prev_sig.group != curr_sig.group) {
-                    ++num_old_groups;
-                    ++num_new_groups;
-                } else if (prev_sig.succ_signature != curr_sig.succ_signature) {
-                    ++num_new_groups;
+                    // Start first group of a block; keep old group no.
+                    new_group_no = curr_sig.group;
+                } else if (prev_sig.succ_signature
+                           != curr_sig.succ_signature) {
+                    new_group_no = num_groups++;
+                    assert(num_groups <= target_size);
                 }
+
+                assert(new_group_no != -1);
+                state_to_group[curr_sig.state] = new_group_no;
+                if (num_groups == target_size)
+                    break;
             }
-            assert(sig_end > sig_start);
-
-            if (at_limit == RETURN &&
-                num_groups - num_old_groups + num_new_groups > target_size) {
-                /* Can't split the group (or the set of groups for
-                   this h value) -- would exceed bound on abstract
-                   state number.
-                */
-                stop_requested = true;
+            if (num_groups == target_size)
                 break;
-            } else if (num_new_groups != num_old_groups) {
-                // Split into new groups.
-                stable = false;
-
-                int new_group_no = -1;
-                for (size_t i = sig_start; i < sig_end; ++i) {
-                    const Signature &prev_sig = signatures[i - 1];
-                    const Signature &curr_sig = signatures[i];
-
-                    if (prev_sig.group != curr_sig.group) {
-                        // Start first group of a block; keep old group no.
-                        new_group_no = curr_sig.group;
-                    } else if (prev_sig.succ_signature
-                               != curr_sig.succ_signature) {
-                        new_group_no = num_groups++;
-                        assert(num_groups <= target_size);
-                    }
+        }
+        sig_start = sig_end;
+    }
+}
+
+void ShrinkBisimulation::refine_with_hashing(
+    const Abstraction &abs, int target_size,
+    vector<int> &state_to_group, int &num_groups,
+    bool &stable, bool &stop_requested) const {
+    /* This reproduces refine_with_sorting without sorting the
+       signatures of all states. There, the states are ordered by
+       (h_and_goal, group, successor signature, state), and within each
+       group, the states with the smallest successor signature keep the
+       group while the others get new group numbers in the order of
+       their signatures. Here, the states of each group are partitioned
+       into classes of equal successor signature with a hash table, and
+       only the distinct signatures of the group are sorted. */
+    int num_states = abs.size();
+    vector<int> succ_sig_start;
+    vector<int> succ_sig_size;
+    vector<pair<int, int> > entries;
+    compute_successor_signatures(abs, state_to_group,
+                                 succ_sig_start, succ_sig_size, entries);
+
+    // The states of each group in increasing order, and their h_and_goal.
+    int num_old_groups = num_groups;
+    vector<int> group_start(num_old_groups + 1, 0);
+    vector<int> group_h_and_goal(num_old_groups);
+    for (int state = 0; state < num_states; ++state) {
+        int group = state_to_group[state];
+        int h_and_goal = abs.is_goal_state(state) ? -1 : abs.get_goal_distance(state);
+        assert(group_start[group + 1] == 0 || group_h_and_goal[group] == h_and_goal);
+        ++group_start[group + 1];
+        group_h_and_goal[group] = h_and_goal;
+    }
+    for (int group = 0; group < num_old_groups; ++group)
+        group_start[group + 1] += group_start[group];
+    vector<int> group_states(num_states);
+    vector<int> next_state(group_start.begin(), group_start.end() - 1);
+    for (int state = 0; state < num_states; ++state)
+        group_states[next_state[state_to_group[state]]++] = state;
+
+    /* Partition the groups into classes of states with equal successor
+       signature, numbered in the order of the signatures. */
+    SuccessorSignatureTable signature_table(succ_sig_start, succ_sig_size, entries);
+    vector<int> state_class(num_states);
+    vector<int> num_classes(num_old_groups);
+#pragma omp parallel for schedule(dynamic) if (get_num_threads(num_states) > 1)
+    for (int group = 0; group < num_old_groups; ++group) {
+        typedef hash_map<int, int, SuccessorSignatureTable,
+                         SuccessorSignatureTable> ClassMap;
+        int size = group_start[group + 1] - group_start[group];
+        const int *states = &group_states[0] + group_start[group];
+        ClassMap class_of_signature(size, signature_table, signature_table);
+        vector<int> representatives;
+        for (int i = 0; i < size; ++i) {
+            pair<ClassMap::iterator, bool> result = class_of_signature.insert(
+                make_pair(states[i], representatives.size()));
+            if (result.second)
+                representatives.push_back(states[i]);
+            state_class[states[i]] = result.first->second;
+        }
+        int group_classes = representatives.size();
+        num_classes[group] = group_classes;
+        if (group_classes > 1) {
+            vector<int> order(representatives);
+            ::sort(order.begin(), order.end(), SignatureLess(signature_table));
+            vector<int> class_rank(group_classes);
+            for (int r = 0; r < group_classes; ++r)
+                class_rank[state_class[order[r]]] = r;
+            for (int i = 0; i < size; ++i)
+                state_class[states[i]] = class_rank[state_class[states[i]]];
+        }
+    }
 
-                    assert(new_group_no != -1);
-                    state_to_group[curr_sig.state] = new_group_no;
-                    if (num_groups == target_size)
+    // Blocks of groups in the order of refine_with_sorting.
+    vector<pair<int, int> > group_order;
+    for (int group = 0; group < num_old_groups; ++group)
+        group_order.push_back(make_pair(group_h_and_goal[group], group));
+    ::sort(group_order.begin(), group_order.end());
+
+    int block_end;
+    for (int block_start = 0; block_start < num_old_groups;
+         block_start = block_end) {
+        block_end = block_start + 1;
+        if (group_by_h) {
+            while (block_end < num_old_groups &&
+                   group_order[block_end].first == group_order[block_start].first)
+                ++block_end;
+        }
+        int num_new_groups = 0;
+        for (int i = block_start; i < block_end; ++i)
+            num_new_groups += num_classes[group_order[i].second];
+        int num_block_groups = block_end - block_start;
+
+        if (at_limit == RETURN &&
+            num_groups - num_block_groups + num_new_groups > target_size) {
+            stop_requested = true;
+            return;
+        } else if (num_new_groups != num_block_groups) {
+            stable = false;
+            for (int i = block_start; i < block_end; ++i) {
+                int group = group_order[i].second;
+                int group_classes = num_classes[group];
+                if (group_classes == 1)
+                    continue;
+                /* Like refine_with_sorting, stop right after the first
+                   state (the one with the smallest number) of the class
+                   that reaches the target size. */
+                vector<int> class_group(group_classes);
+                class_group[0] = group;
+                int last_class = group_classes;
+                for (int c = 1; c < group_classes; ++c) {
+                    class_group[c] = num_groups++;
+                    if (num_groups == target_size) {
+                        last_class = c;
                         break;
+                    }
+                }
+                bool last_class_started = false;
+                for (int j = group_start[group]; j < group_start[group + 1]; ++j) {
+                    int state = group_states[j];
+                    int c = state_class[state];
+                    if (c < last_class) {
+                        state_to_group[state] = class_group[c];
+                    } else if (c == last_class && !last_class_started) {
+                        state_to_group[state] = class_group[c];
+                        last_class_started = true;
+                    }
                 }
                 if (num_groups == target_size)
-                    break;
+                    return;
             }
-            sig_start = sig_end;
         }
     }
+}
+
+void ShrinkBisimulation::compute_abstraction(
+    Abstraction &abs,
+    int target_size,
+    EquivalenceRelation &equivalence_relation) {
+    int num_states = abs.size();
+
+    vector<int> state_to_group(num_states);
+
+    int num_groups = initialize_groups(abs, state_to_group);
+    // cout << "number of initial groups: " << num_groups << endl;
+
+    // assert(num_groups <= target_size); // TODO: We currently violate this; see issue250
 
-    /* Reduce memory pressure before generating the equivalence
-       relation since this is one of the code parts relevant to peak
-       memory. */
-    release_memory(signatures);
+    assert(abs.get_max_h() >= 0 && abs.get_max_h() != infinity);
+
+    bool stable = false;
+    bool stop_requested = false;
+    while (!stable && !stop_requested && num_groups < target_size) {
+        stable = true;
+        if (refinement == SORTING)
+            refine_with_sorting(abs, target_size, state_to_group, num_groups,
+                                stable, stop_requested);
+        else
+            refine_with_hashing(abs, target_size, state_to_group, num_groups,
+                                stable, stop_requested);
+    }
 
     // Generate final result.
     assert(equivalence_relation.empty());
@@ -413,6 +768,7 @@ ShrinkStrategy *ShrinkBisimulation::create_default() {
     opts.set("threshold", 1);
     opts.set("group_by_h", false);
     opts.set<int>("at_limit", RETURN);
+    opts.set<int>("refinement", SORTING);
 
     return new ShrinkBisimulation(opts);
 }
@@ -430,6 +786,15 @@ static ShrinkStrategy *_parse(OptionParser &parser) {
         "at_limit", at_limit,
         "what to do when the size limit is hit", "RETURN");
 
+    vector<string> refinement;
+    refinement.push_back("SORTING");
+    refinement.push_back("HASHING");
+    parser.add_enum_option(
+        "refinement", refinement,
+        "how groups are split: by sorting the signatures of all states, "
+        "or by hashing the signatures within each group (same result)",
+        "SORTING");
+
     Options opts = parser.parse();
 
     if (parser.help_mode())
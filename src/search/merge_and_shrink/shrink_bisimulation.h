@@ -3,6 +3,9 @@
 
 #include "shrink_strategy.h"
 
+#include <utility>
+#include <vector>
+
 class Options;
 class Signature;
 
@@ -12,6 +15,15 @@ class ShrinkBisimulation : public ShrinkStrategy {
         USE_UP
     };
 
+    /* How the groups are split in each round: by sorting the signatures
+       of all states, or by hashing the successor signatures within each
+       group and sorting only the distinct ones. Both give the same
+       abstraction. */
+    enum Refinement {
+        SORTING,
+        HASHING
+    };
+
     /*
       threshold: Shrink the abstraction iff it is larger than this
       size. Note that this is set independently from max_states, which
@@ -22,6 +34,7 @@ class ShrinkBisimulation : public ShrinkStrategy {
     const int threshold;
     const bool group_by_h;
     const AtLimit at_limit;
+    const Refinement refinement;
 
     void compute_abstraction(
         Abstraction &abs,
@@ -30,16 +43,38 @@ class ShrinkBisimulation : public ShrinkStrategy {
 
     int initialize_groups(const Abstraction &abs,
                           std::vector<int> &state_to_group);
+    /* Computes the successor signature of every state (see the .cc file)
+       as the range from succ_sig_start[state] of length
+       succ_sig_size[state] in entries, sorted and without duplicates. */
+    void compute_successor_signatures(
+        const Abstraction &abs,
+        const std::vector<int> &state_to_group,
+        std::vector<int> &succ_sig_start,
+        std::vector<int> &succ_sig_size,
+        std::vector<std::pair<int, int> > &entries) const;
     void compute_signatures(
         const Abstraction &abs,
         std::vector<Signature> &signatures,
         std::vector<int> &state_to_group);
+
+    /* One round of splitting the groups, with the respective refinement.
+       Updates state_to_group and num_groups, clears stable if a group
+       was split and sets stop_requested if at_limit stopped the
+       splitting. */
+    void refine_with_sorting(
+        const Abstraction &abs, int target_size,
+        std::vector<int> &state_to_group, int &num_groups,
+        bool &stable, bool &stop_requested);
+    void refine_with_hashing(
+        const Abstraction &abs, int target_size,
+        std::vector<int> &state_to_group, int &num_groups,
+        bool &stable, bool &stop_requested) const;
 public:
     ShrinkBisimulation(const Options &opts);
     virtual ~ShrinkBisimulation();
 
     virtual std::string name() const;
-    virtual void dump_strategy_specific_options() const;
+    virtual void dump_strategy_specific_options(std::ostream &out) const;
 
     virtual bool reduce_labels_before_shrinking() const;
 
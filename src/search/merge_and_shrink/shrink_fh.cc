@@ -6,6 +6,7 @@
 #include "../plugin.h"
 
 #include <cassert>
+#include <iostream>
 #include <limits>
 #include <map>
 #include <vector>
@@ -29,11 +30,11 @@ string ShrinkFH::name() const {
     return "f-preserving";
 }
 
-void ShrinkFH::dump_strategy_specific_options() const {
-    cout << "Prefer shrinking high or low f states: "
-         << (f_start == HIGH ? "high" : "low") << endl
-         << "Prefer shrinking high or low h states: "
-         << (h_start == HIGH ? "high" : "low") << endl;
+void ShrinkFH::dump_strategy_specific_options(ostream &out) const {
+    out << "Prefer shrinking high or low f states: "
+        << (f_start == HIGH ? "high" : "low") << endl
+        << "Prefer shrinking high or low h states: "
+        << (h_start == HIGH ? "high" : "low") << endl;
 }
 
 void ShrinkFH::partition_into_buckets(
@@ -45,7 +45,7 @@ private:
         std::vector<Bucket> &buckets) const;
 protected:
     virtual std::string name() const;
-    virtual void dump_strategy_specific_options() const;
+    virtual void dump_strategy_specific_options(std::ostream &out) const;
 
     virtual void partition_into_buckets(
         const Abstraction &abs, std::vector<Bucket> &buckets) const;
@@ -22,15 +22,15 @@ ShrinkStrategy::ShrinkStrategy(const Options &opts)
 ShrinkStrategy::~ShrinkStrategy() {
 }
 
-void ShrinkStrategy::dump_options() const {
-    cout << "Shrink strategy: " << name() << endl;
-    cout << "Abstraction size limit: " << max_states << endl
-         << "Abstraction size limit right before merge: "
-         << max_states_before_merge << endl;
-    dump_strategy_specific_options();
+void ShrinkStrategy::dump_options(ostream &out) const {
+    out << "Shrink strategy: " << name() << endl;
+    out << "Abstraction size limit: " << max_states << endl
+        << "Abstraction size limit right before merge: "
+        << max_states_before_merge << endl;
+    dump_strategy_specific_options(out);
 }
 
-void ShrinkStrategy::dump_strategy_specific_options() const {
+void ShrinkStrategy::dump_strategy_specific_options(ostream &) const {
     // Default implementation does nothing.
 }
 
@@ -1,6 +1,7 @@
 #ifndef MERGE_AND_SHRINK_SHRINK_STRATEGY_H
 #define MERGE_AND_SHRINK_SHRINK_STRATEGY_H
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <ext/slist>
@@ -35,7 +36,7 @@ public:
     // value be a factory function with a string description?
     virtual std::string name() const = 0;
 protected:
-    virtual void dump_strategy_specific_options() const;
+    virtual void dump_strategy_specific_options(std::ostream &out) const;
 
     std::pair<int, int> compute_shrink_sizes(int size1, int size2) const;
     bool must_shrink(const Abstraction &abs, int threshold, bool force) const;
@@ -58,7 +59,8 @@ public:
     */
     virtual bool reduce_labels_before_shrinking() const = 0;
 
-    void dump_options() const;
+    // Also used as part of the key of the merge-and-shrink heuristic cache.
+    void dump_options(std::ostream &out) const;
 
     /* TODO: Make sure that *all* shrink strategies prune irrelevant
        and unreachable states, then update documentation below
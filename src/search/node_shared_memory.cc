@@ -0,0 +1,68 @@
+#include "node_shared_memory.h"
+
+#include <cstdlib>
+using namespace std;
+
+static MPI_Comm node_comm = MPI_COMM_NULL;
+
+static void finalize_mpi() {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+        MPI_Finalize();
+}
+
+void initialize_mpi() {
+    // HDA* initializes MPI itself if we do not, and finalizes it when
+    // the search is done.
+    int initialized;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        MPI_Init(NULL, NULL);
+        atexit(finalize_mpi);
+    }
+}
+
+static MPI_Comm get_node_comm() {
+    if (node_comm == MPI_COMM_NULL) {
+        initialize_mpi();
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                            MPI_INFO_NULL, &node_comm);
+    }
+    return node_comm;
+}
+
+bool is_node_leader() {
+    int node_rank;
+    MPI_Comm_rank(get_node_comm(), &node_rank);
+    return node_rank == 0;
+}
+
+NodeSharedBlock::NodeSharedBlock(size_t size_)
+    : data(0), size(size_) {
+    bool leader = is_node_leader();
+    unsigned long long block_size = size;
+    MPI_Bcast(&block_size, 1, MPI_UNSIGNED_LONG_LONG, 0, get_node_comm());
+    size = block_size;
+
+    // Only the leader allocates memory. The others map its segment.
+    MPI_Win_allocate_shared(leader ? size : 0, 1, MPI_INFO_NULL,
+                            get_node_comm(), &data, &window);
+    MPI_Aint segment_size;
+    int displacement_unit;
+    MPI_Win_shared_query(window, 0, &segment_size, &displacement_unit,
+                         &data);
+    MPI_Win_fence(0, window);
+}
+
+NodeSharedBlock::~NodeSharedBlock() {
+    // HDA* finalizes MPI before the heuristics are destroyed.
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+        MPI_Win_free(&window);
+}
+
+void NodeSharedBlock::publish() {
+    MPI_Win_fence(0, window);
+}
@@ -0,0 +1,44 @@
+#ifndef NODE_SHARED_MEMORY_H
+#define NODE_SHARED_MEMORY_H
+
+#include <cstddef>
+#include <mpi.h>
+
+/*
+  Large read-only tables that every MPI rank would otherwise build and
+  store itself, such as the tables of abstraction heuristics, can be
+  built once per node and placed in an MPI-3 shared memory segment that
+  all ranks of the node map.
+
+  All functions and constructors below are collective over
+  MPI_COMM_WORLD (is_node_leader only on its first call), so all ranks
+  have to create and destroy the same blocks in the same order. This
+  holds for heuristics as long as all ranks are given the same options.
+*/
+
+// Initializes MPI unless it is running already.
+void initialize_mpi();
+
+// True on the lowest rank of each node, which builds the shared tables.
+bool is_node_leader();
+
+class NodeSharedBlock {
+    MPI_Win window;
+    char *data;
+    size_t size;
+public:
+    // Allocates the block. size is only read on the node leader.
+    explicit NodeSharedBlock(size_t size);
+    ~NodeSharedBlock();
+
+    // Only the node leader writes, and only before publish().
+    char *get_writable_data() {return data; }
+
+    // Makes the contents written by the node leader visible on the node.
+    void publish();
+
+    const char *get_data() const {return data; }
+    size_t get_size() const {return size; }
+};
+
+#endif
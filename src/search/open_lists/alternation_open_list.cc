@@ -112,6 +112,14 @@ void AlternationOpenList<Entry>::clear() {
         open_lists[i]->clear();
 }
 
+template<class Entry>
+size_t AlternationOpenList<Entry>::get_memory_usage() const {
+    size_t usage = 0;
+    for (size_t i = 0; i < open_lists.size(); i++)
+        usage += open_lists[i]->get_memory_usage();
+    return usage;
+}
+
 template<class Entry>
 void AlternationOpenList<Entry>::evaluate(int g, bool preferred) {
     /*
@@ -37,6 +37,7 @@ public:
     Entry remove_min(std::vector<int> *key = 0);
     bool empty() const;
     void clear();
+    size_t get_memory_usage() const;
 
     // Evaluator interface
     void evaluate(int g, bool preferred);
@@ -0,0 +1,199 @@
+// HACK! Ignore this if used as a top-level compile target.
+#ifdef OPEN_LISTS_FH_BUCKET_OPEN_LIST_H
+
+#include "../option_parser.h"
+#include "../scalar_evaluator.h"
+
+#include <cassert>
+#include <limits>
+
+using namespace std;
+
+template<class Entry>
+OpenList<Entry> *FHBucketOpenList<Entry>::_parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Two-level bucket open list",
+        "Orders entries by f and breaks ties by h like tiebreaking([f, h]), "
+        "using buckets indexed by both values instead of a map.");
+    parser.add_option<ScalarEvaluator *>("f_eval", "evaluator for f-values");
+    parser.add_option<ScalarEvaluator *>("h_eval",
+                                         "evaluator for tie-breaking");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return 0;
+    else
+        return new FHBucketOpenList<Entry>(opts);
+}
+
+template<class Entry>
+Entry FHBucketOpenList<Entry>::Bucket::pop() {
+    assert(!empty());
+    Entry result = entries[first++];
+    if (first == entries.size()) {
+        entries.clear();
+        first = 0;
+    } else if (first > entries.size() / 2 && first >= 1024) {
+        entries.erase(entries.begin(), entries.begin() + first);
+        first = 0;
+    }
+    return result;
+}
+
+template<class Entry>
+FHBucketOpenList<Entry>::FBucket::FBucket()
+    : lowest_h(numeric_limits<int>::max()), size(0) {
+}
+
+template<class Entry>
+FHBucketOpenList<Entry>::FHBucketOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      lowest_f(numeric_limits<int>::max()), size(0),
+      f_evaluator(opts.get<ScalarEvaluator *>("f_eval")),
+      h_evaluator(opts.get<ScalarEvaluator *>("h_eval")),
+      last_f(0), last_h(0), last_preferred(false), dead_end(false),
+      dead_end_reliable(false) {
+}
+
+template<class Entry>
+FHBucketOpenList<Entry>::FHBucketOpenList(
+    ScalarEvaluator *f_eval, ScalarEvaluator *h_eval, bool preferred_only)
+    : OpenList<Entry>(preferred_only),
+      lowest_f(numeric_limits<int>::max()), size(0),
+      f_evaluator(f_eval), h_evaluator(h_eval),
+      last_f(0), last_h(0), last_preferred(false), dead_end(false),
+      dead_end_reliable(false) {
+}
+
+template<class Entry>
+FHBucketOpenList<Entry>::~FHBucketOpenList() {
+}
+
+template<class Entry>
+int FHBucketOpenList<Entry>::insert(const Entry &entry) {
+    if (OpenList<Entry>::only_preferred && !last_preferred)
+        return 0;
+    if (dead_end)
+        return 0;
+    assert(last_f >= 0 && last_h >= 0);
+    if (last_f >= f_buckets.size())
+        f_buckets.resize(last_f + 1);
+    FBucket &f_bucket = f_buckets[last_f];
+    if (last_h >= f_bucket.h_buckets.size())
+        f_bucket.h_buckets.resize(last_h + 1);
+    f_bucket.h_buckets[last_h].push(entry);
+    if (last_h < f_bucket.lowest_h)
+        f_bucket.lowest_h = last_h;
+    ++f_bucket.size;
+    if (last_f < lowest_f)
+        lowest_f = last_f;
+    ++size;
+    return 1;
+}
+
+template<class Entry>
+int FHBucketOpenList<Entry>::insert_batch(const vector<Entry> &entries,
+                                          const vector<int> &keys) {
+    if (OpenList<Entry>::only_preferred)
+        return 0;
+    assert(keys.size() == 2 * entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        int f = keys[2 * i];
+        int h = keys[2 * i + 1];
+        assert(f >= 0 && h >= 0);
+        if (f >= f_buckets.size())
+            f_buckets.resize(f + 1);
+        FBucket &f_bucket = f_buckets[f];
+        if (h >= f_bucket.h_buckets.size())
+            f_bucket.h_buckets.resize(h + 1);
+        f_bucket.h_buckets[h].push(entries[i]);
+        if (h < f_bucket.lowest_h)
+            f_bucket.lowest_h = h;
+        ++f_bucket.size;
+        if (f < lowest_f)
+            lowest_f = f;
+    }
+    size += entries.size();
+    return entries.size();
+}
+
+template<class Entry>
+Entry FHBucketOpenList<Entry>::remove_min(vector<int> *key) {
+    assert(size > 0);
+    while (f_buckets[lowest_f].size == 0)
+        ++lowest_f;
+    FBucket &f_bucket = f_buckets[lowest_f];
+    while (f_bucket.h_buckets[f_bucket.lowest_h].empty())
+        ++f_bucket.lowest_h;
+    if (key) {
+        assert(key->empty());
+        key->push_back(lowest_f);
+        key->push_back(f_bucket.lowest_h);
+    }
+    Entry result = f_bucket.h_buckets[f_bucket.lowest_h].pop();
+    if (--f_bucket.size == 0)
+        f_bucket.lowest_h = numeric_limits<int>::max();
+    --size;
+    return result;
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::clear() {
+    f_buckets.clear();
+    lowest_f = numeric_limits<int>::max();
+    size = 0;
+}
+
+template<class Entry>
+size_t FHBucketOpenList<Entry>::get_memory_usage() const {
+    size_t usage = f_buckets.capacity() * sizeof(FBucket);
+    for (size_t f = 0; f < f_buckets.size(); ++f) {
+        const vector<Bucket> &h_buckets = f_buckets[f].h_buckets;
+        usage += h_buckets.capacity() * sizeof(Bucket);
+        for (size_t h = 0; h < h_buckets.size(); ++h)
+            usage += h_buckets[h].entries.capacity() * sizeof(Entry);
+    }
+    return usage;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::evaluate(int g, bool preferred) {
+    f_evaluator->evaluate(g, preferred);
+    h_evaluator->evaluate(g, preferred);
+    dead_end = f_evaluator->is_dead_end() || h_evaluator->is_dead_end();
+    dead_end_reliable = (f_evaluator->is_dead_end() &&
+                         f_evaluator->dead_end_is_reliable()) ||
+                        (h_evaluator->is_dead_end() &&
+                         h_evaluator->dead_end_is_reliable());
+    if (!dead_end) {
+        last_f = f_evaluator->get_value();
+        last_h = h_evaluator->get_value();
+    }
+    last_preferred = preferred;
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::is_dead_end() const {
+    return dead_end;
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::dead_end_is_reliable() const {
+    return dead_end_reliable;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::get_involved_heuristics(
+    std::set<Heuristic *> &hset) {
+    f_evaluator->get_involved_heuristics(hset);
+    h_evaluator->get_involved_heuristics(hset);
+}
+#endif
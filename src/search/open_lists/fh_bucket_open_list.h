@@ -0,0 +1,91 @@
+#ifndef OPEN_LISTS_FH_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_FH_BUCKET_OPEN_LIST_H
+
+#include "open_list.h"
+#include "../evaluator.h"
+
+#include <vector>
+
+class ScalarEvaluator;
+class Options;
+class OptionParser;
+
+/*
+  Open list for A*-like searches that orders entries by an f-evaluator
+  and breaks ties by an h-evaluator, i.e. the same order as
+  tiebreaking([f, h]) with FIFO order among entries with equal keys.
+
+  Entries are kept in a two-level array of buckets indexed by f and h,
+  so insert and remove_min take amortized constant time as long as the
+  minimal f value does not decrease much (which is the case for A* with
+  admissible heuristics). The memory for the buckets grows linearly with
+  the largest f value, so this is meant for tasks with small integer
+  costs. Dead ends are never inserted.
+*/
+template<class Entry>
+class FHBucketOpenList : public OpenList<Entry> {
+    /*
+      FIFO queue stored in one vector. Removed entries are only freed once
+      the bucket runs empty or more than half of it has been removed.
+    */
+    struct Bucket {
+        std::vector<Entry> entries;
+        size_t first;
+
+        Bucket() : first(0) {}
+        bool empty() const {return first == entries.size(); }
+        void push(const Entry &entry) {entries.push_back(entry); }
+        Entry pop();
+    };
+
+    struct FBucket {
+        std::vector<Bucket> h_buckets;
+        int lowest_h;
+        int size;
+
+        FBucket();
+    };
+
+    std::vector<FBucket> f_buckets;
+    int lowest_f;
+    int size;
+
+    ScalarEvaluator *f_evaluator;
+    ScalarEvaluator *h_evaluator;
+    int last_f;
+    int last_h;
+    bool last_preferred;
+    bool dead_end;
+    bool dead_end_reliable;
+protected:
+    Evaluator *get_evaluator() {return this; }
+
+public:
+    FHBucketOpenList(const Options &opts);
+    FHBucketOpenList(ScalarEvaluator *f_eval, ScalarEvaluator *h_eval,
+                     bool preferred_only);
+    ~FHBucketOpenList();
+
+    // open list interface
+    int insert(const Entry &entry);
+    int insert_batch(const std::vector<Entry> &entries,
+                     const std::vector<int> &keys);
+    Entry remove_min(std::vector<int> *key = 0);
+    bool empty() const;
+    void clear();
+    size_t get_memory_usage() const;
+
+    // evaluator interface
+    void evaluate(int g, bool preferred);
+    bool is_dead_end() const;
+    bool dead_end_is_reliable() const;
+    void get_involved_heuristics(std::set<Heuristic *> &hset);
+
+    static OpenList<Entry> *_parse(OptionParser &parser);
+};
+
+#include "fh_bucket_open_list.cc"
+
+// HACK! Need a better strategy of dealing with templates, also in the Makefile.
+
+#endif
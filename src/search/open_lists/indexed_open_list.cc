@@ -0,0 +1,203 @@
+#include "indexed_open_list.h"
+
+#include "../option_parser.h"
+#include "../scalar_evaluator.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+OpenList<StateID> *IndexedOpenList::_parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Indexed open list",
+        "Orders entries like tiebreaking, but contains every state at most "
+        "once: inserting a state again updates its key (decrease-key).");
+    parser.add_list_option<ScalarEvaluator *>("evals", "scalar evaluators");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    Options opts = parser.parse();
+
+    if (parser.dry_run())
+        return 0;
+    else
+        return new IndexedOpenList(opts);
+}
+
+IndexedOpenList::IndexedOpenList(const Options &opts)
+    : OpenList<StateID>(opts.get<bool>("pref_only")),
+      next_sequence(0),
+      evaluators(opts.get_list<ScalarEvaluator *>("evals")),
+      last_preferred(false), dead_end(false), dead_end_reliable(false) {
+    last_evaluated_value.resize(evaluators.size());
+}
+
+IndexedOpenList::IndexedOpenList(const vector<ScalarEvaluator *> &evals,
+                                 bool preferred_only)
+    : OpenList<StateID>(preferred_only),
+      next_sequence(0), evaluators(evals),
+      last_preferred(false), dead_end(false), dead_end_reliable(false) {
+    last_evaluated_value.resize(evaluators.size());
+}
+
+IndexedOpenList::~IndexedOpenList() {
+}
+
+bool IndexedOpenList::less(int pos1, int pos2) const {
+    size_t dim = evaluators.size();
+    const int *key1 = &keys[pos1 * dim];
+    const int *key2 = &keys[pos2 * dim];
+    for (size_t i = 0; i < dim; ++i) {
+        if (key1[i] != key2[i])
+            return key1[i] < key2[i];
+    }
+    return heap[pos1].sequence < heap[pos2].sequence;
+}
+
+void IndexedOpenList::swap_entries(int pos1, int pos2) {
+    size_t dim = evaluators.size();
+    swap(heap[pos1], heap[pos2]);
+    swap_ranges(keys.begin() + pos1 * dim, keys.begin() + (pos1 + 1) * dim,
+                keys.begin() + pos2 * dim);
+    positions[heap[pos1].id.hash()] = pos1;
+    positions[heap[pos2].id.hash()] = pos2;
+}
+
+void IndexedOpenList::sift_up(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!less(pos, parent))
+            break;
+        swap_entries(pos, parent);
+        pos = parent;
+    }
+}
+
+void IndexedOpenList::sift_down(int pos) {
+    int size = heap.size();
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && less(child + 1, child))
+            ++child;
+        if (!less(child, pos))
+            break;
+        swap_entries(pos, child);
+        pos = child;
+    }
+}
+
+bool IndexedOpenList::insert_with_key(const StateID &entry, const int *key) {
+    size_t index = entry.hash();
+    if (index >= positions.size())
+        positions.resize(index + 1, -1);
+    size_t dim = evaluators.size();
+    int pos = positions[index];
+    if (pos == -1) {
+        pos = heap.size();
+        positions[index] = pos;
+        heap.push_back(HeapEntry(entry, next_sequence++));
+        keys.insert(keys.end(), key, key + dim);
+        sift_up(pos);
+        return true;
+    }
+
+    // The state is already in the list: move it to its new key.
+    bool decreased = lexicographical_compare(
+        key, key + dim, keys.begin() + pos * dim,
+        keys.begin() + (pos + 1) * dim);
+    copy(key, key + dim, keys.begin() + pos * dim);
+    heap[pos].sequence = next_sequence++;
+    if (decreased)
+        sift_up(pos);
+    else
+        sift_down(pos);
+    return false;
+}
+
+int IndexedOpenList::insert(const StateID &entry) {
+    if (OpenList<StateID>::only_preferred && !last_preferred)
+        return 0;
+    if (dead_end)
+        return 0;
+    return insert_with_key(entry, &last_evaluated_value[0]) ? 1 : 0;
+}
+
+int IndexedOpenList::insert_batch(const vector<StateID> &entries,
+                                  const vector<int> &entry_keys) {
+    if (OpenList<StateID>::only_preferred)
+        return 0;
+    size_t dim = evaluators.size();
+    assert(entry_keys.size() == entries.size() * dim);
+    int inserted = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (insert_with_key(entries[i], &entry_keys[i * dim]))
+            ++inserted;
+    }
+    return inserted;
+}
+
+StateID IndexedOpenList::remove_min(vector<int> *key) {
+    assert(!heap.empty());
+    size_t dim = evaluators.size();
+    if (key) {
+        assert(key->empty());
+        key->assign(keys.begin(), keys.begin() + dim);
+    }
+    StateID result = heap[0].id;
+    int last = heap.size() - 1;
+    if (last > 0)
+        swap_entries(0, last);
+    heap.pop_back();
+    keys.resize(last * dim);
+    positions[result.hash()] = -1;
+    sift_down(0);
+    return result;
+}
+
+bool IndexedOpenList::empty() const {
+    return heap.empty();
+}
+
+void IndexedOpenList::clear() {
+    heap.clear();
+    keys.clear();
+    positions.clear();
+}
+
+size_t IndexedOpenList::get_memory_usage() const {
+    return heap.capacity() * sizeof(HeapEntry) +
+           keys.capacity() * sizeof(int) +
+           positions.capacity() * sizeof(int);
+}
+
+void IndexedOpenList::evaluate(int g, bool preferred) {
+    dead_end = false;
+    dead_end_reliable = false;
+    for (size_t i = 0; i < evaluators.size(); ++i) {
+        evaluators[i]->evaluate(g, preferred);
+        if (evaluators[i]->is_dead_end()) {
+            dead_end = true;
+            if (evaluators[i]->dead_end_is_reliable())
+                dead_end_reliable = true;
+        } else {
+            last_evaluated_value[i] = evaluators[i]->get_value();
+        }
+    }
+    last_preferred = preferred;
+}
+
+bool IndexedOpenList::is_dead_end() const {
+    return dead_end;
+}
+
+bool IndexedOpenList::dead_end_is_reliable() const {
+    return dead_end_reliable;
+}
+
+void IndexedOpenList::get_involved_heuristics(std::set<Heuristic *> &hset) {
+    for (size_t i = 0; i < evaluators.size(); ++i)
+        evaluators[i]->get_involved_heuristics(hset);
+}
@@ -0,0 +1,85 @@
+#ifndef OPEN_LISTS_INDEXED_OPEN_LIST_H
+#define OPEN_LISTS_INDEXED_OPEN_LIST_H
+
+#include "open_list.h"
+#include "../evaluator.h"
+#include "../state_id.h"
+
+#include <vector>
+
+class ScalarEvaluator;
+class Options;
+class OptionParser;
+
+/*
+  Open list that contains every state at most once. Entries are ordered
+  lexicographically by the values of the evaluators like tiebreaking,
+  with FIFO order among entries with equal keys.
+
+  The entries are kept in a binary heap together with the position of
+  every state in it, indexed by the StateID. Inserting a state that is
+  already in the list updates its key instead of adding another entry
+  (decrease-key), so reopening a state does not leave stale entries
+  behind. The update counts as a new insertion for the FIFO order.
+  The position table needs one int per registered state. Dead ends are
+  never inserted.
+
+  Only StateIDs can be indexed, so this open list is not available for
+  the lazy search engines.
+*/
+class IndexedOpenList : public OpenList<StateID> {
+    struct HeapEntry {
+        StateID id;
+        unsigned int sequence;
+
+        HeapEntry(StateID id_, unsigned int sequence_)
+            : id(id_), sequence(sequence_) {}
+    };
+
+    std::vector<HeapEntry> heap;
+    // evaluators.size() values per heap entry, in the order of the heap.
+    std::vector<int> keys;
+    // Index into heap by StateID, -1 if the state is not in the list.
+    std::vector<int> positions;
+    unsigned int next_sequence;
+
+    std::vector<ScalarEvaluator *> evaluators;
+    std::vector<int> last_evaluated_value;
+    bool last_preferred;
+    bool dead_end;
+    bool dead_end_reliable;
+
+    bool less(int pos1, int pos2) const;
+    void swap_entries(int pos1, int pos2);
+    void sift_up(int pos);
+    void sift_down(int pos);
+    // Returns true if the state was not in the list before.
+    bool insert_with_key(const StateID &entry, const int *key);
+protected:
+    Evaluator *get_evaluator() {return this; }
+
+public:
+    IndexedOpenList(const Options &opts);
+    IndexedOpenList(const std::vector<ScalarEvaluator *> &evals,
+                    bool preferred_only);
+    ~IndexedOpenList();
+
+    // open list interface
+    int insert(const StateID &entry);
+    int insert_batch(const std::vector<StateID> &entries,
+                     const std::vector<int> &entry_keys);
+    StateID remove_min(std::vector<int> *key = 0);
+    bool empty() const;
+    void clear();
+    size_t get_memory_usage() const;
+
+    // evaluator interface
+    void evaluate(int g, bool preferred);
+    bool is_dead_end() const;
+    bool dead_end_is_reliable() const;
+    void get_involved_heuristics(std::set<Heuristic *> &hset);
+
+    static OpenList<StateID> *_parse(OptionParser &parser);
+};
+
+#endif
@@ -2,8 +2,19 @@
 #define OPEN_LISTS_OPEN_LIST_H
 
 #include "../evaluator.h"
+#include "../utilities.h"
+#include <cstddef>
+#include <iostream>
 #include <vector>
 
+/*
+  Rough number of bytes a std::deque bucket occupies besides its
+  entries: libstdc++ allocates deque elements in blocks of 512 bytes
+  and keeps a separate map of block pointers. Used by the open lists
+  to estimate their memory usage (see memory_budget.h).
+*/
+static const size_t DEQUE_BUCKET_OVERHEAD = 512 + 8 * sizeof(void *);
+
 template<class Entry>
 class OpenList : public Evaluator {
 protected:
@@ -20,8 +31,24 @@ public:
     // Then remove_min stores the key for the popped element there.
     // TODO: We might want to solve this differently eventually;
     //       see msg639 in the tracker.
+    /*
+      Inserts entries[i] with the key keys[i * k], ..., keys[i * k + k - 1]
+      for all i, where k is the number of values per key (one per evaluator
+      of the open list). This is for callers that already know the values
+      evaluate() would compute, e.g. HDA* for the nodes it receives, and
+      saves the evaluator calls. The keys must not be dead ends and the
+      entries count as not preferred. Returns the number of inserted
+      entries.
+    */
+    virtual int insert_batch(const std::vector<Entry> &entries,
+                             const std::vector<int> &keys) {
+        std::cerr << "open list does not support insert_batch" << std::endl;
+        exit_with(EXIT_UNSUPPORTED);
+    }
     virtual bool empty() const = 0;
     virtual void clear() = 0;
+    // Approximate number of bytes held by the open list.
+    virtual size_t get_memory_usage() const = 0;
     bool only_preferred_states() const {return only_preferred; }
     // should only be used within alternation open lists
     // a search does not have to care about this because
@@ -64,6 +64,25 @@ int BucketOpenList<Entry>::insert(const Entry &entry) {
     return 1;
 }
 
+template<class Entry>
+int BucketOpenList<Entry>::insert_batch(const vector<Entry> &entries,
+                                        const vector<int> &keys) {
+    if (OpenList<Entry>::only_preferred)
+        return 0;
+    assert(keys.size() == entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        int key = keys[i];
+        assert(key >= 0);
+        if (key >= buckets.size())
+            buckets.resize(key + 1);
+        if (key < lowest_bucket)
+            lowest_bucket = key;
+        buckets[key].push_back(entries[i]);
+    }
+    size += entries.size();
+    return entries.size();
+}
+
 template<class Entry>
 Entry BucketOpenList<Entry>::remove_min(vector<int> *key) {
     assert(size > 0);
@@ -92,6 +111,12 @@ void BucketOpenList<Entry>::clear() {
     size = 0;
 }
 
+template<class Entry>
+size_t BucketOpenList<Entry>::get_memory_usage() const {
+    return size * sizeof(Entry) +
+           buckets.capacity() * (sizeof(Bucket) + DEQUE_BUCKET_OVERHEAD);
+}
+
 template<class Entry>
 void BucketOpenList<Entry>::evaluate(int g, bool preferred) {
     get_evaluator()->evaluate(g, preferred);
@@ -30,9 +30,12 @@ public:
     ~BucketOpenList();
 
     int insert(const Entry &entry);
+    int insert_batch(const std::vector<Entry> &entries,
+                     const std::vector<int> &keys);
     Entry remove_min(std::vector<int> *key = 0);
     bool empty() const;
     void clear();
+    size_t get_memory_usage() const;
 
     void evaluate(int g, bool preferred);
     bool is_dead_end() const;
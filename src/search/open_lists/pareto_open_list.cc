@@ -163,6 +163,19 @@ void ParetoOpenList<Entry>::clear() {
     nondominated.clear();
 }
 
+template<class Entry>
+size_t ParetoOpenList<Entry>::get_memory_usage() const {
+    size_t key_size = evaluators.size() * sizeof(int);
+    size_t usage = buckets.bucket_count() * sizeof(void *) +
+                   nondominated.size() * (4 * sizeof(void *) + key_size);
+    for (typename BucketMap::const_iterator it = buckets.begin();
+         it != buckets.end(); ++it) {
+        usage += sizeof(Bucket) + DEQUE_BUCKET_OVERHEAD + key_size +
+                 it->second.size() * sizeof(Entry);
+    }
+    return usage;
+}
+
 template<class Entry>
 void ParetoOpenList<Entry>::evaluate(int g, bool preferred) {
     dead_end = false;
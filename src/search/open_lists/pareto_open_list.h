@@ -67,6 +67,7 @@ public:
     Entry remove_min(std::vector<int> *key = 0);
     bool empty() const {return nondominated.empty(); }
     void clear();
+    size_t get_memory_usage() const;
 
     // tuple evaluator interface
     void evaluate(int g, bool preferred);
@@ -61,6 +61,22 @@ int StandardScalarOpenList<Entry>::insert(const Entry &entry) {
     return 1;
 }
 
+template<class Entry>
+int StandardScalarOpenList<Entry>::insert_batch(const vector<Entry> &entries,
+                                                const vector<int> &keys) {
+    if (OpenList<Entry>::only_preferred)
+        return 0;
+    assert(keys.size() == entries.size());
+    Bucket *bucket = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!bucket || keys[i] != keys[i - 1])
+            bucket = &buckets[keys[i]];
+        bucket->push_back(entries[i]);
+    }
+    size += entries.size();
+    return entries.size();
+}
+
 template<class Entry>
 Entry StandardScalarOpenList<Entry>::remove_min(vector<int> *key) {
     assert(size > 0);
@@ -92,6 +108,13 @@ void StandardScalarOpenList<Entry>::clear() {
     size = 0;
 }
 
+template<class Entry>
+size_t StandardScalarOpenList<Entry>::get_memory_usage() const {
+    size_t bucket_size = sizeof(Bucket) + DEQUE_BUCKET_OVERHEAD +
+                         4 * sizeof(void *) + sizeof(int);
+    return size * sizeof(Entry) + buckets.size() * bucket_size;
+}
+
 template<class Entry>
 void StandardScalarOpenList<Entry>::evaluate(int g, bool preferred) {
     get_evaluator()->evaluate(g, preferred);
@@ -1,6 +1,7 @@
 // HACK! Ignore this if used as a top-level compile target.
 #ifdef OPEN_LISTS_TIEBREAKING_OPEN_LIST_H
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <limits>
@@ -65,6 +66,29 @@ int TieBreakingOpenList<Entry>::insert(const Entry &entry) {
     return 1;
 }
 
+template<class Entry>
+int TieBreakingOpenList<Entry>::insert_batch(const vector<Entry> &entries,
+                                             const vector<int> &keys) {
+    if (OpenList<Entry>::only_preferred)
+        return 0;
+    size_t dim = dimension();
+    assert(keys.size() == entries.size() * dim);
+    // Consecutive entries often share their key, so we only look up the
+    // bucket when the key changes.
+    vector<int> key(dim);
+    Bucket *bucket = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const int *entry_key = &keys[i * dim];
+        if (!bucket || !equal(key.begin(), key.end(), entry_key)) {
+            key.assign(entry_key, entry_key + dim);
+            bucket = &buckets[key];
+        }
+        bucket->push_back(entries[i]);
+    }
+    size += entries.size();
+    return entries.size();
+}
+
 template<class Entry>
 Entry TieBreakingOpenList<Entry>::remove_min(vector<int> *key) {
     assert(size > 0);
@@ -95,6 +119,14 @@ void TieBreakingOpenList<Entry>::clear() {
     size = 0;
 }
 
+template<class Entry>
+size_t TieBreakingOpenList<Entry>::get_memory_usage() const {
+    // Every map node additionally stores its key vector.
+    size_t bucket_size = sizeof(Bucket) + DEQUE_BUCKET_OVERHEAD +
+                         4 * sizeof(void *) + dimension() * sizeof(int);
+    return size * sizeof(Entry) + buckets.size() * bucket_size;
+}
+
 template<class Entry>
 void TieBreakingOpenList<Entry>::evaluate(int g, bool preferred) {
     dead_end = false;
@@ -42,9 +42,12 @@ public:
 
     // open list interface
     int insert(const Entry &entry);
+    int insert_batch(const std::vector<Entry> &entries,
+                     const std::vector<int> &keys);
     Entry remove_min(std::vector<int> *key = 0);
     bool empty() const;
     void clear();
+    size_t get_memory_usage() const;
 
     // tuple evaluator interface
     void evaluate(int g, bool preferred);
@@ -1,3 +1,4 @@
+#include "binary_task_file.h"
 #include "globals.h"
 #include "operator.h"
 
@@ -8,6 +9,10 @@ Prevail::Prevail(istream &in) {
     in >> var >> prev;
 }
 
+Prevail::Prevail(BinaryTaskFile &in) {
+    in >> var >> prev;
+}
+
 PrePost::PrePost(istream &in) {
     int condCount;
     in >> condCount;
@@ -16,6 +21,14 @@ PrePost::PrePost(istream &in) {
     in >> var >> pre >> post;
 }
 
+PrePost::PrePost(BinaryTaskFile &in) {
+    int condCount = in.read_int();
+    cond.reserve(condCount);
+    for (int i = 0; i < condCount; i++)
+        cond.push_back(Prevail(in));
+    in >> var >> pre >> post;
+}
+
 Operator::Operator(istream &in, bool axiom) {
     marked = false;
 
@@ -51,6 +64,35 @@ Operator::Operator(istream &in, bool axiom) {
     marker1 = marker2 = false;
 }
 
+Operator::Operator(BinaryTaskFile &in, bool axiom) {
+    marked = false;
+
+    is_an_axiom = axiom;
+    if (!is_an_axiom) {
+        name = in.read_string();
+        int count = in.read_int();
+        prevail.reserve(count);
+        for (int i = 0; i < count; i++)
+            prevail.push_back(Prevail(in));
+        count = in.read_int();
+        pre_post.reserve(count);
+        for (int i = 0; i < count; i++)
+            pre_post.push_back(PrePost(in));
+
+        int op_cost = in.read_int();
+        cost = g_use_metric ? op_cost : 1;
+
+        g_min_action_cost = min(g_min_action_cost, cost);
+        g_max_action_cost = max(g_max_action_cost, cost);
+    } else {
+        name = "<axiom>";
+        cost = 0;
+        pre_post.push_back(PrePost(in));
+    }
+
+    marker1 = marker2 = false;
+}
+
 void Prevail::dump() const {
     cout << g_variable_name[var] << ": " << prev;
 }
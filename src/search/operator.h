@@ -9,10 +9,13 @@
 #include "globals.h"
 #include "state.h"
 
+class BinaryTaskFile;
+
 struct Prevail {
     int var;
     int prev;
     Prevail(std::istream &in);
+    Prevail(BinaryTaskFile &in);
     Prevail(int v, int p) : var(v), prev(p) {}
 
     bool is_applicable(const State &state) const {
@@ -45,6 +48,7 @@ struct PrePost {
     std::vector<Prevail> cond;
     PrePost() {} // Needed for axiom file-reading constructor, unfortunately.
     PrePost(std::istream &in);
+    PrePost(BinaryTaskFile &in);
     PrePost(int v, int pr, int po, const std::vector<Prevail> &co)
         : var(v), pre(pr), post(po), cond(co) {}
 
@@ -81,6 +85,7 @@ class Operator {
     mutable bool marked; // Used for short-term marking of preferred operators
 public:
     Operator(std::istream &in, bool is_axiom);
+    Operator(BinaryTaskFile &in, bool is_axiom);
     void dump() const;
     std::string get_name() const {return name; }
 
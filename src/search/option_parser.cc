@@ -218,6 +218,17 @@ SearchEngine *OptionParser::parse_cmd_line(
         } else if (arg.compare("--plan-file") == 0) {
             ++i;
             g_plan_filename = argv[i];
+        } else if (arg.compare("--memory-limit") == 0) {
+            ++i;
+            g_memory_limit_in_mb = atoi(argv[i]);
+            if (g_memory_limit_in_mb <= 0) {
+                cerr << "memory limit must be a positive number of MB"
+                     << endl;
+                exit_with(EXIT_INPUT_ERROR);
+            }
+        } else if (arg.compare("--task-loading") == 0) {
+            // Already used by load_task in main.
+            ++i;
         } else if (arg.compare("--distribution") == 0) {
 //            ++i;
             // TODO: implement distribution option method
@@ -250,6 +261,14 @@ string OptionParser::usage(string progname) {
         "    Use random seed SEED\n\n"
         "--plan-file FILENAME\n"
         "    Plan will be output to a file called FILENAME\n\n"
+        "--memory-limit MB\n"
+        "    Let the search react in an orderly way (see the memory_policy\n"
+        "    option of the search engines) before using more than MB\n"
+        "    megabytes of memory\n\n"
+        "--task-loading MODE\n"
+        "    How MPI processes read OUTPUT: file (every process reads it),\n"
+        "    broadcast (rank 0 reads it and broadcasts it) or shared\n"
+        "    (like broadcast, but one copy per node in shared memory)\n\n"
         "See http://www.fast-downward.org/ for details.";
     return usage;
 }
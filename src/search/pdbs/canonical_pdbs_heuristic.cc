@@ -13,23 +13,41 @@
 #include "../timer.h"
 #include "../utilities.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <ext/hash_map>
+#include <limits>
 #include <vector>
 
 using namespace std;
+using namespace __gnu_cxx;
 
 CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(const Options &opts)
     : Heuristic(opts) {
     const vector<vector<int> > &pattern_collection(opts.get_list<vector<int> >("patterns"));
     Timer timer;
+    pdb_options.set<int>("cost_type", cost_type);
+    copy_storage_options(opts, pdb_options);
     size = 0;
-    pattern_databases.reserve(pattern_collection.size());
-    for (size_t i = 0; i < pattern_collection.size(); ++i)
-        _add_pattern(pattern_collection[i]);
+    pattern_databases.resize(pattern_collection.size());
+    int num_patterns = pattern_collection.size();
+#ifdef _OPENMP
+    // Shared PDBs are built collectively by all MPI ranks, one after the other.
+    bool shared = pdb_options.contains("shared") && pdb_options.get<bool>("shared");
+#pragma omp parallel for schedule(dynamic) if (!shared)
+#endif
+    for (int i = 0; i < num_patterns; ++i) {
+        Options opts(pdb_options);
+        opts.set<vector<int> >("pattern", pattern_collection[i]);
+        pattern_databases[i] = new PDBHeuristic(opts, false);
+    }
+    for (size_t i = 0; i < pattern_databases.size(); ++i)
+        size += pattern_databases[i]->get_size();
     compute_additive_vars();
     compute_max_cliques();
     cout << "PDB collection construction time: " << timer << endl;
+    dump_compression_statistics();
 }
 
 CanonicalPDBsHeuristic::~CanonicalPDBsHeuristic() {
@@ -39,8 +57,7 @@ CanonicalPDBsHeuristic::~CanonicalPDBsHeuristic() {
 }
 
 void CanonicalPDBsHeuristic::_add_pattern(const vector<int> &pattern) {
-    Options opts;
-    opts.set<int>("cost_type", cost_type);
+    Options opts(pdb_options);
     opts.set<vector<int> >("pattern", pattern);
     pattern_databases.push_back(new PDBHeuristic(opts, false));
     size += pattern_databases.back()->get_size();
@@ -87,6 +104,69 @@ void CanonicalPDBsHeuristic::compute_max_cliques() {
         }
         max_cliques.push_back(clique);
     }
+    build_evaluator();
+}
+
+void CanonicalPDBsHeuristic::build_evaluator() {
+    int num_pdbs = pattern_databases.size();
+    max_pattern_size = 0;
+    for (size_t i = 0; i < pattern_databases.size(); ++i)
+        max_pattern_size = max(max_pattern_size,
+                               int(pattern_databases[i]->get_pattern().size()));
+
+    lookup_vars.assign(max_pattern_size * num_pdbs, 0);
+    lookup_multipliers.assign(max_pattern_size * num_pdbs, 0);
+    pdb_distances.resize(num_pdbs);
+    for (int p = 0; p < num_pdbs; ++p) {
+        const PDBHeuristic *pdb = pattern_databases[p];
+        const vector<int> &pattern = pdb->get_pattern();
+        const vector<size_t> &multipliers = pdb->get_hash_multipliers();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            // The PDB sizes are below numeric_limits<int>::max().
+            lookup_vars[i * num_pdbs + p] = pattern[i];
+            lookup_multipliers[i * num_pdbs + p] = multipliers[i];
+        }
+        // PDBs with packed distances are looked up through get_distance.
+        pdb_distances[p] = pdb->has_packed_distances() ? 0 : pdb->get_distances();
+    }
+
+    hash_map<const PDBHeuristic *, int, hash_pointer> pdb_index;
+    for (int p = 0; p < num_pdbs; ++p)
+        pdb_index[pattern_databases[p]] = p;
+    clique_begin.clear();
+    clique_members.clear();
+    for (size_t i = 0; i < max_cliques.size(); ++i) {
+        clique_begin.push_back(clique_members.size());
+        for (size_t j = 0; j < max_cliques[i].size(); ++j)
+            clique_members.push_back(pdb_index[max_cliques[i][j]]);
+    }
+    clique_begin.push_back(clique_members.size());
+
+    pdb_values.resize(num_pdbs);
+}
+
+bool CanonicalPDBsHeuristic::compute_pdb_values(const State &state) {
+    int num_pdbs = pattern_databases.size();
+    const state_var_t *values = state.get_raw_data();
+    int *indices = pdb_values.data();
+    // Without dependencies between the PDBs, the compiler can vectorize the
+    // inner loops.
+    fill(indices, indices + num_pdbs, 0);
+    for (int i = 0; i < max_pattern_size; ++i) {
+        const int *vars = &lookup_vars[i * num_pdbs];
+        const int *multipliers = &lookup_multipliers[i * num_pdbs];
+        for (int p = 0; p < num_pdbs; ++p)
+            indices[p] += multipliers[p] * values[vars[p]];
+    }
+    bool dead_end = false;
+    for (int p = 0; p < num_pdbs; ++p) {
+        const int *distances = pdb_distances[p];
+        int h = distances ? distances[indices[p]] :
+                pattern_databases[p]->get_distance(indices[p]);
+        dead_end |= (h == numeric_limits<int>::max());
+        pdb_values[p] = h;
+    }
+    return !dead_end;
 }
 
 void CanonicalPDBsHeuristic::compute_additive_vars() {
@@ -110,6 +190,7 @@ void CanonicalPDBsHeuristic::dominance_pruning() {
     int num_cliques = max_cliques.size();
 
     DominancePruner(pattern_databases, max_cliques).prune();
+    build_evaluator();
 
     // Adjust size.
     size = 0;
@@ -133,22 +214,23 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &state) {
     assert(!max_cliques.empty());
     // if we have an empty collection, then max_cliques = { \emptyset }
 
-    for (size_t i = 0; i < pattern_databases.size(); ++i) {
-        pattern_databases[i]->evaluate(state);
-        if (pattern_databases[i]->is_dead_end())
-            return DEAD_END;
-    }
-    for (size_t i = 0; i < max_cliques.size(); ++i) {
-        const vector<PDBHeuristic *> &clique = max_cliques[i];
+    if (!compute_pdb_values(state))
+        return DEAD_END;
+    for (size_t i = 0; i + 1 < clique_begin.size(); ++i) {
         int clique_h = 0;
-        for (size_t j = 0; j < clique.size(); ++j) {
-            clique_h += clique[j]->get_heuristic();
-        }
+        for (int j = clique_begin[i]; j < clique_begin[i + 1]; ++j)
+            clique_h += pdb_values[clique_members[j]];
         max_h = max(max_h, clique_h);
     }
     return max_h;
 }
 
+void CanonicalPDBsHeuristic::compute_heuristic_batch(const State *states,
+                                                     int n, int *out) {
+    for (int i = 0; i < n; ++i)
+        out[i] = compute_heuristic(states[i]);
+}
+
 void CanonicalPDBsHeuristic::add_pattern(const vector<int> &pattern) {
     _add_pattern(pattern);
     compute_max_cliques();
@@ -224,15 +306,24 @@ void CanonicalPDBsHeuristic::get_max_additive_subsets(
 }
 
 void CanonicalPDBsHeuristic::evaluate_dead_end(const State &state) {
-    int evaluator_value = 0;
+    set_evaluator_value(compute_pdb_values(state) ? 0 : DEAD_END);
+}
+
+void CanonicalPDBsHeuristic::dump_compression_statistics() const {
+    bool packed = pdb_options.contains("entry_bits") &&
+                  pdb_options.get<int>("entry_bits") != 32;
+    bool min_compressed = pdb_options.contains("min_compression") &&
+                          pdb_options.get<int>("min_compression") > 1;
+    if (!packed && !min_compressed)
+        return;
+    double uncompressed_mean_h = 0;
+    double mean_h = 0;
     for (size_t i = 0; i < pattern_databases.size(); ++i) {
-        pattern_databases[i]->evaluate(state);
-        if (pattern_databases[i]->is_dead_end()) {
-            evaluator_value = DEAD_END;
-            break;
-        }
+        uncompressed_mean_h += pattern_databases[i]->get_uncompressed_mean_finite_h();
+        mean_h += pattern_databases[i]->compute_mean_finite_h();
     }
-    set_evaluator_value(evaluator_value);
+    cout << "PDB compression: summed mean finite h of the PDBs "
+         << uncompressed_mean_h << " -> " << mean_h << endl;
 }
 
 void CanonicalPDBsHeuristic::dump_cgraph(const vector<vector<int> > &cgraph) const {
@@ -2,6 +2,7 @@
 #define PDBS_CANONICAL_PDBS_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../option_parser.h"
 
 #include <vector>
 
@@ -12,6 +13,22 @@ class CanonicalPDBsHeuristic : public Heuristic {
     std::vector<std::vector<PDBHeuristic *> > max_cliques; // final computed max_cliques
     std::vector<std::vector<bool> > are_additive; // pair of variables which are additive
     std::vector<PDBHeuristic *> pattern_databases; // final pattern databases
+    Options pdb_options; // cost type and compression options of the PDBs
+
+    /* Flat copy of pattern_databases and max_cliques used for evaluation,
+       built by build_evaluator. The i-th pattern variable of PDB p and its
+       hash multiplier are stored at i * pattern_databases.size() + p, so the
+       hash indices of all PDBs are computed together, one pattern position
+       at a time. Shorter patterns are padded with multiplier 0. The cliques
+       are lists of PDB indices in compressed sparse row form. */
+    int max_pattern_size;
+    std::vector<int> lookup_vars;
+    std::vector<int> lookup_multipliers;
+    std::vector<const int *> pdb_distances;
+    std::vector<int> clique_begin;
+    std::vector<int> clique_members;
+    // scratch space of compute_pdb_values
+    std::vector<int> pdb_values;
 
     /* Returns true iff the two patterns are additive i.e. there is no operator
        which affects variables in pattern one as well as in pattern two. */
@@ -26,6 +43,13 @@ class CanonicalPDBsHeuristic : public Heuristic {
        both variables at the same time. */
     void compute_additive_vars();
 
+    // Rebuilds the flat evaluator after pattern_databases or max_cliques changed.
+    void build_evaluator();
+
+    /* Looks up all PDBs for the given state and stores the h-values in
+       pdb_values. Returns false iff one of them is a dead end. */
+    bool compute_pdb_values(const State &state);
+
     // does not recompute max_cliques
     void _add_pattern(const std::vector<int> &pattern);
 
@@ -34,6 +58,8 @@ class CanonicalPDBsHeuristic : public Heuristic {
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual void compute_heuristic_batch(const State *states, int n,
+                                         int *out);
 public:
     CanonicalPDBsHeuristic(const Options &opts);
     virtual ~CanonicalPDBsHeuristic();
@@ -59,6 +85,8 @@ public:
     const std::vector<PDBHeuristic *> &get_pattern_databases() const {return pattern_databases; }
     int get_size() const {return size; }
     void dump() const;
+    // prints the loss of heuristic quality due to PDB compression, if any
+    void dump_compression_statistics() const;
 };
 
 #endif
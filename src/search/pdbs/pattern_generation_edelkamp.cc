@@ -5,6 +5,8 @@
 
 #include "../globals.h"
 #include "../legacy_causal_graph.h"
+#include "../operator.h"
+#include "../option_parser.h"
 #include "../plugin.h"
 #include "../rng.h"
 #include "../timer.h"
@@ -27,6 +29,15 @@ PatternGenerationEdelkamp::PatternGenerationEdelkamp(const Options &opts)
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
       cost_type(OperatorCost(opts.get<int>("cost_type"))) {
+    operators_affecting_variable.resize(g_variable_domain.size());
+    for (size_t op_no = 0; op_no < g_operators.size(); ++op_no) {
+        const vector<PrePost> &pre_post = g_operators[op_no].get_pre_post();
+        for (size_t i = 0; i < pre_post.size(); ++i) {
+            vector<int> &ops = operators_affecting_variable[pre_post[i].var];
+            if (ops.empty() || ops.back() != static_cast<int>(op_no))
+                ops.push_back(op_no);
+        }
+    }
     Timer timer;
     genetic_algorithm();
     cout << "Pattern generation (Edelkamp) time: " << timer << endl;
@@ -144,13 +155,74 @@ bool PatternGenerationEdelkamp::mark_used_variables(
     return false;
 }
 
+const PatternGenerationEdelkamp::PDBSummary &PatternGenerationEdelkamp::get_pdb_summary(
+    const vector<int> &pattern, const vector<int> &operator_costs) {
+    vector<int> affecting_operators;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        const vector<int> &ops = operators_affecting_variable[pattern[i]];
+        affecting_operators.insert(affecting_operators.end(), ops.begin(), ops.end());
+    }
+    sort(affecting_operators.begin(), affecting_operators.end());
+    affecting_operators.erase(unique(affecting_operators.begin(), affecting_operators.end()),
+                              affecting_operators.end());
+    vector<int> key(pattern);
+    key.push_back(-1);
+    for (size_t i = 0; i < affecting_operators.size(); ++i)
+        key.push_back(operator_costs[affecting_operators[i]]);
+
+    // std::map does not move its entries, so the returned reference stays valid.
+    map<vector<int>, PDBSummary>::const_iterator it;
+    bool cached;
+#pragma omp critical(edelkamp_pdb_cache)
+    {
+        it = pdb_cache.find(key);
+        cached = it != pdb_cache.end();
+    }
+    if (cached)
+        return it->second;
+
+    // Two threads may build the same PDB. They get the same summary.
+    Options opts;
+    opts.set<int>("cost_type", cost_type);
+    opts.set<vector<int> >("pattern", pattern);
+    PDBHeuristic pdb(opts, false, operator_costs);
+    PDBSummary summary;
+    summary.mean_finite_h = pdb.compute_mean_finite_h();
+    const vector<bool> &relevant = pdb.get_relevant_operators();
+    for (size_t op_no = 0; op_no < relevant.size(); ++op_no) {
+        if (relevant[op_no])
+            summary.relevant_operators.push_back(op_no);
+    }
+#pragma omp critical(edelkamp_pdb_cache)
+    it = pdb_cache.insert(make_pair(key, summary)).first;
+    return it->second;
+}
+
+double PatternGenerationEdelkamp::compute_fitness(const vector<vector<int> > &pattern_collection) {
+    // Same action cost partitioning and summation order as in ZeroOnePDBsHeuristic.
+    vector<int> operator_costs;
+    operator_costs.reserve(g_operators.size());
+    for (size_t i = 0; i < g_operators.size(); ++i)
+        operator_costs.push_back(get_adjusted_action_cost(g_operators[i], cost_type));
+    double fitness = 0;
+    for (size_t i = 0; i < pattern_collection.size(); ++i) {
+        const PDBSummary &summary = get_pdb_summary(pattern_collection[i], operator_costs);
+        fitness += summary.mean_finite_h;
+        for (size_t j = 0; j < summary.relevant_operators.size(); ++j)
+            operator_costs[summary.relevant_operators[j]] = 0;
+    }
+    return fitness;
+}
+
 void PatternGenerationEdelkamp::evaluate(vector<double> &fitness_values) {
+    int num_pattern_collections = pattern_collections.size();
+    vector<vector<vector<int> > > valid_collections(num_pattern_collections);
+    vector<bool> is_valid(num_pattern_collections, false);
     for (size_t i = 0; i < pattern_collections.size(); ++i) {
         //cout << "evaluate pattern collection " << (i + 1) << " of " << pattern_collections.size() << endl;
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(g_variable_domain.size(), false);
-        vector<vector<int> > pattern_collection;
+        vector<vector<int> > &pattern_collection = valid_collections[i];
         pattern_collection.reserve(pattern_collections[i].size());
         for (size_t j = 0; j < pattern_collections[i].size(); ++j) {
             const vector<bool> &bitvector = pattern_collections[i][j];
@@ -174,29 +246,24 @@ void PatternGenerationEdelkamp::evaluate(vector<double> &fitness_values) {
             remove_irrelevant_variables(pattern);
             pattern_collection.push_back(pattern);
         }
-        if (!pattern_valid) {
-            // set fitness to a very small value to cover cases in which all patterns are invalid
-            fitness = 0.001;
-        } else {
-            // generate the pattern collection heuristic and get its fitness value.
-            Options opts;
-            opts.set<int>("cost_type", cost_type);
-            opts.set<vector<vector<int> > >("patterns", pattern_collection);
-            ZeroOnePDBsHeuristic *zoppch =
-                new ZeroOnePDBsHeuristic(opts);
-            fitness = zoppch->get_approx_mean_finite_h();
-            // update the best heuristic found so far.
-            if (fitness > best_fitness) {
-                best_fitness = fitness;
-                cout << "best_fitness = " << best_fitness << endl;
-                delete best_heuristic;
-                best_heuristic = zoppch;
-                //best_heuristic->dump();
-            } else {
-                delete zoppch;
-            }
+        is_valid[i] = pattern_valid;
+    }
+
+    // set fitness to a very small value to cover cases in which all patterns are invalid
+    fitness_values.assign(num_pattern_collections, 0.001);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        if (is_valid[i])
+            fitness_values[i] = compute_fitness(valid_collections[i]);
+    }
+
+    // update the best pattern collection found so far.
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        if (is_valid[i] && fitness_values[i] > best_fitness) {
+            best_fitness = fitness_values[i];
+            cout << "best_fitness = " << best_fitness << endl;
+            best_collection = valid_collections[i];
         }
-        fitness_values.push_back(fitness);
     }
 }
 
@@ -261,6 +328,14 @@ void PatternGenerationEdelkamp::genetic_algorithm() {
         //cout << "current pattern collections (after selection):" << endl;
         //dump();
     }
+    cout << "Cached PDBs: " << pdb_cache.size() << endl;
+
+    if (best_fitness >= 0) {
+        Options opts;
+        opts.set<int>("cost_type", cost_type);
+        opts.set<vector<vector<int> > >("patterns", best_collection);
+        best_heuristic = new ZeroOnePDBsHeuristic(opts);
+    }
 }
 
 void PatternGenerationEdelkamp::dump() const {
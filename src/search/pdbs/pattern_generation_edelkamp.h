@@ -3,6 +3,7 @@
 
 #include "../operator_cost.h"
 
+#include <map>
 #include <vector>
 
 class Options;
@@ -24,9 +25,29 @@ class PatternGenerationEdelkamp {
 
     // store the fitness value of the best pattern collection over all episodes
     double best_fitness;
-    // pointer to the heuristic in evaluate from the episode before, used to free memory.
+    // the best pattern collection (normalized as in evaluate) and its heuristic, built at the end
+    std::vector<std::vector<int> > best_collection;
     ZeroOnePDBsHeuristic *best_heuristic;
 
+    /* What evaluate needs to know about the PDB of a pattern in a collection. The PDB is
+       determined by the pattern and the costs of the operators affecting it, which depend
+       on the patterns before it in the collection. Summaries are cached across collections
+       and episodes with the key pattern, -1, costs of the affecting operators. */
+    struct PDBSummary {
+        double mean_finite_h;
+        std::vector<int> relevant_operators;
+    };
+    std::map<std::vector<int>, PDBSummary> pdb_cache;
+    std::vector<std::vector<int> > operators_affecting_variable;
+
+    // Thread-safe. Builds the PDB unless it is cached.
+    const PDBSummary &get_pdb_summary(const std::vector<int> &pattern,
+                                      const std::vector<int> &operator_costs);
+
+    /* Returns the summed up mean finite h-values of the PDBs of the zero-one partitioning
+       heuristic for the given collection, as ZeroOnePDBsHeuristic computes it. Thread-safe. */
+    double compute_fitness(const std::vector<std::vector<int> > &pattern_collection);
+
     /* The fitness values (from evaluate) are used as probabilities. Then num_collections many
        pattern collections are chosen from the vector of all pattern collections according to their
        probabilities. If all fitness values are 0, we select uniformly randomly.
@@ -46,9 +67,9 @@ class PatternGenerationEdelkamp {
     /* Calculates the mean h-value (fitness value) for each pattern collection.
        For each pattern collection, we iterate over all patterns, first checking whether they respect the
        size limit, then modifying them in a way that only causally relevant variables remain in the patterns.
-       Then the zero one partitioning pattern collection heuristic is constructed and its fitness ( = summed
-       up mean h-values (dead ends are ignored) of all PDBs in the collection) computed.
-       The overall best heuristic is eventually updated and saved for further episodes. */
+       Then the fitness of the zero one partitioning pattern collection heuristic ( = summed up mean h-values
+       (dead ends are ignored) of all PDBs in the collection) is computed, for several collections in parallel.
+       The overall best collection is eventually updated and saved for further episodes. */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const std::vector<int> &pattern) const;
 
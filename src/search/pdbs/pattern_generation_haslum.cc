@@ -2,9 +2,12 @@
 
 #include "canonical_pdbs_heuristic.h"
 #include "pdb_heuristic.h"
+#include "util.h"
 
 #include "../globals.h"
+#include "../heuristic_cache.h"
 #include "../legacy_causal_graph.h"
+#include "../node_shared_memory.h"
 #include "../operator.h"
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -19,7 +22,10 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -31,9 +37,44 @@ PatternGenerationHaslum::PatternGenerationHaslum(const Options &opts)
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       cost_type(OperatorCost(opts.get<int>("cost_type"))),
+      current_heuristic(0),
       num_rejected(0) {
+    pdb_options.set<int>("cost_type", cost_type);
+    copy_storage_options(opts, pdb_options);
+    bool shared = opts.get<bool>("shared");
+    // With shared PDBs, only the node leader climbs (with its own PDBs).
+    pdb_options.set<bool>("shared", false);
+    // Only the PDBs of the final collection are cached, not the candidates.
+    string cache_dir = HeuristicCache::get_directory(opts);
+    pdb_options.storage.erase("cache_dir");
     Timer timer;
-    initialize();
+    if (!shared || is_node_leader()) {
+        if (cache_dir.empty()) {
+            initialize();
+        } else {
+            HeuristicCache cache(cache_dir, get_cache_key());
+            vector<vector<int> > patterns;
+            if (cache.load()) {
+                cout << "Loaded pattern collection from " << cache.get_filename() << endl;
+                decode_pattern_collection(reinterpret_cast<const int *>(cache.get_data()), patterns);
+            } else {
+                initialize();
+                vector<int> collection;
+                encode_pattern_collection(collection);
+                cache.save(reinterpret_cast<const char *>(&collection[0]),
+                           collection.size() * sizeof(int));
+                decode_pattern_collection(&collection[0], patterns);
+            }
+            // Build the final collection again, this time with cached PDBs.
+            delete current_heuristic;
+            Options final_opts(pdb_options);
+            final_opts.set<string>("cache_dir", cache_dir);
+            final_opts.set<vector<vector<int> > >("patterns", patterns);
+            current_heuristic = new CanonicalPDBsHeuristic(final_opts);
+        }
+    }
+    if (shared)
+        share_pattern_collection(cache_dir);
     cout << "Pattern generation (Haslum et al.) time: " << timer << endl;
 }
 
@@ -73,18 +114,26 @@ size_t PatternGenerationHaslum::generate_pdbs_for_candidates(set<vector<int> > &
                                                              vector<PDBHeuristic *> &candidate_pdbs) const {
     // For the new candidate patterns check whether they already have been candidates before and
     // thus already a PDB has been created an inserted into candidate_pdbs.
-    size_t max_pdb_size = 0;
+    vector<const vector<int> *> patterns;
     for (size_t i = 0; i < new_candidates.size(); ++i) {
-        if (generated_patterns.count(new_candidates[i]) == 0) {
-            Options opts;
-            opts.set<int>("cost_type", cost_type);
-            opts.set<vector<int> >("pattern", new_candidates[i]);
-            candidate_pdbs.push_back(new PDBHeuristic(opts, false));
-            max_pdb_size = max(max_pdb_size,
-                               candidate_pdbs.back()->get_size());
-            generated_patterns.insert(new_candidates[i]);
-        }
+        if (generated_patterns.insert(new_candidates[i]).second)
+            patterns.push_back(&new_candidates[i]);
+    }
+
+    // The PDBs are built in parallel, but appended in the order of new_candidates.
+    size_t first = candidate_pdbs.size();
+    candidate_pdbs.resize(first + patterns.size());
+    int num_patterns = patterns.size();
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < num_patterns; ++i) {
+        Options opts(pdb_options);
+        opts.set<vector<int> >("pattern", *patterns[i]);
+        candidate_pdbs[first + i] = new PDBHeuristic(opts, false);
     }
+
+    size_t max_pdb_size = 0;
+    for (size_t i = first; i < candidate_pdbs.size(); ++i)
+        max_pdb_size = max(max_pdb_size, candidate_pdbs[i]->get_size());
     return max_pdb_size;
 }
 
@@ -156,10 +205,23 @@ std::pair<int, int> PatternGenerationHaslum::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    // The h-values of the current collection and of its PDBs for all samples.
+    const vector<PDBHeuristic *> &pdbs = current_heuristic->get_pattern_databases();
+    vector<int> collection_values(samples.size());
+    vector<vector<int> > pdb_values(pdbs.size(), vector<int>(samples.size()));
+    for (size_t j = 0; j < samples.size(); ++j) {
+        current_heuristic->evaluate(samples[j]);
+        collection_values[j] = current_heuristic->get_heuristic();
+        for (size_t p = 0; p < pdbs.size(); ++p)
+            pdb_values[p][j] = pdbs[p]->get_distance(samples[j]);
+    }
+
+    // Collect the candidates with their max additive subsets (as indices into pdbs)
+    vector<int> candidates;
+    vector<vector<vector<int> > > candidate_subsets;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
         PDBHeuristic *pdb_heuristic = candidate_pdbs[i];
-        if (pdb_heuristic == 0) { 
+        if (pdb_heuristic == 0) {
             // candidate pattern is too large or has already been added to
             // the canonical heuristic.
             continue;
@@ -171,19 +233,39 @@ std::pair<int, int> PatternGenerationHaslum::find_best_improving_pdb(
             candidate_pdbs[i] = 0;
             continue;
         }
-
-        // Calculate the "counting approximation" for all sample states: count the number of
-        // samples for which the current pattern collection heuristic would be improved
-        // if the new pattern was included into it.
-        // TODO: The original implementation by Haslum et al. uses m/t as a statistical
-        // confidence intervall to stop the astar-search (which they use, see above) earlier.
-        int count = 0;
         vector<vector<PDBHeuristic *> > max_additive_subsets;
         current_heuristic->get_max_additive_subsets(pdb_heuristic->get_pattern(), max_additive_subsets);
+        candidates.push_back(i);
+        candidate_subsets.push_back(vector<vector<int> >(max_additive_subsets.size()));
+        for (size_t k = 0; k < max_additive_subsets.size(); ++k) {
+            for (size_t l = 0; l < max_additive_subsets[k].size(); ++l) {
+                int p = find(pdbs.begin(), pdbs.end(), max_additive_subsets[k][l]) - pdbs.begin();
+                candidate_subsets.back()[k].push_back(p);
+            }
+        }
+    }
+
+    // Calculate the "counting approximation" for all sample states: count the number of
+    // samples for which the current pattern collection heuristic would be improved
+    // if the new pattern was included into it. The candidates are counted in parallel.
+    // TODO: The original implementation by Haslum et al. uses m/t as a statistical
+    // confidence intervall to stop the astar-search (which they use, see above) earlier.
+    int num_candidates = candidates.size();
+    vector<int> counts(num_candidates, 0);
+#pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < num_candidates; ++c) {
+        const PDBHeuristic *pdb_heuristic = candidate_pdbs[candidates[c]];
         for (size_t j = 0; j < samples.size(); ++j) {
-            if (is_heuristic_improved(pdb_heuristic, samples[j], max_additive_subsets))
-                ++count;
+            if (is_heuristic_improved(pdb_heuristic->get_distance(samples[j]), j,
+                                      collection_values[j], pdb_values, candidate_subsets[c]))
+                ++counts[c];
         }
+    }
+
+    // Pick the first best candidate in the order of candidate_pdbs.
+    for (int c = 0; c < num_candidates; ++c) {
+        int i = candidates[c];
+        int count = counts[c];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -197,23 +279,18 @@ std::pair<int, int> PatternGenerationHaslum::find_best_improving_pdb(
     return make_pair(improvement, best_pdb_index);
 }
 
-bool PatternGenerationHaslum::is_heuristic_improved(PDBHeuristic *pdb_heuristic,
-                                                    const State &sample,
-                                                    const vector<vector<PDBHeuristic *> > &max_additive_subsets) {
-    pdb_heuristic->evaluate(sample);
-    if (pdb_heuristic->is_dead_end()) {
+bool PatternGenerationHaslum::is_heuristic_improved(int h_pattern, int sample, int h_collection,
+                                                    const vector<vector<int> > &pdb_values,
+                                                    const vector<vector<int> > &max_additive_subsets) {
+    if (h_pattern == numeric_limits<int>::max()) {
         return true;
     }
-    int h_pattern = pdb_heuristic->get_heuristic(); // h-value of the new pattern
-
-    current_heuristic->evaluate(sample);
-    int h_collection = current_heuristic->get_heuristic(); // h-value of the current collection heuristic
     for (size_t k = 0; k < max_additive_subsets.size(); ++k) { // for each max additive subset...
         int h_subset = 0;
         for (size_t l = 0; l < max_additive_subsets[k].size(); ++l) { // ...calculate its h-value
-            max_additive_subsets[k][l]->evaluate(sample);
-            assert(!max_additive_subsets[k][l]->is_dead_end());
-            h_subset += max_additive_subsets[k][l]->get_heuristic();
+            int h = pdb_values[max_additive_subsets[k][l]][sample];
+            assert(h != numeric_limits<int>::max());
+            h_subset += h;
         }
         if (h_pattern + h_subset > h_collection) {
             // return true if one max additive subest is found for which the condition is met
@@ -275,6 +352,7 @@ void PatternGenerationHaslum::hill_climbing(double average_operator_cost,
             cout << "iPDB: generated = " << generated_patterns.size() << endl;
             cout << "iPDB: rejected = " << num_rejected << endl;
             cout << "iPDB: max_pdb_size = " << max_pdb_size << endl;
+            current_heuristic->dump_compression_statistics();
             break;
         }
 
@@ -303,6 +381,65 @@ void PatternGenerationHaslum::hill_climbing(double average_operator_cost,
     }
 }
 
+void PatternGenerationHaslum::encode_pattern_collection(vector<int> &collection) const {
+    const vector<PDBHeuristic *> &pdbs = current_heuristic->get_pattern_databases();
+    collection.push_back(pdbs.size());
+    for (size_t i = 0; i < pdbs.size(); ++i) {
+        const vector<int> &pattern = pdbs[i]->get_pattern();
+        collection.push_back(pattern.size());
+        collection.insert(collection.end(), pattern.begin(), pattern.end());
+    }
+}
+
+void PatternGenerationHaslum::decode_pattern_collection(const int *data,
+                                                        vector<vector<int> > &patterns) {
+    patterns.resize(*data++);
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        int pattern_size = *data++;
+        patterns[i].assign(data, data + pattern_size);
+        data += pattern_size;
+    }
+}
+
+string PatternGenerationHaslum::get_cache_key() const {
+    ostringstream key;
+    key << "ipdb" << endl
+        << "pdb_max_size: " << pdb_max_size << endl
+        << "collection_max_size: " << collection_max_size << endl
+        << "num_samples: " << num_samples << endl
+        << "min_improvement: " << min_improvement << endl
+        << "cost_type: " << cost_type << endl;
+    if (pdb_options.contains("min_compression"))
+        key << "min_compression: " << pdb_options.get<int>("min_compression") << endl;
+    if (pdb_options.contains("entry_bits"))
+        key << "entry_bits: " << pdb_options.get<int>("entry_bits") << endl;
+    // The samples are drawn with g_rng.
+    key << "random state: " << g_rng.get_state_hash() << endl;
+    return key.str();
+}
+
+void PatternGenerationHaslum::share_pattern_collection(const string &cache_dir) {
+    vector<int> collection;
+    if (is_node_leader()) {
+        encode_pattern_collection(collection);
+        delete current_heuristic;
+    }
+    NodeSharedBlock block(collection.size() * sizeof(int));
+    if (!collection.empty())
+        memcpy(block.get_writable_data(), &collection[0],
+               collection.size() * sizeof(int));
+    block.publish();
+
+    vector<vector<int> > patterns;
+    decode_pattern_collection(reinterpret_cast<const int *>(block.get_data()), patterns);
+    Options opts(pdb_options);
+    opts.set<bool>("shared", true);
+    if (!cache_dir.empty())
+        opts.set<string>("cache_dir", cache_dir);
+    opts.set<vector<vector<int> > >("patterns", patterns);
+    current_heuristic = new CanonicalPDBsHeuristic(opts);
+}
+
 void PatternGenerationHaslum::initialize() {
     // calculate average operator costs
     double average_operator_cost = 0;
@@ -317,8 +454,7 @@ void PatternGenerationHaslum::initialize() {
     for (size_t i = 0; i < g_goal.size(); ++i) {
         initial_pattern_collection.push_back(vector<int>(1, g_goal[i].first));
     }
-    Options opts;
-    opts.set<int>("cost_type", cost_type);
+    Options opts(pdb_options);
     opts.set<vector<vector<int> > >("patterns", initial_pattern_collection);
     current_heuristic = new CanonicalPDBsHeuristic(opts);
     current_heuristic->evaluate(g_initial_state());
@@ -409,7 +545,8 @@ static Heuristic *_parse(OptionParser &parser) {
         "the original implementation as described in the paper.", true);
 
     parser.add_option<int>("pdb_max_size",
-                           "maximal number of states per pattern database ",
+                           "maximal number of states per pattern database "
+                           "(before min_compression)",
                            "2000000");
     parser.add_option<int>("collection_max_size",
                            "maximal number of states in the pattern collection",
@@ -421,11 +558,14 @@ static Heuristic *_parse(OptionParser &parser) {
                            "minimum number of samples on which a candidate pattern collection must improve on the "
                            "current one to be considered as the next pattern collection ", "10");
 
+    add_storage_options_to_parser(parser);
+
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.help_mode())
         return 0;
 
+    check_storage_options(parser, opts);
     if (opts.get<int>("pdb_max_size") < 1)
         parser.error("size per pdb must be at least 1");
     if (opts.get<int>("collection_max_size") < 1)
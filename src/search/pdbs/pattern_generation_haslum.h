@@ -2,13 +2,14 @@
 #define PDBS_PATTERN_GENERATION_HASLUM_H
 
 #include "../operator_cost.h"
+#include "../option_parser.h"
 #include "../state_registry.h"
 
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
-class Options;
 class CanonicalPDBsHeuristic;
 class PDBHeuristic;
 class State;
@@ -19,6 +20,7 @@ class PatternGenerationHaslum {
     const int num_samples;
     const int min_improvement; // minimal improvement required for hill climbing to continue search
     const OperatorCost cost_type;
+    Options pdb_options; // cost type and compression options of all PDBs
     CanonicalPDBsHeuristic *current_heuristic;
 
     int num_rejected; // for stats only
@@ -51,11 +53,14 @@ class PatternGenerationHaslum {
     std::pair<int, int> find_best_improving_pdb(std::vector<State> &samples,
                                                 std::vector<PDBHeuristic *> &candidate_pdbs);
 
-    /* Returns true iff the h-value of the new pattern (from pdb_heuristic) plus the h-value of all
+    /* Returns true iff the h-value of the new pattern (h_pattern) plus the h-value of all
        maximal additive subsets from the current pattern collection heuristic if the new pattern was
-       added to it is greater than the the h-value of the current pattern collection. */
-    bool is_heuristic_improved(PDBHeuristic *pdb_heuristic, const State &sample,
-                               const std::vector<std::vector<PDBHeuristic *> > &max_additive_subsets);
+       added to it is greater than the the h-value of the current pattern collection (h_collection).
+       pdb_values holds the h-values of the PDBs of the current collection for all samples, and the
+       subsets are given as indices into it. Only reads its arguments, so threads may call it. */
+    static bool is_heuristic_improved(int h_pattern, int sample, int h_collection,
+                                      const std::vector<std::vector<int> > &pdb_values,
+                                      const std::vector<std::vector<int> > &max_additive_subsets);
 
     /* This is the core algorithm of this class. As soon as after an iteration, the improvement (according
        to the "counting approximation") is smaller than the minimal required improvement, the search is
@@ -72,6 +77,23 @@ class PatternGenerationHaslum {
        (consisting of exactly one PDB for each goal variable) may break the maximum collection size limit,
        if the latter is set too small or if there are many goal variables with a large domain. */
     void initialize();
+
+    /* The pattern collection of current_heuristic as a flat list of integers: the number of
+       patterns followed by the size and the variables of each pattern. This is what is
+       sent to the other MPI ranks of the node and stored in the heuristic cache. */
+    void encode_pattern_collection(std::vector<int> &collection) const;
+    static void decode_pattern_collection(const int *data,
+                                          std::vector<std::vector<int> > &patterns);
+
+    /* The options that the hill climbing depends on, and the state of the random number
+       generator used for sampling. */
+    std::string get_cache_key() const;
+
+    /* Collective over the MPI ranks. Sends the pattern collection found by the node leader
+       to the other ranks of the node, and replaces current_heuristic on all of them by a
+       heuristic for the collection with PDBs shared by the node (and cached in cache_dir
+       unless it is empty). */
+    void share_pattern_collection(const std::string &cache_dir);
 public:
     PatternGenerationHaslum(const Options &opts);
     virtual ~PatternGenerationHaslum();
@@ -4,6 +4,8 @@
 #include "util.h"
 
 #include "../globals.h"
+#include "../heuristic_cache.h"
+#include "../node_shared_memory.h"
 #include "../operator.h"
 #include "../plugin.h"
 #include "../priority_queue.h"
@@ -14,7 +16,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -60,7 +64,7 @@ void AbstractOperator::dump(const vector<int> &pattern) const {
 PDBHeuristic::PDBHeuristic(
     const Options &opts, bool dump,
     const vector<int> &op_costs)
-    : Heuristic(opts) {
+    : Heuristic(opts), distance_table(0), packed_table(0), shared_block(0), cache(0) {
     verify_no_axioms_no_cond_effects();
 
     if (op_costs.empty()) { // if no operator costs are specified, use default operator costs
@@ -73,13 +77,69 @@ PDBHeuristic::PDBHeuristic(
     }
     relevant_operators.resize(g_operators.size(), false);
 
+    bool shared = opts.contains("shared") && opts.get<bool>("shared");
+    if (shared && !is_node_leader()) {
+        pattern = opts.get_list<int>("pattern");
+        share_table();
+        return;
+    }
+
+    string cache_dir = HeuristicCache::get_directory(opts);
+    if (!cache_dir.empty()) {
+        cache = new HeuristicCache(cache_dir, get_cache_key(opts));
+        if (cache->load()) {
+            pattern = opts.get_list<int>("pattern");
+            read_table_block(cache->get_data());
+            if (dump)
+                cout << "PDB loaded from " << cache->get_filename() << endl;
+            if (shared)
+                share_table();
+            return;
+        }
+    }
+
     Timer timer;
+    entry_bits = 32;
     set_pattern(opts.get_list<int>("pattern"));
     if (dump)
         cout << "PDB construction time: " << timer << endl;
+
+    int min_compression = 1;
+    if (opts.contains("min_compression"))
+        min_compression = opts.get<int>("min_compression");
+    int bits = 32;
+    if (opts.contains("entry_bits"))
+        bits = opts.get<int>("entry_bits");
+    uncompressed_mean_finite_h = compute_mean_finite_h();
+    if (min_compression > 1 || bits != 32) {
+        size_t original_size = num_states;
+        if (min_compression > 1)
+            min_compress(min_compression);
+        int num_saturated = 0;
+        if (bits != 32) {
+            entry_bits = bits;
+            num_saturated = pack_distances();
+        }
+        if (dump) {
+            cout << "PDB compression: " << original_size << " -> "
+                 << num_states << " entries of " << entry_bits
+                 << " bits, mean finite h " << uncompressed_mean_finite_h << " -> "
+                 << compute_mean_finite_h() << ", " << num_saturated
+                 << " saturated entries" << endl;
+        }
+    }
+    if (cache) {
+        vector<char> block(get_table_block_size());
+        write_table_block(&block[0]);
+        cache->save(&block[0], block.size());
+    }
+    if (shared)
+        share_table();
 }
 
 PDBHeuristic::~PDBHeuristic() {
+    delete shared_block;
+    delete cache;
 }
 
 void PDBHeuristic::verify_no_axioms_no_cond_effects() const {
@@ -194,18 +254,34 @@ void PDBHeuristic::create_pdb() {
     }
 
     distances.reserve(num_states);
-    AdaptiveQueue<size_t> pq; // (first implicit entry: priority,) second entry: index for an abstract state
-
-    // initialize queue
+    vector<size_t> goal_states;
     for (size_t state_index = 0; state_index < num_states; ++state_index) {
         if (is_goal_state(state_index, abstract_goal)) {
-            pq.push(0, state_index);
+            goal_states.push_back(state_index);
             distances.push_back(0);
         } else {
             distances.push_back(numeric_limits<int>::max());
         }
     }
 
+    bool unit_cost = true;
+    for (size_t i = 0; i < operators.size(); ++i) {
+        if (operators[i].get_cost() != 1)
+            unit_cost = false;
+    }
+    if (unit_cost)
+        compute_distances_unit_cost(match_tree, goal_states);
+    else
+        compute_distances(match_tree, goal_states);
+    set_table_pointers();
+}
+
+void PDBHeuristic::compute_distances(const MatchTree &match_tree,
+                                     const vector<size_t> &goal_states) {
+    AdaptiveQueue<size_t> pq; // (first implicit entry: priority,) second entry: index for an abstract state
+    for (size_t i = 0; i < goal_states.size(); ++i)
+        pq.push(0, goal_states[i]);
+
     // Dijkstra loop
     while (!pq.empty()) {
         pair<int, size_t> node = pq.pop();
@@ -229,6 +305,42 @@ void PDBHeuristic::create_pdb() {
     }
 }
 
+void PDBHeuristic::compute_distances_unit_cost(const MatchTree &match_tree,
+                                               vector<size_t> &layer) {
+    /*
+      The states of a layer are regressed in parallel. A predecessor is
+      claimed by the thread that sets its distance first, so every state
+      enters exactly one layer. The distances do not depend on the number
+      of threads or on the order of the states within a layer.
+    */
+    const int unreached = numeric_limits<int>::max();
+    int *distance_of = &distances[0];
+    for (int distance = 1; !layer.empty(); ++distance) {
+        vector<size_t> next_layer;
+        long layer_size = layer.size();
+#pragma omp parallel if (layer_size >= MIN_PARALLEL_LAYER_SIZE)
+        {
+            vector<const AbstractOperator *> applicable_operators;
+            vector<size_t> reached;
+#pragma omp for schedule(dynamic, 1024) nowait
+            for (long i = 0; i < layer_size; ++i) {
+                applicable_operators.clear();
+                match_tree.get_applicable_operators(layer[i], applicable_operators);
+                for (size_t j = 0; j < applicable_operators.size(); ++j) {
+                    size_t predecessor = layer[i] + applicable_operators[j]->get_hash_effect();
+                    int *entry = distance_of + predecessor;
+                    if (__atomic_load_n(entry, __ATOMIC_RELAXED) == unreached &&
+                        __sync_bool_compare_and_swap(entry, unreached, distance))
+                        reached.push_back(predecessor);
+                }
+            }
+#pragma omp critical
+            next_layer.insert(next_layer.end(), reached.begin(), reached.end());
+        }
+        layer.swap(next_layer);
+    }
+}
+
 void PDBHeuristic::set_pattern(const vector<int> &pat) {
     assert_sorted_unique(pat);
     pattern = pat;
@@ -263,25 +375,225 @@ size_t PDBHeuristic::hash_index(const State &state) const {
     return index;
 }
 
+void PDBHeuristic::project_away(int pos, vector<int> &table) const {
+    size_t multiplier = hash_multipliers[pos];
+    size_t domain_size = g_variable_domain[pattern[pos]];
+    table.assign(num_states / domain_size, numeric_limits<int>::max());
+    for (size_t index = 0; index < num_states; ++index) {
+        size_t low = index % multiplier;
+        size_t high = index / (multiplier * domain_size);
+        size_t new_index = low + high * multiplier;
+        table[new_index] = min(table[new_index], distances[index]);
+    }
+}
+
+static double mean_finite_value(const vector<int> &table) {
+    double sum = 0;
+    int num_finite = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        if (table[i] != numeric_limits<int>::max()) {
+            sum += table[i];
+            ++num_finite;
+        }
+    }
+    return num_finite ? sum / num_finite : 0;
+}
+
+void PDBHeuristic::min_compress(int factor) {
+    assert(entry_bits == 32);
+    size_t target_size = max(num_states / factor, size_t(1));
+    vector<int> table, best_table;
+    while (num_states > target_size) {
+        int best_pos = -1;
+        double best_mean = 0;
+        int num_remaining = 0;
+        for (size_t pos = 0; pos < pattern.size(); ++pos) {
+            if (hash_multipliers[pos] != 0 && g_variable_domain[pattern[pos]] > 1)
+                ++num_remaining;
+        }
+        if (num_remaining <= 1)
+            break;
+        for (size_t pos = 0; pos < pattern.size(); ++pos) {
+            if (hash_multipliers[pos] == 0 || g_variable_domain[pattern[pos]] == 1)
+                continue;
+            project_away(pos, table);
+            double mean = mean_finite_value(table);
+            if (best_pos == -1 || mean > best_mean) {
+                best_pos = pos;
+                best_mean = mean;
+                best_table.swap(table);
+            }
+        }
+        assert(best_pos != -1);
+        size_t multiplier = hash_multipliers[best_pos];
+        size_t domain_size = g_variable_domain[pattern[best_pos]];
+        for (size_t pos = 0; pos < pattern.size(); ++pos) {
+            if (hash_multipliers[pos] > multiplier)
+                hash_multipliers[pos] /= domain_size;
+        }
+        hash_multipliers[best_pos] = 0;
+        num_states /= domain_size;
+        distances.swap(best_table);
+    }
+    set_table_pointers();
+}
+
+int PDBHeuristic::pack_distances() {
+    assert(entry_bits == 8 || entry_bits == 4);
+    int num_saturated = 0;
+    packed_distances.assign((num_states * entry_bits + 7) / 8, 0);
+    for (size_t index = 0; index < num_states; ++index) {
+        int entry;
+        if (distances[index] == numeric_limits<int>::max()) {
+            entry = max_entry() + 1;
+        } else if (distances[index] > max_entry()) {
+            entry = max_entry();
+            ++num_saturated;
+        } else {
+            entry = distances[index];
+        }
+        if (entry_bits == 8)
+            packed_distances[index] = entry;
+        else
+            packed_distances[index / 2] |= entry << (4 * (index % 2));
+    }
+    vector<int>().swap(distances);
+    set_table_pointers();
+    return num_saturated;
+}
+
+void PDBHeuristic::set_table_pointers() {
+    distance_table = distances.empty() ? 0 : &distances[0];
+    packed_table = packed_distances.empty() ? 0 : &packed_distances[0];
+}
+
+struct TableBlockHeader {
+    size_t num_states;
+    size_t table_bytes; // padded to a multiple of 8
+    double uncompressed_mean_finite_h;
+    int entry_bits;
+};
+
+size_t PDBHeuristic::get_table_bytes() const {
+    size_t table_bytes = (num_states * entry_bits + 7) / 8;
+    return (table_bytes + 7) / 8 * 8;
+}
+
+size_t PDBHeuristic::get_table_block_size() const {
+    // Layout: header, hash multipliers, table, relevant operators.
+    return sizeof(TableBlockHeader) + pattern.size() * sizeof(size_t) +
+           get_table_bytes() + g_operators.size();
+}
+
+void PDBHeuristic::write_table_block(char *block) const {
+    TableBlockHeader *header = reinterpret_cast<TableBlockHeader *>(block);
+    header->num_states = num_states;
+    header->table_bytes = get_table_bytes();
+    header->uncompressed_mean_finite_h = uncompressed_mean_finite_h;
+    header->entry_bits = entry_bits;
+    char *data = block + sizeof(TableBlockHeader);
+    if (!hash_multipliers.empty())
+        memcpy(data, &hash_multipliers[0], pattern.size() * sizeof(size_t));
+    data += pattern.size() * sizeof(size_t);
+    size_t used_bytes = (num_states * entry_bits + 7) / 8;
+    if (has_packed_distances())
+        memcpy(data, packed_table, used_bytes);
+    else
+        memcpy(data, distance_table, used_bytes);
+    memset(data + used_bytes, 0, header->table_bytes - used_bytes);
+    data += header->table_bytes;
+    for (size_t op_no = 0; op_no < relevant_operators.size(); ++op_no)
+        data[op_no] = relevant_operators[op_no];
+}
+
+void PDBHeuristic::read_table_block(const char *block) {
+    const TableBlockHeader *header =
+        reinterpret_cast<const TableBlockHeader *>(block);
+    num_states = header->num_states;
+    uncompressed_mean_finite_h = header->uncompressed_mean_finite_h;
+    entry_bits = header->entry_bits;
+    const char *data = block + sizeof(TableBlockHeader);
+    const size_t *multipliers = reinterpret_cast<const size_t *>(data);
+    hash_multipliers.assign(multipliers, multipliers + pattern.size());
+    data += pattern.size() * sizeof(size_t);
+    distance_table = reinterpret_cast<const int *>(data);
+    packed_table = reinterpret_cast<const unsigned char *>(data);
+    data += header->table_bytes;
+    for (size_t op_no = 0; op_no < relevant_operators.size(); ++op_no)
+        relevant_operators[op_no] = data[op_no];
+    vector<int>().swap(distances);
+    vector<unsigned char>().swap(packed_distances);
+}
+
+void PDBHeuristic::share_table() {
+    size_t size = 0;
+    bool leader = is_node_leader();
+    if (leader)
+        size = get_table_block_size();
+    shared_block = new NodeSharedBlock(size);
+    if (leader)
+        write_table_block(shared_block->get_writable_data());
+    shared_block->publish();
+    read_table_block(shared_block->get_data());
+    // The table of the leader may have come from the cache.
+    delete cache;
+    cache = 0;
+}
+
+string PDBHeuristic::get_cache_key(const Options &opts) const {
+    ostringstream key;
+    key << "pdb" << endl << "pattern:";
+    const vector<int> pdb_pattern = opts.get_list<int>("pattern");
+    for (size_t i = 0; i < pdb_pattern.size(); ++i)
+        key << " " << pdb_pattern[i];
+    key << endl << "operator costs:";
+    for (size_t i = 0; i < operator_costs.size(); ++i)
+        key << " " << operator_costs[i];
+    key << endl;
+    if (opts.contains("min_compression"))
+        key << "min_compression: " << opts.get<int>("min_compression") << endl;
+    if (opts.contains("entry_bits"))
+        key << "entry_bits: " << opts.get<int>("entry_bits") << endl;
+    return key.str();
+}
+
 void PDBHeuristic::initialize() {
 }
 
 int PDBHeuristic::compute_heuristic(const State &state) {
-    int h = distances[hash_index(state)];
+    int h = get_distance(hash_index(state));
     if (h == numeric_limits<int>::max())
         return DEAD_END;
     return h;
 }
 
+void PDBHeuristic::compute_heuristic_batch(const State *states, int n,
+                                           int *out) {
+    // Compute the hash indices one pattern variable at a time. They fit
+    // into an int because num_states does.
+    fill(out, out + n, 0);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        int var = pattern[i];
+        int multiplier = hash_multipliers[i];
+        for (int j = 0; j < n; ++j)
+            out[j] += multiplier * states[j][var];
+    }
+    for (int j = 0; j < n; ++j) {
+        int h = get_distance(out[j]);
+        out[j] = (h == numeric_limits<int>::max()) ? DEAD_END : h;
+    }
+}
+
 double PDBHeuristic::compute_mean_finite_h() const {
     double sum = 0;
     int size = num_states;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] == numeric_limits<int>::max()) {
+    for (size_t i = 0; i < num_states; ++i) {
+        int h = get_distance(i);
+        if (h == numeric_limits<int>::max()) {
             --size;
             continue;
         }
-        sum += distances[i];
+        sum += h;
     }
     if (size == 0) { // empty pattern or all states are dead-end
         return numeric_limits<double>::infinity();
@@ -3,6 +3,8 @@
 
 #include "../heuristic.h"
 
+#include <limits>
+#include <string>
 #include <vector>
 
 class AbstractOperator {
@@ -40,6 +42,9 @@ public:
 };
 
 // Implements a single PDB
+class HeuristicCache;
+class MatchTree;
+class NodeSharedBlock;
 class Operator;
 class State;
 class PDBHeuristic : public Heuristic {
@@ -57,7 +62,26 @@ class PDBHeuristic : public Heuristic {
     // final h-values for abstract-states. dead-ends are represented by numeric_limits<int>::max()
     std::vector<int> distances;
 
-    std::vector<size_t> hash_multipliers; // multipliers for each variable for perfect hash function
+    /* With entry_bits = 8 or 4, the h-values are stored in packed_distances
+       instead of distances, two entries per byte for 4 bits. Values above
+       max_entry() are saturated to it, and the highest entry marks
+       dead ends. */
+    int entry_bits;
+    std::vector<unsigned char> packed_distances;
+    double uncompressed_mean_finite_h;
+
+    /* The table that get_distance reads: distances or packed_distances, or
+       with the option shared, a block of memory shared by the MPI ranks of
+       the node, where only the node leader builds the PDB, or with the
+       option cache_dir, a cache file from an earlier run. */
+    const int *distance_table;
+    const unsigned char *packed_table;
+    NodeSharedBlock *shared_block;
+    HeuristicCache *cache;
+
+    /* Multipliers for each variable for perfect hash function. Variables that
+       have been removed by min-compression have multiplier 0. */
+    std::vector<size_t> hash_multipliers;
     void verify_no_axioms_no_cond_effects() const; // we support SAS+ tasks only
 
     /* Recursive method; called by build_abstract_operators.
@@ -74,10 +98,18 @@ class PDBHeuristic : public Heuristic {
        datastructures for initial call to recursive method multiyply_out. */
     void build_abstract_operators(int op_no, std::vector<AbstractOperator> &operators);
 
-    /* Computes all abstract operators, builds the match tree (successor generator) and then does a Dijkstra regression
+    /* Computes all abstract operators, builds the match tree (successor generator) and then does a regression
        search to compute all final h-values (stored in distances). */
     void create_pdb();
 
+    // Dijkstra regression search from the goal states.
+    void compute_distances(const MatchTree &match_tree, const std::vector<size_t> &goal_states);
+
+    /* Breadth-first regression search from the goal states (given as first layer) if all abstract operators
+       cost 1. Large layers are expanded by several threads. */
+    void compute_distances_unit_cost(const MatchTree &match_tree, std::vector<size_t> &layer);
+    static const long MIN_PARALLEL_LAYER_SIZE = 4096;
+
     // Sets the pattern for the PDB and initializes hash_multipliers and num_states.
     void set_pattern(const std::vector<int> &pattern);
 
@@ -88,9 +120,44 @@ class PDBHeuristic : public Heuristic {
     /* The given concrete state is used to calculate the index of the according abstract state. This is only used
        for table lookup (distances) during search. */
     size_t hash_index(const State &state) const;
+
+    /* Removes pattern variables from the table until it has shrunk by at least the given factor, but keeps at
+       least one variable. The entry for the remaining variables is the minimum over all values of the removed
+       ones, so the heuristic stays admissible and consistent. Greedily removes the variable that keeps the
+       highest mean finite h-value. */
+    void min_compress(int factor);
+
+    // Computes the table without the variable at the given position in pattern.
+    void project_away(int pos, std::vector<int> &table) const;
+
+    // Moves the h-values from distances to packed_distances with entry_bits bits each.
+    int pack_distances();
+
+    // Points distance_table and packed_table to the table in distances or packed_distances.
+    void set_table_pointers();
+
+    /* The table block holds everything that is needed after construction: a header, the
+       hash multipliers, the table (padded to 8 bytes) and the relevant operators. It is
+       what the PDB places in shared_block and in the cache. read_table_block points the
+       table into the given block, which must outlive the PDB. */
+    size_t get_table_bytes() const;
+    size_t get_table_block_size() const;
+    void write_table_block(char *block) const;
+    void read_table_block(const char *block);
+
+    /* Collective over the MPI ranks (see node_shared_memory.h). The node leader moves the
+       table block into shared_block, the other ranks of the node take it from there. */
+    void share_table();
+
+    // Everything except the task that the table depends on.
+    std::string get_cache_key(const Options &opts) const;
+
+    int max_entry() const {return (1 << entry_bits) - 2; }
 protected:
     virtual void initialize();
     virtual int compute_heuristic(const State &state);
+    virtual void compute_heuristic_batch(const State *states, int n,
+                                         int *out);
 public:
     /* Important: It is assumed that the pattern (passed via Options) is small enough so that the number of
                   abstract states is below numeric_limits<int>::max()
@@ -115,8 +182,38 @@ public:
        Note: This is only calculated when called; avoid repeated calls to this method! */
     double compute_mean_finite_h() const;
 
+    // Returns the value of compute_mean_finite_h before the PDB was compressed
+    double get_uncompressed_mean_finite_h() const {return uncompressed_mean_finite_h; }
+
     // Returns all operators affecting this PDB
     const std::vector<bool> &get_relevant_operators() const {return relevant_operators; }
+
+    // Returns the multipliers of the perfect hash function, one per pattern variable
+    const std::vector<size_t> &get_hash_multipliers() const {return hash_multipliers; }
+
+    // Returns true iff the h-values are stored in fewer than 32 bits (see get_distance)
+    bool has_packed_distances() const {return entry_bits != 32; }
+
+    // Returns the h-values of all abstract states (numeric_limits<int>::max() for dead ends).
+    // Only available without packed distances.
+    const int *get_distances() const {return distance_table; }
+
+    // Returns the h-value of the abstract state with the given index (numeric_limits<int>::max() for dead ends)
+    int get_distance(size_t index) const {
+        if (entry_bits == 32)
+            return distance_table[index];
+        int entry;
+        if (entry_bits == 8)
+            entry = packed_table[index];
+        else
+            entry = (packed_table[index / 2] >> (4 * (index % 2))) & 15;
+        if (entry > max_entry())
+            return std::numeric_limits<int>::max();
+        return entry;
+    }
+
+    // Returns the h-value of the given state without changing the heuristic, so several threads may call it
+    int get_distance(const State &state) const {return get_distance(hash_index(state)); }
 };
 
 #endif
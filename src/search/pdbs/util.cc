@@ -1,10 +1,12 @@
 #include "util.h"
 
 #include "../globals.h"
+#include "../heuristic_cache.h"
 #include "../option_parser.h"
 #include "../utilities.h"
 
 #include "../merge_and_shrink/variable_order_finder.h"
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -106,6 +108,46 @@ static void build_singleton_patterns(
         pattern_collection.push_back(vector<int>(1, g_goal[i].first));
 }
 
+void add_storage_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "entry_bits",
+        "number of bits per PDB entry (32, 8 or 4). With 8 or 4 bits, "
+        "h-values that do not fit are reduced to the largest one that does.",
+        "32");
+    parser.add_option<int>(
+        "min_compression",
+        "shrink each PDB by at least this factor by removing pattern variables "
+        "from its table and keeping the minimum h-value over their values. "
+        "At least one variable is kept.",
+        "1");
+    parser.add_option<bool>(
+        "shared",
+        "build each PDB only on one MPI rank per node and share its table "
+        "with the other ranks of the node. All ranks must then be given "
+        "the same heuristics.",
+        "false");
+    HeuristicCache::add_option_to_parser(parser);
+}
+
+void check_storage_options(OptionParser &parser, const Options &opts) {
+    int entry_bits = opts.get<int>("entry_bits");
+    if (entry_bits != 32 && entry_bits != 8 && entry_bits != 4)
+        parser.error("entry_bits must be 32, 8 or 4");
+    if (opts.get<int>("min_compression") < 1)
+        parser.error("min_compression must be at least 1");
+}
+
+void copy_storage_options(const Options &from, Options &to) {
+    if (from.contains("entry_bits"))
+        to.set<int>("entry_bits", from.get<int>("entry_bits"));
+    if (from.contains("min_compression"))
+        to.set<int>("min_compression", from.get<int>("min_compression"));
+    if (from.contains("shared"))
+        to.set<bool>("shared", from.get<bool>("shared"));
+    if (from.contains("cache_dir"))
+        to.set<string>("cache_dir", from.get<string>("cache_dir"));
+}
+
 void parse_pattern(OptionParser &parser, Options &opts) {
     parser.add_option<int>("max_states",
         "maximal number of abstract states in the pattern database",
@@ -115,10 +157,12 @@ void parse_pattern(OptionParser &parser, Options &opts) {
         "Default: the variables are selected automatically based on a simple greedy strategy.",
         "",
         OptionFlags(false));
+    add_storage_options_to_parser(parser);
 
     opts = parser.parse();
     if (parser.help_mode())
         return;
+    check_storage_options(parser, opts);
 
     vector<int> pattern;
     if (opts.contains("pattern")) {
@@ -145,10 +189,12 @@ void parse_patterns(OptionParser &parser, Options &opts) {
         "combo", "use the combo strategy", "false");
     parser.add_option<int>(
         "max_states", "maximum abstraction size for combo strategy", "1000000");
+    add_storage_options_to_parser(parser);
 
     opts = parser.parse();
     if (parser.help_mode())
         return;
+    check_storage_options(parser, opts);
 
     vector<vector<int> > pattern_collection;
     if (opts.contains("patterns")) {
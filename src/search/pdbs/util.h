@@ -7,4 +7,14 @@ class Options;
 extern void parse_pattern(OptionParser &parser, Options &opts);
 extern void parse_patterns(OptionParser &parser, Options &opts);
 
+/* The options entry_bits and min_compression control the compression of
+   PDBHeuristic tables, shared places them in memory shared by the MPI
+   ranks of a node and cache_dir stores them in a heuristic cache (see
+   heuristic_cache.h). parse_pattern and parse_patterns add and check them
+   themselves. */
+extern void add_storage_options_to_parser(OptionParser &parser);
+extern void check_storage_options(OptionParser &parser, const Options &opts);
+// Copies the storage options to the options of a PDB built internally.
+extern void copy_storage_options(const Options &from, Options &to);
+
 #endif
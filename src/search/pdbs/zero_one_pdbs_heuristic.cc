@@ -30,12 +30,14 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
     const vector<vector<int> > &pattern_collection(opts.get_list<vector<int> >("patterns"));
     //Timer timer;
     approx_mean_finite_h = 0;
+    double uncompressed_mean_finite_h = 0;
     pattern_databases.reserve(pattern_collection.size());
     for (size_t i = 0; i < pattern_collection.size(); ++i) {
-        Options opts;
-        opts.set<int>("cost_type", cost_type);
-        opts.set<vector<int> >("pattern", pattern_collection[i]);
-        PDBHeuristic *pdb_heuristic = new PDBHeuristic(opts, false, operator_costs);
+        Options pdb_opts;
+        pdb_opts.set<int>("cost_type", cost_type);
+        pdb_opts.set<vector<int> >("pattern", pattern_collection[i]);
+        copy_storage_options(opts, pdb_opts);
+        PDBHeuristic *pdb_heuristic = new PDBHeuristic(pdb_opts, false, operator_costs);
         pattern_databases.push_back(pdb_heuristic);
 
         // get used operators and set their cost for further iterations to 0 (action cost partitioning)
@@ -47,7 +49,11 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
         }
 
         approx_mean_finite_h += pdb_heuristic->compute_mean_finite_h();
+        uncompressed_mean_finite_h += pdb_heuristic->get_uncompressed_mean_finite_h();
     }
+    if (uncompressed_mean_finite_h != approx_mean_finite_h)
+        cout << "PDB compression: summed mean finite h of the PDBs "
+             << uncompressed_mean_finite_h << " -> " << approx_mean_finite_h << endl;
     //cout << "All or nothing PDB collection construction time: " <<
     //timer << endl;
 }
@@ -16,6 +16,8 @@
 class PerStateInformationBase {
     friend class StateRegistry;
     virtual void remove_state_registry(StateRegistry *registry) = 0;
+    // Bytes used for storing information about states of the given registry.
+    virtual size_t get_memory_usage(const StateRegistry *registry) const = 0;
 public:
     PerStateInformationBase() {
     }
@@ -153,6 +155,10 @@ public:
     const_iterator begin(const StateRegistry *registry) const {
         return const_iterator(*this, registry, 0);
     }
+    // Iterates over the states registered after the first "start" states.
+    const_iterator begin(const StateRegistry *registry, size_t start) const {
+        return const_iterator(*this, registry, start);
+    }
     const_iterator end(const StateRegistry *registry) const {
         return const_iterator(*this, registry, registry->size());
     }
@@ -203,6 +209,11 @@ public:
         return (*entries)[state_id];
     }
 
+    size_t get_memory_usage(const StateRegistry *registry) const {
+        const SegmentedVector<Entry> *entries = get_entries(registry);
+        return entries ? entries->get_memory_usage() : 0;
+    }
+
     void remove_state_registry(StateRegistry *registry) {
         delete entries_by_registry[registry];
         entries_by_registry.erase(registry);
@@ -5,6 +5,7 @@
 #include "timer.h"
 #include "utilities.h"
 #include "search_engine.h"
+#include "task_loading.h"
 #include "wtimer.h"
 
 
@@ -24,13 +25,7 @@ int main(int argc, const char **argv) {
 //    if (string(argv[1]).compare("--help") != 0)
 //        read_everything(cin);
 
-    std::ifstream is(argv[1], std::ifstream::in);
-    if (is) {
-    	read_everything(is);
-    } else {
-    	cout << "output file not in place" << endl;
-    	exit_with(EXIT_INPUT_ERROR);
-    }
+    load_task(argv[1], parse_task_loading(argc, argv));
 
     argc--;
     argv++;
@@ -222,43 +222,66 @@ public:
 
 template<typename Value>
 class AdaptiveQueue {
-    AbstractQueue<Value> *wrapped_queue;
+    /* Until it is converted, the bucket-based queue is used directly, so
+       that its methods are called without virtual dispatch and can be
+       inlined. After conversion, converted_queue replaces it. */
+    BucketQueue<Value> bucket_queue;
+    AbstractQueue<Value> *converted_queue;
     // Forbid assigning or copying -- would need to implement them properly.
     AdaptiveQueue &operator=(const AdaptiveQueue<Value> &);
     AdaptiveQueue(const AdaptiveQueue<Value> &);
 public:
     typedef std::pair<int, Value> Entry;
 
-    AdaptiveQueue() : wrapped_queue(new BucketQueue<Value>) {
+    AdaptiveQueue() : converted_queue(0) {
     }
 
     ~AdaptiveQueue() {
-        delete wrapped_queue;
+        delete converted_queue;
     }
 
     void push(int key, const Value &value) {
-        AbstractQueue<Value> *q = wrapped_queue->convert_if_necessary(key);
-        if (q != wrapped_queue) {
-            delete wrapped_queue;
-            wrapped_queue = q;
+        if (!converted_queue) {
+            AbstractQueue<Value> *q = bucket_queue.convert_if_necessary(key);
+            if (q == &bucket_queue) {
+                bucket_queue.push(key, value);
+                return;
+            }
+            converted_queue = q;
+        } else {
+            AbstractQueue<Value> *q = converted_queue->convert_if_necessary(key);
+            if (q != converted_queue) {
+                delete converted_queue;
+                converted_queue = q;
+            }
         }
-        wrapped_queue->push(key, value);
+        converted_queue->push(key, value);
     }
 
     Entry pop() {
-        return wrapped_queue->pop();
+        if (!converted_queue)
+            return bucket_queue.pop();
+        return converted_queue->pop();
     }
 
     bool empty() const {
-        return wrapped_queue->empty();
+        if (!converted_queue)
+            return bucket_queue.empty();
+        return converted_queue->empty();
     }
 
     void clear() {
-        wrapped_queue->clear();
+        if (!converted_queue)
+            bucket_queue.clear();
+        else
+            converted_queue->clear();
     }
 
     void add_virtual_pushes(int num_extra_pushes) {
-        wrapped_queue->add_virtual_pushes(num_extra_pushes);
+        if (!converted_queue)
+            bucket_queue.add_virtual_pushes(num_extra_pushes);
+        else
+            converted_queue->add_virtual_pushes(num_extra_pushes);
     }
 };
 
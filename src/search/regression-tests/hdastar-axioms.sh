@@ -0,0 +1,37 @@
+#! /bin/bash
+# usage: hdastar-axioms.sh (see README)
+# MPIRUN and PYTHON select the MPI launcher and the Python 2 interpreter.
+
+set -e
+
+BASEDIR="$(cd "$(dirname "$0")/../.." && pwd)"
+MPIRUN=${MPIRUN:-mpirun}
+PYTHON=${PYTHON:-python2}
+TESTS="$BASEDIR/dist/data/tests"
+
+WORKDIR="$(mktemp -d)"
+trap 'rm -rf "$WORKDIR"' EXIT
+cd "$WORKDIR"
+
+"$PYTHON" "$BASEDIR/translate/translate.py" \
+    "$TESTS/test2-domain.pddl" "$TESTS/test2-problem.pddl" > translate.log
+"$BASEDIR/preprocess/preprocess" < output.sas > preprocess.log
+
+STATUS=0
+for NP in 1 2 3 4; do
+    if ! $MPIRUN -np $NP "$BASEDIR/search/downward-1" output \
+        --search "hdastar(blind(),zobrist)" > search-$NP.log 2>&1; then
+        echo "np=$NP: search failed"
+        STATUS=1
+    elif ! grep -q "found a solution!: g = 6 " search-$NP.log; then
+        echo "np=$NP: no solution of cost 6"
+        STATUS=1
+    # With one process, no plan is reconstructed.
+    elif [[ $NP -gt 1 ]] && ! grep -q "^Plan cost: 6$" search-$NP.log; then
+        echo "np=$NP: no plan of cost 6"
+        STATUS=1
+    else
+        echo "np=$NP: ok"
+    fi
+done
+exit $STATUS
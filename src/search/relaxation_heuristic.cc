@@ -22,18 +22,19 @@ RelaxationHeuristic::~RelaxationHeuristic() {
 // initialization
 void RelaxationHeuristic::initialize() {
     // Build propositions.
-    int prop_id = 0;
-    propositions.resize(g_variable_domain.size());
+    int num_propositions = 0;
+    proposition_offsets.resize(g_variable_domain.size());
     for (int var = 0; var < g_variable_domain.size(); var++) {
-        for (int value = 0; value < g_variable_domain[var]; value++)
-            propositions[var].push_back(Proposition(prop_id++));
+        proposition_offsets[var] = num_propositions;
+        num_propositions += g_variable_domain[var];
     }
+    propositions.resize(num_propositions);
 
     // Build goal propositions.
     for (int i = 0; i < g_goal.size(); i++) {
-        int var = g_goal[i].first, val = g_goal[i].second;
-        propositions[var][val].is_goal = true;
-        goal_propositions.push_back(&propositions[var][val]);
+        int prop_id = get_prop_id(g_goal[i].first, g_goal[i].second);
+        propositions[prop_id].is_goal = true;
+        goal_propositions.push_back(prop_id);
     }
 
     // Build unary operators for operators and axioms.
@@ -47,9 +48,29 @@ void RelaxationHeuristic::initialize() {
 
     // Cross-reference unary operators.
     for (int i = 0; i < unary_operators.size(); i++) {
-        UnaryOperator *op = &unary_operators[i];
-        for (int j = 0; j < op->precondition.size(); j++)
-            op->precondition[j]->precondition_of.push_back(op);
+        const UnaryOperator &op = unary_operators[i];
+        const int *precondition = get_preconditions(op);
+        for (int j = 0; j < op.num_preconditions; j++)
+            propositions[precondition[j]].num_precondition_of++;
+        if (op.num_preconditions == 0)
+            unary_operators_without_preconditions.push_back(i);
+    }
+    int num_precondition_of = 0;
+    for (int prop_id = 0; prop_id < num_propositions; prop_id++) {
+        Proposition &prop = propositions[prop_id];
+        prop.precondition_of_start = num_precondition_of;
+        num_precondition_of += prop.num_precondition_of;
+        prop.num_precondition_of = 0;
+    }
+    precondition_of.resize(num_precondition_of);
+    for (int i = 0; i < unary_operators.size(); i++) {
+        const UnaryOperator &op = unary_operators[i];
+        const int *precondition = get_preconditions(op);
+        for (int j = 0; j < op.num_preconditions; j++) {
+            Proposition &prop = propositions[precondition[j]];
+            precondition_of[prop.precondition_of_start +
+                            prop.num_precondition_of++] = i;
+        }
     }
 }
 
@@ -57,57 +78,51 @@ void RelaxationHeuristic::build_unary_operators(const Operator &op, int op_no) {
     int base_cost = get_adjusted_cost(op);
     const vector<Prevail> &prevail = op.get_prevail();
     const vector<PrePost> &pre_post = op.get_pre_post();
-    vector<Proposition *> precondition;
+    vector<int> precondition;
     for (int i = 0; i < prevail.size(); i++) {
         assert(prevail[i].var >= 0 && prevail[i].var < g_variable_domain.size());
         assert(prevail[i].prev >= 0 && prevail[i].prev < g_variable_domain[prevail[i].var]);
-        precondition.push_back(&propositions[prevail[i].var][prevail[i].prev]);
+        precondition.push_back(get_prop_id(prevail[i].var, prevail[i].prev));
     }
     for (int i = 0; i < pre_post.size(); i++) {
         if (pre_post[i].pre != -1) {
             assert(pre_post[i].var >= 0 && pre_post[i].var < g_variable_domain.size());
             assert(pre_post[i].pre >= 0 && pre_post[i].pre < g_variable_domain[pre_post[i].var]);
-            precondition.push_back(&propositions[pre_post[i].var][pre_post[i].pre]);
+            precondition.push_back(get_prop_id(pre_post[i].var, pre_post[i].pre));
         }
     }
     for (int i = 0; i < pre_post.size(); i++) {
         assert(pre_post[i].var >= 0 && pre_post[i].var < g_variable_domain.size());
         assert(pre_post[i].post >= 0 && pre_post[i].post < g_variable_domain[pre_post[i].var]);
-        Proposition *effect = &propositions[pre_post[i].var][pre_post[i].post];
+        int effect = get_prop_id(pre_post[i].var, pre_post[i].post);
         const vector<Prevail> &eff_cond = pre_post[i].cond;
+        int preconditions_start = preconditions.size();
+        preconditions.insert(preconditions.end(),
+                             precondition.begin(), precondition.end());
         for (int j = 0; j < eff_cond.size(); j++) {
             assert(eff_cond[j].var >= 0 && eff_cond[j].var < g_variable_domain.size());
             assert(eff_cond[j].prev >= 0 && eff_cond[j].prev < g_variable_domain[eff_cond[j].var]);
-            precondition.push_back(&propositions[eff_cond[j].var][eff_cond[j].prev]);
+            preconditions.push_back(get_prop_id(eff_cond[j].var, eff_cond[j].prev));
         }
-        unary_operators.push_back(UnaryOperator(precondition, effect, op_no, base_cost));
-        precondition.erase(precondition.end() - eff_cond.size(), precondition.end());
+        unary_operators.push_back(
+            UnaryOperator(preconditions_start,
+                          preconditions.size() - preconditions_start,
+                          effect, op_no, base_cost));
     }
 }
 
 class hash_unary_operator {
 public:
-    size_t operator()(const pair<vector<Proposition *>, Proposition *> &key) const {
-        // NOTE: We used to hash the Proposition* values directly, but
-        // this had the disadvantage that the results were not
-        // reproducible. This propagates through to the heuristic
-        // computation: runs on different computers could lead to
-        // different initial h values, for example.
-
-        unsigned long hash_value = key.second->id;
-        const vector<Proposition *> &vec = key.first;
+    size_t operator()(const pair<vector<int>, int> &key) const {
+        unsigned long hash_value = key.second;
+        const vector<int> &vec = key.first;
         for (int i = 0; i < vec.size(); i++)
-            hash_value = 17 * hash_value + vec[i]->id;
+            hash_value = 17 * hash_value + vec[i];
         return size_t(hash_value);
     }
 };
 
 
-static bool compare_prop_pointer(const Proposition *p1, const Proposition *p2) {
-    return p1->id < p2->id;
-}
-
-
 void RelaxationHeuristic::simplify() {
     // Remove duplicate or dominated unary operators.
 
@@ -127,15 +142,20 @@ void RelaxationHeuristic::simplify() {
 
     cout << "Simplifying " << unary_operators.size() << " unary operators..." << flush;
 
-    typedef pair<vector<Proposition *>, Proposition *> HashKey;
+    typedef pair<vector<int>, int> HashKey;
     typedef hash_map<HashKey, int, hash_unary_operator> HashMap;
     HashMap unary_operator_index;
     unary_operator_index.resize(unary_operators.size() * 2);
 
     for (int i = 0; i < unary_operators.size(); i++) {
         UnaryOperator &op = unary_operators[i];
-        sort(op.precondition.begin(), op.precondition.end(), compare_prop_pointer);
-        HashKey key(op.precondition, op.effect);
+        vector<int>::iterator precondition_begin =
+            preconditions.begin() + op.preconditions_start;
+        vector<int>::iterator precondition_end =
+            precondition_begin + op.num_preconditions;
+        sort(precondition_begin, precondition_end);
+        HashKey key(vector<int>(precondition_begin, precondition_end),
+                    op.effect);
         pair<HashMap::iterator, bool> inserted = unary_operator_index.insert(
             make_pair(key, i));
         if (!inserted.second) {
@@ -153,6 +173,7 @@ void RelaxationHeuristic::simplify() {
 
     vector<UnaryOperator> old_unary_operators;
     old_unary_operators.swap(unary_operators);
+    preconditions.clear();
 
     for (HashMap::iterator it = unary_operator_index.begin();
          it != unary_operator_index.end(); ++it) {
@@ -162,7 +183,7 @@ void RelaxationHeuristic::simplify() {
         bool match = false;
         if (powerset_size <= 31) { // HACK! Don't spend too much time here...
             for (int mask = 0; mask < powerset_size; mask++) {
-                HashKey dominating_key = make_pair(vector<Proposition *>(), key.second);
+                HashKey dominating_key = make_pair(vector<int>(), key.second);
                 for (int i = 0; i < key.first.size(); i++)
                     if (mask & (1 << i))
                         dominating_key.first.push_back(key.first[i]);
@@ -179,8 +200,13 @@ void RelaxationHeuristic::simplify() {
                 }
             }
         }
-        if (!match)
-            unary_operators.push_back(old_unary_operators[unary_operator_no]);
+        if (!match) {
+            UnaryOperator op = old_unary_operators[unary_operator_no];
+            op.preconditions_start = preconditions.size();
+            preconditions.insert(preconditions.end(),
+                                 key.first.begin(), key.first.end());
+            unary_operators.push_back(op);
+        }
     }
 
     cout << " done! [" << unary_operators.size() << " unary operators]" << endl;
@@ -8,39 +8,44 @@
 class Operator;
 class State;
 
-class Proposition;
-class UnaryOperator;
+/*
+  The relaxed task is stored in flat vectors: propositions and unary
+  operators refer to each other by their index, and the preconditions of
+  all unary operators (and the unary operators triggered by all
+  propositions) are stored one after the other in a single vector. The
+  dynamic attributes are reset in place for each evaluation, so that
+  computing a heuristic value allocates no memory.
+*/
 
 struct UnaryOperator {
     int operator_no; // -1 for axioms; index into g_operators otherwise
-    std::vector<Proposition *> precondition;
-    Proposition *effect;
+    int preconditions_start; // index into RelaxationHeuristic::preconditions
+    int num_preconditions;
+    int effect; // proposition id
     int base_cost;
 
     int unsatisfied_preconditions;
     int cost; // Used for h^max cost or h^add cost;
               // includes operator cost (base_cost)
-    UnaryOperator(const std::vector<Proposition *> &pre, Proposition *eff,
-                  int operator_no_, int base)
-        : operator_no(operator_no_), precondition(pre), effect(eff),
+    UnaryOperator(int preconditions_start_, int num_preconditions_,
+                  int effect_, int operator_no_, int base)
+        : operator_no(operator_no_), preconditions_start(preconditions_start_),
+          num_preconditions(num_preconditions_), effect(effect_),
           base_cost(base) {}
 };
 
 struct Proposition {
     bool is_goal;
-    int id;
-    std::vector<UnaryOperator *> precondition_of;
+    bool marked; // used when computing preferred operators for h^add and h^FF
+    int precondition_of_start; // index into RelaxationHeuristic::precondition_of
+    int num_precondition_of;
 
     int cost; // Used for h^max cost or h^add cost
-    UnaryOperator *reached_by;
-    bool marked; // used when computing preferred operators for h^add and h^FF
+    int reached_by; // unary operator id; -1 if none
 
-    Proposition(int id_) {
-        id = id_;
-        is_goal = false;
-        cost = -1;
-        reached_by = 0;
-        marked = false;
+    Proposition()
+        : is_goal(false), marked(false), precondition_of_start(0),
+          num_precondition_of(0), cost(-1), reached_by(-1) {
     }
 };
 
@@ -49,8 +54,30 @@ class RelaxationHeuristic : public Heuristic {
     void simplify();
 protected:
     std::vector<UnaryOperator> unary_operators;
-    std::vector<std::vector<Proposition> > propositions;
-    std::vector<Proposition *> goal_propositions;
+    std::vector<Proposition> propositions;
+    std::vector<int> goal_propositions;
+    // Unary operators without preconditions, in the order of their ids.
+    std::vector<int> unary_operators_without_preconditions;
+
+    // The preconditions (proposition ids) of all unary operators.
+    std::vector<int> preconditions;
+    // The unary operators (ids) triggered by all propositions.
+    std::vector<int> precondition_of;
+
+    // Id of the first proposition of each variable.
+    std::vector<int> proposition_offsets;
+
+    int get_prop_id(int var, int value) const {
+        return proposition_offsets[var] + value;
+    }
+
+    const int *get_preconditions(const UnaryOperator &op) const {
+        return preconditions.data() + op.preconditions_start;
+    }
+
+    const int *get_precondition_of(const Proposition &prop) const {
+        return precondition_of.data() + prop.precondition_of_start;
+    }
 
     virtual void initialize();
     virtual int compute_heuristic(const State &state) = 0;
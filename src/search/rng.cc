@@ -135,3 +135,10 @@ int RandomNumberGenerator::next(int bound) {
     // Just using modulo doesn't lead to uniform distribution. This does.
     return static_cast<int>(value % bound);
 }
+
+unsigned long long RandomNumberGenerator::get_state_hash() const {
+    unsigned long long hash = mti;
+    for (int i = 0; i < N; ++i)
+        hash = hash * 1099511628211ULL + mt[i];
+    return hash;
+}
@@ -28,6 +28,9 @@ public:
     double operator()() {       // same as next_half_open()
         return next_half_open();
     }
+
+    // Hash of the internal state; equal states produce equal sequences.
+    unsigned long long get_state_hash() const;
 };
 
 /*
@@ -11,6 +11,7 @@ SearchProgress::SearchProgress() {
     evaluations = 0;
     generated_states = 0;
     dead_end_states = 0;
+    stale_entries = 0;
     generated_ops = 0;
     pathmax_corrections = 0;
 
@@ -112,6 +113,7 @@ void SearchProgress::print_statistics() const {
     printf("Evaluations: %d\n", evaluations);
     printf("Generated %d state(s).\n", generated_states);
     printf("Dead ends: %d state(s).\n", dead_end_states);
+    printf("Stale open list entries: %d\n", stale_entries);
 
 //    cout << "Expanded " << expanded_states << " state(s)." << endl;
 //    cout << "Reopened " << reopened_states << " state(s)." << endl;
@@ -1,7 +1,10 @@
 #include "globals.h"
 #include "search_space.h"
 #include "state.h"
+#include "state_registry.h"
 #include "operator.h"
+#include "external_closed_list.h"
+#include "checkpoint.h"
 
 #include <cassert>
 #include "search_node_info.h"
@@ -175,7 +178,8 @@ void SearchNode::dump() const {
 }
 
 SearchSpace::SearchSpace(OperatorCost cost_type_) :
-		cost_type(cost_type_) {
+		cost_type(cost_type_), external_closed_list(0), spilled_parent_ids(
+				-1), id_base(0), first_unchecked_index(0) {
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
@@ -194,11 +198,156 @@ void SearchSpace::trace_path(const State &goal_state,
 			break;
 		}
 		path.push_back(op);
+		if (info.parent_state_id == StateID::no_state) {
+			// The parent has been spilled to disk.
+			trace_spilled_path(spilled_parent_ids[current_state], path);
+			break;
+		}
 		current_state = g_state_registry->lookup_state(info.parent_state_id);
 	}
 	reverse(path.begin(), path.end());
 }
 
+void SearchSpace::trace_spilled_path(int global_id,
+		vector<const Operator *> &path) const {
+	assert(external_closed_list);
+	for (;;) {
+		int parent_process, parent_id;
+		int op_index = get_spilled_parent(global_id, parent_process,
+				parent_id);
+		if (op_index == -1) {
+			break;
+		}
+		path.push_back(&g_operators[op_index]);
+		global_id = parent_id;
+	}
+}
+
+int SearchSpace::get_spilled_parent(int global_id, int &parent_process,
+		int &parent_id) const {
+	assert(is_spilled(global_id));
+	ExternalClosedList::TraceEntry entry =
+			external_closed_list->get_trace_entry(global_id);
+	assert(entry.op_index != ExternalClosedList::NOT_REACHED);
+	parent_process = entry.parent_process;
+	parent_id = entry.parent_id;
+	return entry.op_index;
+}
+
+int SearchSpace::get_global_parent_id(const State &state,
+		const SearchNodeInfo &info) const {
+	if (info.creating_operator == 0) {
+		return -1;
+	} else if (info.parent_state_id == StateID::no_state) {
+		return spilled_parent_ids[state];
+	}
+	return get_global_id(info.parent_state_id);
+}
+
+StateRegistry *SearchSpace::spill_closed_nodes(
+		const vector<StateID> &open_states, vector<StateID> &moved_states,
+		const PerStateInformation<pair<unsigned int, unsigned int> > *process_parents) {
+	assert(external_closed_list);
+	// Open states are moved to the new registry as checked states. Open
+	// nodes that turn out to be duplicates here are moved as closed nodes.
+	if (!external_closed_list->is_empty()) {
+		check_spilled_duplicates();
+	}
+
+	StateRegistry *old_registry = g_state_registry;
+	int num_states = old_registry->size();
+
+	external_closed_list->begin_spill(id_base, num_states);
+	for (PerStateInformation<SearchNodeInfo>::const_iterator it =
+			search_node_infos.begin(old_registry);
+			it != search_node_infos.end(old_registry); ++it) {
+		StateID id = *it;
+		State s = old_registry->lookup_state(id);
+		const SearchNodeInfo &info = search_node_infos[s];
+		if (info.status != SearchNodeInfo::OPEN
+				&& info.status != SearchNodeInfo::CLOSED) {
+			continue;
+		}
+		// Open nodes are moved to the new registry, but their old IDs may
+		// still be referenced by nodes that were reached through them.
+		ExternalClosedList::TraceEntry entry;
+		if (info.creating_operator) {
+			entry.op_index = info.creating_operator - &*g_operators.begin();
+		} else {
+			entry.op_index = -1;
+		}
+		if (process_parents) {
+			const pair<unsigned int, unsigned int> &parent =
+					(*process_parents)[s];
+			entry.parent_process = parent.first;
+			entry.parent_id = parent.second;
+		} else {
+			entry.parent_process = 0;
+			entry.parent_id = get_global_parent_id(s, info);
+		}
+		external_closed_list->add_state(get_global_id(id), s.get_raw_data(),
+				info.g, info.status == SearchNodeInfo::CLOSED, entry);
+	}
+	external_closed_list->end_spill();
+
+	g_state_registry = new StateRegistry;
+	moved_states.clear();
+	for (size_t i = 0; i < open_states.size(); ++i) {
+		State old_state = old_registry->lookup_state(open_states[i]);
+		State new_state = g_state_registry->build_state(
+				old_state.get_raw_data());
+		const SearchNodeInfo &old_info = search_node_infos[old_state];
+		int parent_id = get_global_parent_id(old_state, old_info);
+		SearchNodeInfo &new_info = search_node_infos[new_state];
+		new_info = old_info;
+		new_info.parent_state_id = StateID::no_state;
+		spilled_parent_ids[new_state] = parent_id;
+		moved_states.push_back(new_state.get_id());
+	}
+	id_base += num_states;
+	first_unchecked_index = g_state_registry->size();
+	return old_registry;
+}
+
+bool SearchSpace::is_spilled_duplicate(SearchNode &node) {
+	if (!external_closed_list || external_closed_list->is_empty()
+			|| node.get_state_id().hash() < first_unchecked_index) {
+		return false;
+	}
+	check_spilled_duplicates();
+	return node.is_closed();
+}
+
+void SearchSpace::check_spilled_duplicates() {
+	// Check all states generated since the last check in one batch.
+	vector<StateID> candidates;
+	vector<const state_var_t *> buffers;
+	for (PerStateInformation<SearchNodeInfo>::const_iterator it =
+			search_node_infos.begin(g_state_registry, first_unchecked_index);
+			it != search_node_infos.end(g_state_registry); ++it) {
+		StateID id = *it;
+		State s = g_state_registry->lookup_state(id);
+		if (search_node_infos[s].status == SearchNodeInfo::OPEN) {
+			candidates.push_back(id);
+			buffers.push_back(s.get_raw_data());
+		}
+	}
+	first_unchecked_index = g_state_registry->size();
+
+	vector<int> spilled_g;
+	external_closed_list->lookup(buffers, spilled_g);
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (spilled_g[i] == -1) {
+			continue;
+		}
+		SearchNode candidate = get_node(
+				g_state_registry->lookup_state(candidates[i]));
+		if (spilled_g[i] <= candidate.get_g()) {
+			candidate.close();
+		}
+	}
+}
+
 void SearchSpace::dump() const {
 	for (PerStateInformation<SearchNodeInfo>::const_iterator it =
 			search_node_infos.begin(g_state_registry);
@@ -218,6 +367,69 @@ void SearchSpace::dump() const {
 	}
 }
 
+// Layout of a search node info in checkpoint files.
+struct SearchNodeRecord {
+	int status;
+	int g;
+	int h;
+	int h_is_dirty;
+	int parent_state_id;
+	int creating_operator;
+	int real_g;
+};
+
+void SearchSpace::write_checkpoint(CheckpointFile &file) const {
+	assert(!external_closed_list || external_closed_list->is_empty());
+	for (PerStateInformation<SearchNodeInfo>::const_iterator it =
+			search_node_infos.begin(g_state_registry);
+			it != search_node_infos.end(g_state_registry); ++it) {
+		const SearchNodeInfo &info = search_node_infos[g_state_registry->lookup_state(*it)];
+		SearchNodeRecord record;
+		record.status = info.status;
+		record.g = info.g;
+		record.h = info.h;
+		record.h_is_dirty = info.h_is_dirty;
+		record.parent_state_id = int(info.parent_state_id.hash());
+		record.creating_operator =
+				info.creating_operator ?
+						info.creating_operator - &*g_operators.begin() : -1;
+		record.real_g = info.real_g;
+		file.write(record);
+	}
+}
+
+void SearchSpace::read_checkpoint(CheckpointFile &file) {
+	vector<StateID> ids;
+	for (PerStateInformation<SearchNodeInfo>::const_iterator it =
+			search_node_infos.begin(g_state_registry);
+			it != search_node_infos.end(g_state_registry); ++it) {
+		ids.push_back(*it);
+	}
+	for (size_t i = 0; i < ids.size(); ++i) {
+		SearchNodeRecord record;
+		file.read(record);
+		if (record.parent_state_id < -1
+				|| record.parent_state_id >= int(ids.size())
+				|| record.creating_operator < -1
+				|| record.creating_operator >= int(g_operators.size())) {
+			cerr << "error: corrupt search node in checkpoint" << endl;
+			exit_with(EXIT_INPUT_ERROR);
+		}
+		SearchNodeInfo &info = search_node_infos[g_state_registry->lookup_state(ids[i])];
+		info.status = record.status;
+		info.g = record.g;
+		info.h = record.h;
+		info.h_is_dirty = record.h_is_dirty;
+		info.parent_state_id =
+				record.parent_state_id == -1 ?
+						StateID::no_state : ids[record.parent_state_id];
+		info.creating_operator =
+				record.creating_operator == -1 ?
+						0 : &g_operators[record.creating_operator];
+		info.real_g = record.real_g;
+	}
+}
+
 void SearchSpace::statistics() const {
 	cout << "Number of registered states: " << g_state_registry->size() << endl;
 }
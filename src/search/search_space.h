@@ -11,8 +11,11 @@
 
 #include <vector>
 
+class CheckpointFile;
+class ExternalClosedList;
 class Operator;
 class State;
+class StateRegistry;
 
 class SearchNode {
 	StateID state_id;
@@ -59,12 +62,83 @@ class SearchSpace {
 	PerStateInformation<SearchNodeInfo> search_node_infos;
 
 	OperatorCost cost_type;
+
+	/*
+	 External-memory closed list (see ExternalClosedList). States are
+	 identified by global IDs across spills: the states of the current
+	 registry are numbered from id_base on. Nodes that survived a spill
+	 have no parent_state_id; the global ID of their parent is kept in
+	 spilled_parent_ids instead. States registered before
+	 first_unchecked_index have been checked for spilled duplicates.
+	 */
+	ExternalClosedList *external_closed_list;
+	PerStateInformation<int> spilled_parent_ids;
+	int id_base;
+	size_t first_unchecked_index;
+
+	int get_global_parent_id(const State &state,
+			const SearchNodeInfo &info) const;
+	void trace_spilled_path(int global_id,
+			std::vector<const Operator *> &path) const;
+	void check_spilled_duplicates();
 public:
 	SearchSpace(OperatorCost cost_type_);
 	SearchNode get_node(const State &state);
 	void trace_path(const State &goal_state,
 			std::vector<const Operator *> &path) const;
 
+	void set_external_closed_list(ExternalClosedList *closed_list) {
+		external_closed_list = closed_list;
+	}
+
+	int get_global_id(StateID id) const {
+		return id_base + id.hash();
+	}
+	bool is_spilled(int global_id) const {
+		return global_id < id_base;
+	}
+	// Index of a state of the current registry given its global ID.
+	int get_registry_index(int global_id) const {
+		return global_id - id_base;
+	}
+
+	/*
+	 Writes all closed nodes to the external closed list and moves the
+	 given open states to a new g_state_registry. moved_states[i] is the
+	 new ID of open_states[i]. The old registry is returned so that the
+	 caller can move its own per-state information before deleting it.
+	 Distributed searches pass the (process, global ID) parents of their
+	 nodes in process_parents.
+	 */
+	StateRegistry *spill_closed_nodes(const std::vector<StateID> &open_states,
+			std::vector<StateID> &moved_states,
+			const PerStateInformation<std::pair<unsigned int, unsigned int> > *process_parents =
+					0);
+
+	/*
+	 Checks all states generated since the last check against the spilled
+	 closed states and closes the open nodes that have been spilled with a
+	 g value that is not worse. Only does so if the given node has not been
+	 checked yet. Returns true if the given node has been closed this way.
+	 */
+	bool is_spilled_duplicate(SearchNode &node);
+
+	/*
+	 Returns the creating operator (-1 for the initial state) and the
+	 parent of a spilled state.
+	 */
+	int get_spilled_parent(int global_id, int &parent_process,
+			int &parent_id) const;
+
+	/*
+	 Writes the search node infos of all states of g_state_registry to
+	 file and reads them back into a search space whose registry has been
+	 restored with StateRegistry::read_checkpoint. Checkpoints cannot be
+	 taken once closed nodes have been spilled.
+	 */
+	void write_checkpoint(CheckpointFile &file) const;
+	void read_checkpoint(CheckpointFile &file);
+
 	void dump() const;
 	void statistics() const;
 };
@@ -114,6 +114,12 @@ public:
         return the_size;
     }
 
+    // Bytes allocated for the stored entries (including unused capacity).
+    size_t get_memory_usage() const {
+        return segments.size() * SEGMENT_ELEMENTS * sizeof(Entry) +
+               segments.capacity() * sizeof(Entry *);
+    }
+
     void push_back(const Entry &entry) {
         size_t segment = get_segment(the_size);
         size_t offset = get_offset(the_size);
@@ -230,6 +236,12 @@ public:
         return the_size;
     }
 
+    // Bytes allocated for the stored arrays (including unused capacity).
+    size_t get_memory_usage() const {
+        return segments.size() * elements_per_segment * sizeof(Element) +
+               segments.capacity() * sizeof(Element *);
+    }
+
     void push_back(const Element *entry) {
         size_t segment = get_segment(the_size);
         size_t offset = get_offset(the_size);
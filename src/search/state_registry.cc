@@ -1,18 +1,82 @@
 #include "state_registry.h"
 
 #include "axioms.h"
+#include "checkpoint.h"
+#include "compiled_operators.h"
 #include "operator.h"
 #include "state_var_t.h"
 #include "per_state_information.h"
+#include "rng.h"
 
+#include <algorithm>
+#include <iostream>
 #include <stdio.h>
 using namespace std;
 
+vector<vector<size_t> > StateRegistry::hash_keys;
+
 StateRegistry::StateRegistry() :
 		state_data_pool(g_variable_domain.size()), registered_states(0,
-				StateIDSemanticHash(state_data_pool),
-				StateIDSemanticEqual(state_data_pool)), cached_initial_state(0), cached_dummy_state(
-				0) {
+				StateIDSemanticHash(state_hashes),
+				StateIDSemanticEqual(state_data_pool, state_hashes)), cached_initial_state(
+				0), cached_dummy_state(0) {
+	if (hash_keys.empty())
+		initialize_hash_keys();
+}
+
+void StateRegistry::initialize_hash_keys() {
+	// Do not use g_rng: the keys must not depend on the random seed.
+	RandomNumberGenerator rng(2014);
+	hash_keys.resize(g_variable_domain.size());
+	for (size_t var = 0; var < hash_keys.size(); ++var) {
+		hash_keys[var].resize(g_variable_domain[var], 0);
+		if (g_axiom_layers[var] != -1)
+			continue;
+		for (size_t val = 0; val < hash_keys[var].size(); ++val) {
+			unsigned long long key = rng.next32();
+			key = (key << 32) | rng.next32();
+			hash_keys[var][val] = size_t(key);
+		}
+	}
+}
+
+size_t StateRegistry::compute_hash(const state_var_t *buffer) {
+	size_t hash = 0;
+	for (size_t var = 0; var < hash_keys.size(); ++var)
+		hash ^= hash_keys[var][buffer[var]];
+	return hash;
+}
+
+size_t StateRegistry::get_state_hash(const State &state) const {
+	// The dummy states of HDA* and states of other registries have no
+	// stored hash.
+	if (state.registry != this || state.get_id().value < 0)
+		return compute_hash(state.get_buffer());
+	return state_hashes[state.get_id().value];
+}
+
+size_t StateRegistry::get_successor_hash(const State &predecessor,
+		const Operator &op) const {
+	size_t hash = get_state_hash(predecessor);
+	const vector<PrePost> &pre_post = op.get_pre_post();
+	for (size_t i = 0; i < pre_post.size(); ++i) {
+		int var = pre_post[i].var;
+		int value = predecessor[var];
+		if (!pre_post[i].does_fire(predecessor))
+			continue;
+		// As in get_successor_state, the last effect that fires on a
+		// variable determines its value.
+		bool overridden = false;
+		for (size_t j = i + 1; j < pre_post.size(); ++j) {
+			if (pre_post[j].var == var && pre_post[j].does_fire(predecessor)) {
+				overridden = true;
+				break;
+			}
+		}
+		if (!overridden && value != pre_post[i].post)
+			hash ^= hash_keys[var][value] ^ hash_keys[var][pre_post[i].post];
+	}
+	return hash;
 }
 
 StateRegistry::~StateRegistry() {
@@ -24,7 +88,7 @@ StateRegistry::~StateRegistry() {
 	delete cached_dummy_state;
 }
 
-StateID StateRegistry::insert_id_or_pop_state() {
+StateID StateRegistry::insert_id_or_pop_state(size_t hash) {
 	/*
 	 Attempt to insert a StateID for the last state of state_data_pool
 	 if none is present yet. If this fails (another entry for this state
@@ -32,10 +96,12 @@ StateID StateRegistry::insert_id_or_pop_state() {
 	 state data pool.
 	 */
 	StateID id(state_data_pool.size() - 1);
+	state_hashes.push_back(hash);
 	pair<StateIDSet::iterator, bool> result = registered_states.insert(id);
 	bool is_new_entry = result.second;
 	if (!is_new_entry) {
 		state_data_pool.pop_back();
+		state_hashes.pop_back();
 	}
 	assert(registered_states.size() == state_data_pool.size());
 	return *result.first;
@@ -63,7 +129,7 @@ const State &StateRegistry::get_initial_state() {
 		state_data_pool.push_back(g_initial_state_buffer);
 		state_var_t *vars = state_data_pool[state_data_pool.size() - 1];
 		g_axiom_evaluator->evaluate(vars);
-		StateID id = insert_id_or_pop_state();
+		StateID id = insert_id_or_pop_state(compute_hash(vars));
 		cached_initial_state = new State(lookup_state(id));
 	}
 	return *cached_initial_state;
@@ -74,12 +140,12 @@ const State &StateRegistry::get_initial_state() {
  * the state directly. Don't use it for sequential search.
  */
 State &StateRegistry::get_successor_state_by_dummy(const State& parent,
-		const Operator &op) {
+		const Operator &op, vector<int> *changed_vars) {
 	if (cached_dummy_state == 0) {
+		// The buffer is overwritten with the parent below. Do not rely on
+		// the initial state here: it is not registered in registries
+		// created by SearchSpace::spill_closed_nodes.
 		state_var_t *dummy_buffer = new state_var_t[g_variable_domain.size()];
-		copy(cached_initial_state->get_buffer(),
-				cached_initial_state->get_buffer() + g_variable_domain.size(),
-				dummy_buffer);
 
 		StateID id(-2);
 	    cached_dummy_state = new State(dummy_buffer, *this, id);
@@ -110,12 +176,15 @@ State &StateRegistry::get_successor_state_by_dummy(const State& parent,
 //	printf("\n");
 
 	// operate op to the dummy.
-	// TODO: this thing is causing a huge problem.
-	for (size_t i = 0; i < op.get_pre_post().size(); ++i) {
-		const PrePost &pre_post = op.get_pre_post()[i];
-		if (pre_post.does_fire(p_buff))
-			p_buff[pre_post.var] = pre_post.post;
-	}
+	int op_no = &op - &*g_operators.begin();
+	vector<int> &changed = changed_vars ? *changed_vars : changed_var_buffer;
+	changed.resize(g_variable_domain.size());
+	int num_changed = g_compiled_operators->apply(op_no, parent.get_buffer(),
+			p_buff, &changed[0]);
+	// HDA* sends the state with its derived variables, and build_state
+	// takes them as they are.
+	g_axiom_evaluator->evaluate(p_buff, &changed[0], num_changed);
+	changed.resize(num_changed);
 
 //	printf("child in methods: ");
 //	for (int i = 0; i < g_variable_domain.size(); ++i) {
@@ -141,6 +210,15 @@ void StateRegistry::reset_dummy_state() {
 			p_buff);
 }
 
+void StateRegistry::get_unregistered_states(const state_var_t *buffer,
+		int num_states, vector<State> &states) const {
+	int num_vars = g_variable_domain.size();
+	states.clear();
+	states.reserve(num_states);
+	for (int i = 0; i < num_states; ++i)
+		states.push_back(State(buffer + i * num_vars, *this, StateID(-2)));
+}
+
 //TODO it would be nice to move the actual state creation (and operator application)
 //     out of the StateRegistry. This could for example be done by global functions
 //     operating on state buffers (state_var_t *).
@@ -149,25 +227,99 @@ State StateRegistry::get_successor_state(const State &predecessor,
 	assert(!op.is_axiom());
 	state_data_pool.push_back(predecessor.get_buffer());
 	state_var_t *vars = state_data_pool[state_data_pool.size() - 1];
-	for (size_t i = 0; i < op.get_pre_post().size(); ++i) {
-		const PrePost &pre_post = op.get_pre_post()[i];
-		if (pre_post.does_fire(predecessor))
-			vars[pre_post.var] = pre_post.post;
-	}
-	g_axiom_evaluator->evaluate(vars);
-	StateID id = insert_id_or_pop_state();
+	size_t hash = apply_operator(predecessor, op, vars,
+			get_state_hash(predecessor));
+	StateID id = insert_id_or_pop_state(hash);
 	return lookup_state(id);
 }
 
+/*
+ Applies the effects of op to vars, which holds a copy of predecessor,
+ evaluates the axioms and returns the hash of the result given the hash of
+ predecessor. Derived variables do not contribute to the hash.
+ */
+size_t StateRegistry::apply_operator(const State &predecessor,
+		const Operator &op, state_var_t *vars, size_t hash) {
+	assert(!op.is_axiom());
+	changed_var_buffer.resize(g_variable_domain.size());
+	int num_changed = g_compiled_operators->apply(&op - &*g_operators.begin(),
+			predecessor.get_buffer(), vars, &changed_var_buffer[0]);
+	g_axiom_evaluator->evaluate(vars, &changed_var_buffer[0], num_changed);
+	return update_hash(hash, predecessor.get_buffer(), vars,
+			&changed_var_buffer[0], num_changed);
+}
+
+void StateRegistry::get_successor_states(const State &predecessor,
+		const vector<const Operator *> &ops, vector<State> &successors) {
+	size_t num_vars = g_variable_domain.size();
+	const state_var_t *parent = predecessor.get_buffer();
+	size_t parent_hash = get_state_hash(predecessor);
+	successor_buffer.resize(ops.size() * num_vars);
+	successor_hashes.resize(ops.size());
+	for (size_t i = 0; i < ops.size(); ++i) {
+		assert(!ops[i]->is_axiom());
+		state_var_t *vars = &successor_buffer[i * num_vars];
+		copy(parent, parent + num_vars, vars);
+		successor_hashes[i] = apply_operator(predecessor, *ops[i], vars,
+				parent_hash);
+	}
+
+	for (size_t i = 0; i < ops.size(); ++i) {
+		state_data_pool.push_back(&successor_buffer[i * num_vars]);
+		StateID id = insert_id_or_pop_state(successor_hashes[i]);
+		successors.push_back(lookup_state(id));
+	}
+}
+
 State StateRegistry::build_state(const state_var_t* state) {
 	state_data_pool.push_back(state);
 	state_var_t *vars = state_data_pool[state_data_pool.size() - 1];
-
-	g_axiom_evaluator->evaluate(vars);
-	StateID id = insert_id_or_pop_state();
+	StateID id = insert_id_or_pop_state(compute_hash(vars));
 	return lookup_state(id);
 }
 
+void StateRegistry::write_checkpoint(CheckpointFile &file) const {
+	size_t num_vars = g_variable_domain.size();
+	size_t num_states = state_data_pool.size();
+	file.write(num_states);
+	for (size_t i = 0; i < num_states; ++i)
+		file.write_bytes(state_data_pool[i], num_vars * sizeof(state_var_t));
+}
+
+void StateRegistry::read_checkpoint(CheckpointFile &file) {
+	size_t num_vars = g_variable_domain.size();
+	size_t num_states;
+	file.read(num_states);
+	vector<state_var_t> buffer(num_vars);
+	for (size_t i = 0; i < num_states; ++i) {
+		file.read_bytes(&buffer[0], num_vars * sizeof(state_var_t));
+		state_data_pool.push_back(&buffer[0]);
+		StateID id = insert_id_or_pop_state(compute_hash(&buffer[0]));
+		if (id.value != int(i)) {
+			cerr << "error: the checkpoint does not belong to this task" << endl;
+			exit_with(EXIT_INPUT_ERROR);
+		}
+	}
+}
+
+size_t StateRegistry::get_memory_usage() const {
+	// Every hash_set node holds the StateID and a pointer to the next node.
+	size_t hash_node_size = sizeof(StateID) + sizeof(void *);
+	return state_data_pool.get_memory_usage()
+			+ state_hashes.get_memory_usage()
+			+ registered_states.bucket_count() * sizeof(void *)
+			+ registered_states.size() * hash_node_size;
+}
+
+size_t StateRegistry::get_per_state_information_memory_usage() const {
+	size_t usage = 0;
+	for (set<PerStateInformationBase *>::const_iterator it =
+			subscribers.begin(); it != subscribers.end(); ++it) {
+		usage += (*it)->get_memory_usage(this);
+	}
+	return usage;
+}
+
 void StateRegistry::subscribe(PerStateInformationBase *psi) const {
 	subscribers.insert(psi);
 }
@@ -9,6 +9,7 @@
 #include "utilities.h"
 
 #include <set>
+#include <vector>
 #include <ext/hash_set>
 
 /*
@@ -94,29 +95,34 @@
  to store for each state and each landmark whether it was reached in this state.
  */
 
+class CheckpointFile;
 class PerStateInformationBase;
 
 class StateRegistry {
 	struct StateIDSemanticHash {
-		const SegmentedArrayVector<state_var_t> &state_data_pool;
-		StateIDSemanticHash(
-				const SegmentedArrayVector<state_var_t> &state_data_pool_) :
-				state_data_pool(state_data_pool_) {
+		const SegmentedVector<size_t> &state_hashes;
+		StateIDSemanticHash(const SegmentedVector<size_t> &state_hashes_) :
+				state_hashes(state_hashes_) {
 		}
 		size_t operator()(StateID id) const {
-			return ::hash_number_sequence(state_data_pool[id.value],
-					g_variable_domain.size());
+			return state_hashes[id.value];
 		}
 	};
 
 	struct StateIDSemanticEqual {
 		const SegmentedArrayVector<state_var_t> &state_data_pool;
+		const SegmentedVector<size_t> &state_hashes;
 		StateIDSemanticEqual(
-				const SegmentedArrayVector<state_var_t> &state_data_pool_) :
-				state_data_pool(state_data_pool_) {
+				const SegmentedArrayVector<state_var_t> &state_data_pool_,
+				const SegmentedVector<size_t> &state_hashes_) :
+				state_data_pool(state_data_pool_), state_hashes(state_hashes_) {
 		}
 
 		size_t operator()(StateID lhs, StateID rhs) const {
+			// Different hashes rule out most unequal states without
+			// touching the state data.
+			if (state_hashes[lhs.value] != state_hashes[rhs.value])
+				return false;
 			size_t size = g_variable_domain.size();
 			const state_var_t *lhs_data = state_data_pool[lhs.value];
 			const state_var_t *rhs_data = state_data_pool[rhs.value];
@@ -132,11 +138,30 @@ class StateRegistry {
 	typedef __gnu_cxx ::hash_set<StateID, StateIDSemanticHash,
 			StateIDSemanticEqual> StateIDSet;
 
+	/*
+	 Zobrist keys for every fact, shared by all registries and identical
+	 in all processes (fixed seed). The keys of derived variables are 0:
+	 their values follow from the other variables, so leaving them out
+	 keeps the hash a function of the state while allowing to compute the
+	 hash of a successor from the operator effects alone.
+	 */
+	static std::vector<std::vector<size_t> > hash_keys;
+	static void initialize_hash_keys();
+
 	SegmentedArrayVector<state_var_t> state_data_pool;
+	// Hash of every state in state_data_pool, computed when it is added.
+	SegmentedVector<size_t> state_hashes;
 	StateIDSet registered_states;
 	State *cached_initial_state;
 	mutable std::set<PerStateInformationBase *> subscribers;
-	StateID insert_id_or_pop_state();
+	StateID insert_id_or_pop_state(size_t hash);
+	size_t apply_operator(const State &predecessor, const Operator &op,
+			state_var_t *vars, size_t hash);
+
+	// Scratch space of get_successor_states and apply_operator.
+	std::vector<state_var_t> successor_buffer;
+	std::vector<size_t> successor_hashes;
+	std::vector<int> changed_var_buffer;
 
 	State *cached_dummy_state;
 public:
@@ -155,9 +180,25 @@ public:
 	 */
 	const State &get_initial_state();
 
-	State &get_successor_state_by_dummy(const State& parent, const Operator &op);
+	/*
+	 Applies op to a copy of parent in a buffer owned by the registry, without
+	 registering the result, and evaluates the axioms on it. The state stays
+	 valid until the next call. If changed_vars is given, it is set to the
+	 variables changed by op (see CompiledOperators::apply), which do not
+	 include derived variables.
+	 */
+	State &get_successor_state_by_dummy(const State& parent, const Operator &op,
+			std::vector<int> *changed_vars = 0);
 	void reset_dummy_state();
 
+	/*
+	 Wraps num_states consecutive blocks of g_variable_domain.size() values
+	 in buffer in states that are not registered, like the dummy state. The
+	 states are only valid as long as buffer is not changed.
+	 */
+	void get_unregistered_states(const state_var_t *buffer, int num_states,
+			std::vector<State> &states) const;
+
 	/*
 	 Returns the state that results from applying op to predecessor and
 	 registers it if this was not done before. This is an expensive operation
@@ -165,15 +206,62 @@ public:
 	 */
 	State get_successor_state(const State &predecessor, const Operator &op);
 
+	/*
+	 Same as calling get_successor_state for every operator in ops (in this
+	 order, so the states get the same IDs), appending the results to
+	 successors. All children are built in one contiguous buffer before
+	 any of them is looked up.
+	 */
+	void get_successor_states(const State &predecessor,
+			const std::vector<const Operator *> &ops,
+			std::vector<State> &successors);
+
 //	state_var_t* get_successor_state_without_registering(
 //			const State &predecessor, const Operator &op);
 //	void apply_operation(State &predecessor, state_var_t* vars, const Operator &op);
 	/*
 	 method for HDA*. TODO: this implementation is not efficient.
 	 This method is called when process RECEIVED a node from other processes.
+	 The given state must be complete: its derived variables are taken as
+	 they are, as computed by the process that generated it.
 	 */
 	State build_state(const state_var_t* state);
 
+	/*
+	 Returns the hash of the given state, which is stored with the state
+	 when it is registered, so this is cheap. Equal states have equal
+	 hashes in all registries and all processes.
+	 */
+	size_t get_state_hash(const State &state) const;
+
+	/*
+	 Returns the hash of the state that results from applying op to
+	 predecessor without creating that state. Only the variables changed
+	 by op are visited.
+	 */
+	size_t get_successor_hash(const State &predecessor,
+			const Operator &op) const;
+
+	/*
+	 Computes the hash of the given state data from scratch.
+	 */
+	static size_t compute_hash(const state_var_t *buffer);
+
+	/*
+	 Turns the hash of predecessor into the hash of successor, which differs
+	 from it at most in the given variables.
+	 */
+	static size_t update_hash(size_t hash, const state_var_t *predecessor,
+			const state_var_t *successor, const int *changed_vars,
+			int num_changed) {
+		for (int i = 0; i < num_changed; ++i) {
+			int var = changed_vars[i];
+			hash ^= hash_keys[var][predecessor[var]]
+					^ hash_keys[var][successor[var]];
+		}
+		return hash;
+	}
+
 	/*
 	 Returns the number of states registered so far.
 	 */
@@ -181,6 +269,27 @@ public:
 		return registered_states.size();
 	}
 
+	/*
+	 Writes the data of all registered states to file, or registers the
+	 states written this way in the same order, so that they get the same
+	 IDs again. States that are already registered when reading must be
+	 the first states of the file (usually only the initial state).
+	 */
+	void write_checkpoint(CheckpointFile &file) const;
+	void read_checkpoint(CheckpointFile &file);
+
+	/*
+	 Returns the number of bytes used for the state data and the hash table
+	 that detects duplicates.
+	 */
+	size_t get_memory_usage() const;
+
+	/*
+	 Returns the number of bytes used by all PerStateInformation objects
+	 for states of this registry.
+	 */
+	size_t get_per_state_information_memory_usage() const;
+
 	/*
 	 Remembers the given PerStateInformation. If this StateRegistry is
 	 destroyed, it notifies all subscribed PerStateInformation objects.
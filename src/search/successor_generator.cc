@@ -1,112 +1,240 @@
+#include "binary_task_file.h"
 #include "globals.h"
 #include "operator.h"
 #include "state.h"
 #include "successor_generator.h"
 #include "utilities.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 using namespace std;
 
-class SuccessorGeneratorSwitch: public SuccessorGenerator {
-	int switch_var;
-	SuccessorGenerator *immediate_ops;
-	vector<SuccessorGenerator *> generator_for_value;
-	SuccessorGenerator *default_generator;
-public:
-	SuccessorGeneratorSwitch(istream &in);
-	virtual void generate_applicable_ops(const State &curr,
-			vector<const Operator *> &ops);
-	virtual void get_op_depths(int depth, vector<pair<int, const Operator *> > &ops);
-
-	virtual void _dump(string indent);
-};
-
-class SuccessorGeneratorGenerate: public SuccessorGenerator {
-	vector<const Operator *> op;
-public:
-	SuccessorGeneratorGenerate(istream &in);
-	virtual void generate_applicable_ops(const State &curr,
-			vector<const Operator *> &ops);
-	virtual void get_op_depths(int depth, vector<pair<int, const Operator *> > &ops);
-	virtual void _dump(string indent);
-};
-
-SuccessorGeneratorSwitch::SuccessorGeneratorSwitch(istream &in) {
-	in >> switch_var;
-	immediate_ops = read_successor_generator(in);
-	for (int i = 0; i < g_variable_domain[switch_var]; i++)
-		generator_for_value.push_back(read_successor_generator(in));
-	default_generator = read_successor_generator(in);
+SuccessorGenerator::SuccessorGenerator(istream &in) {
+	root = read_node(in);
+	if (root != NONE)
+		link_node(root, NONE);
+	max_applicable_ops = root == NONE ? 0 : compute_max_applicable_ops(root);
 }
 
-void SuccessorGeneratorSwitch::generate_applicable_ops(const State &curr,
-		vector<const Operator *> &ops) {
-	immediate_ops->generate_applicable_ops(curr, ops);
-	generator_for_value[curr[switch_var]]->generate_applicable_ops(curr, ops);
-	default_generator->generate_applicable_ops(curr, ops);
-}
-
-void SuccessorGeneratorSwitch::get_op_depths(int depth, vector<pair<int, const Operator *> > &ops) {
-//	cout << depth << ": " << g_variable_name[switch_var] << endl;
-	immediate_ops->get_op_depths(depth, ops);
-	for (int i = 0; i < g_variable_domain[switch_var]; i++) {
-		generator_for_value[i]->get_op_depths(depth + 1, ops);
+SuccessorGenerator::SuccessorGenerator(BinaryTaskFile &in) {
+	int num_nodes = in.read_int();
+	const int *node_data = in.read_ints(5 * num_nodes);
+	nodes.resize(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		Node &node = nodes[i];
+		const int *data = node_data + 5 * i;
+		node.var = data[0];
+		node.ops_begin = data[1];
+		node.ops_end = data[2];
+		node.children_begin = data[3];
+		node.default_child = data[4];
+		node.next = NONE;
+		node.after_value = NONE;
 	}
-	default_generator->get_op_depths(depth, ops);
-}
+	int num_children = in.read_int();
+	const int *children_data = in.read_ints(num_children);
+	children.assign(children_data, children_data + num_children);
+	int num_op_indices = in.read_int();
+	const int *op_data = in.read_ints(num_op_indices);
+	op_indices.assign(op_data, op_data + num_op_indices);
+	root = in.read_int();
 
-void SuccessorGeneratorSwitch::_dump(string indent) {
-	cout << indent << "switch on " << g_variable_name[switch_var] << endl;
-	cout << indent << "immediately:" << endl;
-	immediate_ops->_dump(indent + "  ");
-	for (int i = 0; i < g_variable_domain[switch_var]; i++) {
-		cout << indent << "case " << i << ":" << endl;
-		generator_for_value[i]->_dump(indent + "  ");
-	}
-	cout << indent << "always:" << endl;
-	default_generator->_dump(indent + "  ");
+	if (root != NONE)
+		link_node(root, NONE);
+	max_applicable_ops = root == NONE ? 0 : compute_max_applicable_ops(root);
 }
 
-void SuccessorGeneratorGenerate::generate_applicable_ops(const State &,
-		vector<const Operator *> &ops) {
-	ops.insert(ops.end(), op.begin(), op.end());
+static void illegal_statement(const string &expected, const string &type)
+		__attribute__((noreturn));
+
+static void illegal_statement(const string &expected, const string &type) {
+	cout << "Illegal successor generator statement!" << endl;
+	cout << "Expected " << expected << ", got '" << type << "'." << endl;
+	exit_with(EXIT_INPUT_ERROR);
 }
 
-SuccessorGeneratorGenerate::SuccessorGeneratorGenerate(istream &in) {
+void SuccessorGenerator::read_operators(istream &in, int &begin, int &end) {
 	int count;
 	in >> count;
+	begin = op_indices.size();
 	for (int i = 0; i < count; i++) {
 		int op_index;
 		in >> op_index;
-		op.push_back(&g_operators[op_index]);
+		op_indices.push_back(op_index);
 	}
+	end = op_indices.size();
 }
 
-void SuccessorGeneratorGenerate::get_op_depths(int depth, vector<pair<int, const Operator *> > &ops) {
-	for (int i = 0; i < op.size(); i++) {
-//		op[i]->dump();
-		ops.push_back(pair<int, const Operator *>(depth, op[i]));
+int SuccessorGenerator::read_node(istream &in) {
+	// Returns NONE for subtrees without operators.
+	string type;
+	in >> type;
+	Node node;
+	node.next = NONE;
+	node.after_value = NONE;
+	if (type == "check") {
+		node.var = NONE;
+		node.children_begin = NONE;
+		node.default_child = NONE;
+		read_operators(in, node.ops_begin, node.ops_end);
+		if (node.ops_begin == node.ops_end)
+			return NONE;
+	} else if (type == "switch") {
+		in >> node.var;
+		// The preprocessor always writes the immediate operators as a
+		// single check statement.
+		string immediate_type;
+		in >> immediate_type;
+		if (immediate_type != "check")
+			illegal_statement("'check'", immediate_type);
+		read_operators(in, node.ops_begin, node.ops_end);
+		// The subtrees append their own children, so we collect ours
+		// first to keep them contiguous.
+		vector<int> value_children;
+		bool has_children = false;
+		for (int i = 0; i < g_variable_domain[node.var]; i++) {
+			value_children.push_back(read_node(in));
+			if (value_children.back() != NONE)
+				has_children = true;
+		}
+		node.default_child = read_node(in);
+		if (!has_children && node.default_child == NONE) {
+			if (node.ops_begin == node.ops_end)
+				return NONE;
+			// Only immediate operators are left, which makes this a leaf.
+			node.var = NONE;
+			node.children_begin = NONE;
+		} else {
+			node.children_begin = children.size();
+			children.insert(children.end(), value_children.begin(),
+					value_children.end());
+		}
+	} else {
+		illegal_statement("'switch' or 'check'", type);
 	}
+	nodes.push_back(node);
+	return nodes.size() - 1;
 }
 
-void SuccessorGeneratorGenerate::_dump(string indent) {
-	for (int i = 0; i < op.size(); i++) {
-		cout << indent;
-		op[i]->dump();
+void SuccessorGenerator::link_node(int node, int next) {
+	Node &n = nodes[node];
+	n.next = next;
+	if (n.var == NONE)
+		return;
+	n.after_value = n.default_child != NONE ? n.default_child : next;
+	for (int i = 0; i < g_variable_domain[n.var]; i++) {
+		int child = children[n.children_begin + i];
+		if (child != NONE)
+			link_node(child, n.after_value);
 	}
+	if (n.default_child != NONE)
+		link_node(n.default_child, next);
 }
 
-SuccessorGenerator *read_successor_generator(istream &in) {
-	string type;
-	in >> type;
-	if (type == "switch") {
-		return new SuccessorGeneratorSwitch(in);
-	} else if (type == "check") {
-		return new SuccessorGeneratorGenerate(in);
+size_t SuccessorGenerator::compute_max_applicable_ops(int node) const {
+	const Node &n = nodes[node];
+	size_t result = n.ops_end - n.ops_begin;
+	if (n.var == NONE)
+		return result;
+	size_t max_for_value = 0;
+	for (int i = 0; i < g_variable_domain[n.var]; i++) {
+		int child = children[n.children_begin + i];
+		if (child != NONE)
+			max_for_value = max(max_for_value,
+					compute_max_applicable_ops(child));
 	}
-	cout << "Illegal successor generator statement!" << endl;
-	cout << "Expected 'switch' or 'check', got '" << type << "'." << endl;
-	exit_with(EXIT_INPUT_ERROR);
+	result += max_for_value;
+	if (n.default_child != NONE)
+		result += compute_max_applicable_ops(n.default_child);
+	return result;
+}
+
+void SuccessorGenerator::generate_applicable_ops(const State &curr,
+		vector<const Operator *> &ops) const {
+	const Operator *operators = g_operators.data();
+	int node = root;
+	while (node != NONE) {
+		const Node &n = nodes[node];
+		for (int i = n.ops_begin; i < n.ops_end; ++i)
+			ops.push_back(operators + op_indices[i]);
+		if (n.var == NONE) {
+			node = n.next;
+		} else {
+			int child = children[n.children_begin + curr[n.var]];
+			node = child != NONE ? child : n.after_value;
+		}
+	}
+}
+
+int SuccessorGenerator::generate_applicable_op_indices(const State &curr,
+		int *applicable) const {
+	int count = 0;
+	int node = root;
+	while (node != NONE) {
+		const Node &n = nodes[node];
+		for (int i = n.ops_begin; i < n.ops_end; ++i)
+			applicable[count++] = op_indices[i];
+		if (n.var == NONE) {
+			node = n.next;
+		} else {
+			int child = children[n.children_begin + curr[n.var]];
+			node = child != NONE ? child : n.after_value;
+		}
+	}
+	return count;
+}
+
+void SuccessorGenerator::get_op_depths(int depth,
+		vector<pair<int, const Operator *> > &ops) const {
+	if (root != NONE)
+		get_op_depths(root, depth, ops);
+}
+
+void SuccessorGenerator::get_op_depths(int node, int depth,
+		vector<pair<int, const Operator *> > &ops) const {
+	const Node &n = nodes[node];
+//	if (n.var != NONE)
+//		cout << depth << ": " << g_variable_name[n.var] << endl;
+	for (int i = n.ops_begin; i < n.ops_end; ++i)
+		ops.push_back(
+				pair<int, const Operator *>(depth, &g_operators[op_indices[i]]));
+	if (n.var == NONE)
+		return;
+	for (int i = 0; i < g_variable_domain[n.var]; i++) {
+		int child = children[n.children_begin + i];
+		if (child != NONE)
+			get_op_depths(child, depth + 1, ops);
+	}
+	if (n.default_child != NONE)
+		get_op_depths(n.default_child, depth, ops);
+}
+
+void SuccessorGenerator::dump(int node, const string &indent) const {
+	if (node == NONE)
+		return;
+	const Node &n = nodes[node];
+	string op_indent = indent;
+	if (n.var != NONE) {
+		cout << indent << "switch on " << g_variable_name[n.var] << endl;
+		cout << indent << "immediately:" << endl;
+		op_indent += "  ";
+	}
+	for (int i = n.ops_begin; i < n.ops_end; ++i) {
+		cout << op_indent;
+		g_operators[op_indices[i]].dump();
+	}
+	if (n.var == NONE)
+		return;
+	for (int i = 0; i < g_variable_domain[n.var]; i++) {
+		cout << indent << "case " << i << ":" << endl;
+		dump(children[n.children_begin + i], indent + "  ");
+	}
+	cout << indent << "always:" << endl;
+	dump(n.default_child, indent + "  ");
+}
+
+SuccessorGenerator *read_successor_generator(istream &in) {
+	return new SuccessorGenerator(in);
 }
@@ -2,19 +2,82 @@
 #define SUCCESSOR_GENERATOR_H
 
 #include <iostream>
+#include <string>
 #include <vector>
 
+class BinaryTaskFile;
 class Operator;
 class State;
 
+/*
+  The successor generator is a decision tree over the variables that the
+  preprocessor writes to the output file. Every switch node tests one
+  variable and has three kinds of children: the operators that are
+  applicable regardless of the value ("immediately"), one subtree per
+  value, and a subtree for the operators that do not depend on the
+  variable ("always").
+
+  When it is read, the tree is compiled into a flat array of nodes.
+  Operators of a node are a range in one array of operator indices,
+  and children are indices into the node array. Every node also stores
+  the node where the walk continues once its subtree is done. Because the
+  tree has no shared subtrees, this successor does not depend on the
+  state, so the walk needs no stack and no virtual calls. Operators are
+  generated in the same order as by a recursive walk of the tree.
+  Binary task files contain the flat arrays, so the preprocessor compiles
+  the tree in the same way.
+*/
 class SuccessorGenerator {
+    static const int NONE = -1;
+
+    struct Node {
+        // Variable tested by a switch node, NONE for leaves.
+        int var;
+        // Operators of a leaf, or the immediate operators of a switch.
+        int ops_begin;
+        int ops_end;
+        // Index into children of the subtree for value 0 of var.
+        int children_begin;
+        // Where to continue after the subtree of this node (NONE: done).
+        int next;
+        // Where to continue after the subtree for the value of var, i.e.
+        // the "always" subtree or next if that is empty.
+        int after_value;
+        // Subtree for operators that do not depend on var.
+        int default_child;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> children;
+    std::vector<int> op_indices;
+    int root;
+    size_t max_applicable_ops;
+
+    int read_node(std::istream &in);
+    void read_operators(std::istream &in, int &begin, int &end);
+    void link_node(int node, int next);
+    size_t compute_max_applicable_ops(int node) const;
+    void get_op_depths(int node, int depth,
+                       std::vector<std::pair<int, const Operator *> > &ops) const;
+    void dump(int node, const std::string &indent) const;
 public:
-    virtual ~SuccessorGenerator() {}
-    virtual void generate_applicable_ops(const State &curr,
-                                         std::vector<const Operator *> &ops) = 0;
-	virtual void get_op_depths(int depth, std::vector<std::pair<int, const Operator *> > &ops) = 0;
-    void dump() {_dump("  "); }
-    virtual void _dump(std::string indent) = 0;
+    explicit SuccessorGenerator(std::istream &in);
+    explicit SuccessorGenerator(BinaryTaskFile &in);
+
+    void generate_applicable_ops(const State &curr,
+                                 std::vector<const Operator *> &ops) const;
+    /*
+      Writes the indices (into g_operators) of the operators applicable in
+      curr to applicable, which must have room for get_max_applicable_ops()
+      entries, and returns their number.
+    */
+    int generate_applicable_op_indices(const State &curr,
+                                       int *applicable) const;
+    // Upper bound on the number of operators applicable in a state.
+    size_t get_max_applicable_ops() const {return max_applicable_ops; }
+
+	void get_op_depths(int depth, std::vector<std::pair<int, const Operator *> > &ops) const;
+    void dump() const {dump(root, "  "); }
 };
 
 SuccessorGenerator *read_successor_generator(std::istream &in);
@@ -0,0 +1,188 @@
+#include "task_loading.h"
+
+#include "binary_task_file.h"
+#include "globals.h"
+#include "node_shared_memory.h"
+#include "utilities.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mpi.h>
+#include <streambuf>
+#include <vector>
+using namespace std;
+
+// MPI_Bcast counts are ints, so large tasks are sent in pieces.
+static const long long BROADCAST_CHUNK_SIZE = 1 << 30;
+
+TaskLoading parse_task_loading(int argc, const char **argv) {
+    for (int i = 1; i < argc - 1; ++i) {
+        if (string(argv[i]) != "--task-loading")
+            continue;
+        string mode = argv[i + 1];
+        if (mode == "file")
+            return LOAD_FROM_FILE;
+        else if (mode == "broadcast")
+            return LOAD_BY_BROADCAST;
+        else if (mode == "shared")
+            return LOAD_BY_SHARED_BROADCAST;
+        cerr << "unknown task loading mode " << mode
+             << " (expected file, broadcast or shared)" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    return LOAD_FROM_FILE;
+}
+
+static void read_task_from_file(const string &filename) {
+    ifstream in(filename.c_str(), ifstream::in);
+    if (!in) {
+        cout << "output file not in place" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    if (BinaryTaskFile::is_binary_task_file(filename)) {
+        BinaryTaskFile task_file(filename);
+        read_everything(task_file);
+    } else {
+        read_everything(in);
+    }
+}
+
+/*
+  Reads text tasks in place from the received contents, which may be the
+  node's shared memory segment, so that no process needs a private copy.
+  The text parser only puts back characters it has read, so the bytes
+  are never written.
+*/
+class MemoryStreamBuffer : public streambuf {
+public:
+    MemoryStreamBuffer(const char *data, size_t size) {
+        char *begin = const_cast<char *>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+static void read_task_from_memory(const string &filename, const char *data,
+                                  size_t size) {
+    if (BinaryTaskFile::is_binary_task_file(data, size)) {
+        BinaryTaskFile task_file(filename, data, size);
+        read_everything(task_file);
+    } else {
+        MemoryStreamBuffer buffer(data, size);
+        istream in(&buffer);
+        read_everything(in);
+    }
+}
+
+// Returns the size of the file, or -1 if it cannot be read.
+static long long read_file_contents(const string &filename,
+                                    vector<char> &contents) {
+    ifstream in(filename.c_str(), ios::in | ios::binary);
+    if (!in)
+        return -1;
+    in.seekg(0, ios::end);
+    long long size = in.tellg();
+    in.seekg(0, ios::beg);
+    contents.resize(size);
+    if (size > 0 && !in.read(&contents[0], size))
+        return -1;
+    return size;
+}
+
+static void broadcast_bytes(char *data, long long size, MPI_Comm comm) {
+    for (long long offset = 0; offset < size; offset += BROADCAST_CHUNK_SIZE) {
+        int count = min(BROADCAST_CHUNK_SIZE, size - offset);
+        MPI_Bcast(data + offset, count, MPI_CHAR, 0, comm);
+    }
+}
+
+/*
+  Rank 0 reads the file and broadcasts its size to all ranks. All ranks
+  leave if it cannot be read, so none of them waits for the contents.
+*/
+static long long broadcast_file_size(const string &filename,
+                                     vector<char> &contents) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    long long size = 0;
+    if (rank == 0)
+        size = read_file_contents(filename, contents);
+    MPI_Bcast(&size, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    if (size < 0) {
+        if (rank == 0)
+            cout << "output file not in place" << endl;
+        exit_with(EXIT_INPUT_ERROR);
+    }
+    if (rank == 0)
+        cout << "Broadcasting task file (" << size << " bytes)" << endl;
+    return size;
+}
+
+static void load_task_by_broadcast(const string &filename) {
+    vector<char> contents;
+    long long size = broadcast_file_size(filename, contents);
+    contents.resize(size);
+    if (size > 0) {
+        broadcast_bytes(&contents[0], size, MPI_COMM_WORLD);
+        read_task_from_memory(filename, &contents[0], size);
+    } else {
+        read_task_from_memory(filename, "", 0);
+    }
+}
+
+static void load_task_by_shared_broadcast(const string &filename) {
+    vector<char> contents;
+    long long size = broadcast_file_size(filename, contents);
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // Rank 0 of the world has rank 0 in its node, so it is a leader.
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                        MPI_INFO_NULL, &node_comm);
+    int node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm leader_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+                   &leader_comm);
+
+    // Only the leader allocates memory. The others map its segment.
+    char *segment;
+    MPI_Win window;
+    MPI_Win_allocate_shared(node_rank == 0 ? size : 0, 1, MPI_INFO_NULL,
+                            node_comm, &segment, &window);
+    MPI_Aint segment_size;
+    int displacement_unit;
+    MPI_Win_shared_query(window, 0, &segment_size, &displacement_unit,
+                         &segment);
+
+    MPI_Win_fence(0, window);
+    if (node_rank == 0) {
+        if (rank == 0 && size > 0)
+            memcpy(segment, &contents[0], size);
+        broadcast_bytes(segment, size, leader_comm);
+    }
+    MPI_Win_fence(0, window);
+    vector<char>().swap(contents);
+
+    read_task_from_memory(filename, size > 0 ? segment : "", size);
+
+    MPI_Win_free(&window);
+    if (leader_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&leader_comm);
+    MPI_Comm_free(&node_comm);
+}
+
+void load_task(const string &filename, TaskLoading loading) {
+    if (loading == LOAD_FROM_FILE) {
+        read_task_from_file(filename);
+        return;
+    }
+    initialize_mpi();
+    if (loading == LOAD_BY_BROADCAST)
+        load_task_by_broadcast(filename);
+    else
+        load_task_by_shared_broadcast(filename);
+}
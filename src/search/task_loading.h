@@ -0,0 +1,29 @@
+#ifndef TASK_LOADING_H
+#define TASK_LOADING_H
+
+#include <string>
+
+/*
+  How the planner gets the preprocessed task (--task-loading):
+    file: every process reads the task file itself.
+    broadcast: MPI rank 0 reads the file and broadcasts its contents to
+      all other ranks, so the file system sees one reader instead of one
+      per rank.
+    shared: like broadcast, but the contents only go to one rank per
+      node, which places them in a node-local MPI shared memory segment
+      that all ranks of the node read from.
+  Every process then builds the globals from the received copy. Text and
+  binary task files are supported in all modes.
+*/
+enum TaskLoading {
+    LOAD_FROM_FILE,
+    LOAD_BY_BROADCAST,
+    LOAD_BY_SHARED_BROADCAST
+};
+
+// Finds the --task-loading option on the command line.
+TaskLoading parse_task_loading(int argc, const char **argv);
+
+void load_task(const std::string &filename, TaskLoading loading);
+
+#endif
@@ -107,6 +107,27 @@ void signal_handler(int signal_number) {
     raise(signal_number);
 }
 
+#if OPERATING_SYSTEM != OSX
+static int read_proc_status_in_kb(const string &field) {
+    // Returns -1 if the field cannot be read.
+    int memory_in_kb = -1;
+    ifstream procfile("/proc/self/status");
+    string word;
+    while (procfile.good()) {
+        procfile >> word;
+        if (word == field) {
+            procfile >> memory_in_kb;
+            break;
+        }
+        // Skip to end of line.
+        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    if (procfile.fail())
+        memory_in_kb = -1;
+    return memory_in_kb;
+}
+#endif
+
 int get_peak_memory_in_kb() {
     // On error, produces a warning on cerr and returns -1.
     int memory_in_kb = -1;
@@ -121,19 +142,7 @@ int get_peak_memory_in_kb() {
                   &t_info_count) == KERN_SUCCESS)
         memory_in_kb = t_info.virtual_size / 1024;
 #else
-    ifstream procfile("/proc/self/status");
-    string word;
-    while (procfile.good()) {
-        procfile >> word;
-        if (word == "VmPeak:") {
-            procfile >> memory_in_kb;
-            break;
-        }
-        // Skip to end of line.
-        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
-    if (procfile.fail())
-        memory_in_kb = -1;
+    memory_in_kb = read_proc_status_in_kb("VmPeak:");
 #endif
 
     if (memory_in_kb == -1)
@@ -141,6 +150,27 @@ int get_peak_memory_in_kb() {
     return memory_in_kb;
 }
 
+int get_current_memory_in_kb() {
+    // Resident set size. On error, produces a warning on cerr and returns -1.
+    int memory_in_kb = -1;
+
+#if OPERATING_SYSTEM == OSX
+    task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&t_info),
+                  &t_info_count) == KERN_SUCCESS)
+        memory_in_kb = t_info.resident_size / 1024;
+#else
+    memory_in_kb = read_proc_status_in_kb("VmRSS:");
+#endif
+
+    if (memory_in_kb == -1)
+        cerr << "warning: could not determine current memory" << endl;
+    return memory_in_kb;
+}
+
 void print_peak_memory() {
     cout << "Peak memory: " << get_peak_memory_in_kb() << " KB" << endl;
 }
@@ -47,6 +47,7 @@ extern void exit_with(ExitCode returncode) __attribute__((noreturn));
 extern void register_event_handlers();
 
 extern int get_peak_memory_in_kb();
+extern int get_current_memory_in_kb();
 extern void print_peak_memory();
 extern void assert_sorted_unique(const std::vector<int> &values);
 